@@ -0,0 +1,132 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace WingsOfSteel::Bench
+{
+
+static std::atomic<uint64_t> sAllocations{ 0 };
+static std::atomic<uint64_t> sAllocatedBytes{ 0 };
+
+static void* Allocate(std::size_t size)
+{
+    sAllocations.fetch_add(1, std::memory_order_relaxed);
+    sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    sAllocations.fetch_add(1, std::memory_order_relaxed);
+    sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(TARGET_PLATFORM_WINDOWS)
+    return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+    // aligned_alloc() requires the size to be a multiple of the alignment.
+    return std::aligned_alloc(align, size > 0 ? (size + align - 1) / align * align : align);
+#endif
+}
+
+static void FreeAligned(void* pMemory)
+{
+#if defined(TARGET_PLATFORM_WINDOWS)
+    _aligned_free(pMemory);
+#else
+    std::free(pMemory);
+#endif
+}
+
+AllocationCounter::Counts AllocationCounter::Get()
+{
+    return Counts{
+        .allocations = sAllocations.load(std::memory_order_relaxed),
+        .bytes = sAllocatedBytes.load(std::memory_order_relaxed)
+    };
+}
+
+} // namespace WingsOfSteel::Bench
+
+using namespace WingsOfSteel::Bench;
+
+void* operator new(std::size_t size)
+{
+    void* pMemory = Allocate(size);
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pMemory = AllocateAligned(size, alignment);
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+    FreeAligned(pMemory);
+}
+
+void operator delete[](void* pMemory, std::align_val_t) noexcept
+{
+    FreeAligned(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(pMemory);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace WingsOfSteel::Bench
+{
+
+// Counts every allocation made through operator new, on any thread, by replacing the global allocation functions.
+// Allocations made directly with malloc() (for example by Bullet or Dawn) aren't counted.
+namespace AllocationCounter
+{
+
+struct Counts
+{
+    uint64_t allocations{ 0 };
+    uint64_t bytes{ 0 };
+};
+
+Counts Get();
+
+} // namespace AllocationCounter
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,113 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "allocation_counter.hpp"
+#include "core/log.hpp"
+#include "core/profiler.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+Benchmark::Benchmark(const std::string& scenario, const BenchmarkSettings& settings, Json::Data& results)
+    : m_Scenario(scenario)
+    , m_Settings(settings)
+    , m_Results(results)
+{
+}
+
+size_t Benchmark::Scale(size_t count) const
+{
+    return std::max<size_t>(1, static_cast<size_t>(std::llround(static_cast<double>(count) * m_Settings.scale)));
+}
+
+static double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+    const size_t index = static_cast<size_t>(std::ceil(percentile * sortedValues.size()));
+    return sortedValues[std::clamp<size_t>(index, 1, sortedValues.size()) - 1];
+}
+
+void Benchmark::Run(const std::string& caseName, const Json::Data& parameters, uint64_t itemsPerFrame, const FrameFunction& frame, const FrameFunction& setup /* = nullptr */)
+{
+    Log::Info() << "Running " << m_Scenario << " / " << caseName << "...";
+
+    const uint32_t frames = std::max<uint32_t>(1, m_Settings.frames);
+    std::vector<double> durations;
+    durations.reserve(frames);
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+
+    for (uint32_t i = 0; i < m_Settings.warmupFrames + frames; i++)
+    {
+        if (setup)
+        {
+            setup();
+        }
+
+        const AllocationCounter::Counts countsBefore = AllocationCounter::Get();
+        const uint64_t start = Profiler::GetTime();
+        frame();
+        const uint64_t end = Profiler::GetTime();
+        const AllocationCounter::Counts countsAfter = AllocationCounter::Get();
+
+        if (i >= m_Settings.warmupFrames)
+        {
+            durations.push_back(static_cast<double>(end - start) / 1.0e6);
+            allocations += countsAfter.allocations - countsBefore.allocations;
+            allocatedBytes += countsAfter.bytes - countsBefore.bytes;
+        }
+    }
+
+    const double mean = std::accumulate(durations.begin(), durations.end(), 0.0) / durations.size();
+    std::sort(durations.begin(), durations.end());
+    const double median = GetPercentile(durations, 0.5);
+
+    Json::Data result = {
+        { "scenario", m_Scenario },
+        { "case", caseName },
+        { "parameters", parameters },
+        { "frames", frames },
+        { "ms_per_frame", {
+            { "median", median },
+            { "p95", GetPercentile(durations, 0.95) },
+            { "mean", mean },
+            { "min", durations.front() },
+            { "max", durations.back() } } },
+        { "allocations_per_frame", static_cast<double>(allocations) / frames },
+        { "allocated_bytes_per_frame", static_cast<double>(allocatedBytes) / frames },
+        { "items_per_frame", itemsPerFrame },
+        { "items_per_second", median > 0.0 ? itemsPerFrame / (median / 1000.0) : 0.0 }
+    };
+    m_Results.push_back(std::move(result));
+}
+
+void Benchmark::Skip(const std::string& caseName, const std::string& reason)
+{
+    Log::Warning() << "Skipping " << m_Scenario << " / " << caseName << ": " << reason;
+
+    m_Results.push_back({
+        { "scenario", m_Scenario },
+        { "case", caseName },
+        { "skipped", reason } });
+}
+
+bool BenchmarkRegistry::Register(const std::string& name, BenchmarkFunction function)
+{
+    if (sBenchmarks == nullptr)
+    {
+        sBenchmarks = new std::vector<Entry>();
+    }
+
+    sBenchmarks->push_back(Entry{ .name = name, .function = function });
+    return true;
+}
+
+const std::vector<BenchmarkRegistry::Entry>& BenchmarkRegistry::GetBenchmarks()
+{
+    static const std::vector<Entry> sEmpty;
+    return sBenchmarks ? *sBenchmarks : sEmpty;
+}
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/serialization.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+struct BenchmarkSettings
+{
+    uint32_t frames{ 100 };
+    uint32_t warmupFrames{ 10 };
+    float scale{ 1.0f }; // Multiplies the size of every scenario, so the suite can be shortened on slow machines.
+    std::string model; // VFS path of the model rendered by the model_render scenario, which is part of a game's data.
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+// Handed to each scenario, which runs one or more cases through it. A
+// case is a function called once per frame: after the warm-up frames,
+// the duration and the allocations of every frame are recorded, and
+// reported as the median, 95th percentile and mean, which are much more
+// stable from one run to the next than a single total.
+//////////////////////////////////////////////////////////////////////////
+
+class Benchmark
+{
+public:
+    using FrameFunction = std::function<void()>;
+
+    Benchmark(const std::string& scenario, const BenchmarkSettings& settings, Json::Data& results);
+
+    const BenchmarkSettings& GetSettings() const { return m_Settings; }
+
+    // Applies the scale setting to a count, which is never scaled below 1.
+    size_t Scale(size_t count) const;
+
+    // itemsPerFrame is the number of items (bodies, entities, bytes...) processed by each frame, for the throughput.
+    // The optional setup function is called before every frame, and isn't measured.
+    void Run(const std::string& caseName, const Json::Data& parameters, uint64_t itemsPerFrame, const FrameFunction& frame, const FrameFunction& setup = nullptr);
+
+    // Records a case which couldn't run in this environment, so the results show why it is missing.
+    void Skip(const std::string& caseName, const std::string& reason);
+
+private:
+    std::string m_Scenario;
+    BenchmarkSettings m_Settings;
+    Json::Data& m_Results;
+};
+
+using BenchmarkFunction = void (*)(Benchmark& benchmark);
+
+class BenchmarkRegistry
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        BenchmarkFunction function;
+    };
+
+    static bool Register(const std::string& name, BenchmarkFunction function);
+    static const std::vector<Entry>& GetBenchmarks();
+
+private:
+    inline static std::vector<Entry>* sBenchmarks = nullptr;
+};
+
+#define REGISTER_BENCHMARK(NAME, FUNCTION) static const bool s##FUNCTION##Registered = WingsOfSteel::Bench::BenchmarkRegistry::Register(NAME, FUNCTION);
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <clipp.h>
+#include <magic_enum.hpp>
+
+#include "benchmark.hpp"
+#include "core/log.hpp"
+#include "pandora.hpp"
+#include "synthetic_data.hpp"
+
+using namespace WingsOfSteel;
+using namespace WingsOfSteel::Bench;
+
+// Version of the results' format, to be incremented whenever existing fields change meaning.
+static constexpr uint32_t sResultsVersion = 1;
+
+// Size of the offscreen render target the rendering scenarios draw to.
+static constexpr uint32_t sRenderTargetWidth = 1920;
+static constexpr uint32_t sRenderTargetHeight = 1080;
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    std::vector<std::string> scenarios;
+    std::string adapterName("null");
+    std::string outputPath("pandora_bench.json");
+    std::string workingDirectory;
+    bool list = false;
+    bool help = false;
+
+    auto cli = (
+        clipp::repeatable(clipp::option("-s", "--scenario") & clipp::value("name", scenarios)) % "Scenario to run; every scenario runs if none is given.",
+        (clipp::option("-f", "--frames") & clipp::value("count", settings.frames)) % "Measured frames per case.",
+        (clipp::option("-w", "--warmup") & clipp::value("count", settings.warmupFrames)) % "Frames run before measuring each case.",
+        (clipp::option("--scale") & clipp::value("factor", settings.scale)) % "Multiplies the size of every scenario.",
+        (clipp::option("-m", "--model") & clipp::value("path", settings.model)) % "VFS path of the model to render, e.g. /models/ship.glb.",
+        (clipp::option("-a", "--adapter") & clipp::value("default|fallback|null", adapterName)) % "WebGPU adapter to run on.",
+        (clipp::option("-o", "--output") & clipp::value("file", outputPath)) % "File to write the results to, or - for stdout.",
+        (clipp::option("-C", "--working-directory") & clipp::value("directory", workingDirectory)) % "Directory containing the data/core to run with.",
+        clipp::option("-l", "--list").set(list) % "Lists the scenarios.",
+        clipp::option("-h", "--help").set(help) % "Shows this help.");
+
+    if (!clipp::parse(argc, argv, cli) || help)
+    {
+        std::cout << clipp::make_man_page(cli, "pandora_bench");
+        return help ? 0 : 1;
+    }
+
+    std::vector<BenchmarkRegistry::Entry> benchmarks = BenchmarkRegistry::GetBenchmarks();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const BenchmarkRegistry::Entry& a, const BenchmarkRegistry::Entry& b) {
+        return a.name < b.name;
+    });
+
+    if (list)
+    {
+        for (const BenchmarkRegistry::Entry& benchmark : benchmarks)
+        {
+            std::cout << benchmark.name << "\n";
+        }
+        return 0;
+    }
+
+    for (const std::string& scenario : scenarios)
+    {
+        if (std::none_of(benchmarks.begin(), benchmarks.end(), [&scenario](const BenchmarkRegistry::Entry& benchmark) { return benchmark.name == scenario; }))
+        {
+            std::cerr << "Unknown scenario '" << scenario << "', see --list.\n";
+            return 1;
+        }
+    }
+
+    std::optional<RenderAdapter> adapter = magic_enum::enum_cast<RenderAdapter>(adapterName, magic_enum::case_insensitive);
+    if (!adapter.has_value())
+    {
+        std::cerr << "Unknown adapter '" << adapterName << "'.\n";
+        return 1;
+    }
+
+    if (!workingDirectory.empty())
+    {
+        if (outputPath != "-")
+        {
+            outputPath = std::filesystem::absolute(outputPath).string();
+        }
+        std::filesystem::current_path(workingDirectory);
+    }
+
+    Json::Data results = Json::Data::array();
+    SyntheticVFS::Prepare();
+
+    HeadlessSettings headlessSettings;
+    headlessSettings.SetAdapter(adapter.value());
+    headlessSettings.SetRenderTarget(sRenderTargetWidth, sRenderTargetHeight);
+    InitializeHeadless(
+        headlessSettings,
+        [&benchmarks, &scenarios, &settings, &results]() {
+            for (const BenchmarkRegistry::Entry& entry : benchmarks)
+            {
+                if (scenarios.empty() || std::find(scenarios.begin(), scenarios.end(), entry.name) != scenarios.end())
+                {
+                    Benchmark benchmark(entry.name, settings, results);
+                    entry.function(benchmark);
+                }
+            }
+        },
+        [](float delta) {},
+        []() {});
+
+    SyntheticVFS::Cleanup();
+
+    const Json::Data report = {
+        { "version", sResultsVersion },
+        { "adapter", std::string(magic_enum::enum_name(adapter.value())) },
+        { "hardware_threads", std::thread::hardware_concurrency() },
+        { "settings", {
+            { "frames", settings.frames },
+            { "warmup_frames", settings.warmupFrames },
+            { "scale", settings.scale },
+            { "model", settings.model },
+            { "render_target", { sRenderTargetWidth, sRenderTargetHeight } } } },
+        { "results", results }
+    };
+
+    if (outputPath == "-")
+    {
+        std::cout << report.dump(4) << std::endl;
+    }
+    else
+    {
+        std::ofstream output(outputPath);
+        output << report.dump(4) << std::endl;
+        if (!output.good())
+        {
+            std::cerr << "Failed to write results to '" << outputPath << "'.\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "core/serialization.hpp"
+#include "resources/resource_data_store.hpp"
+#include "synthetic_data.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+// A data store with many definitions, of which a game typically only needs a few.
+static Json::Data CreateDefinitions(size_t count)
+{
+    Json::Data definitions = Json::Data::object();
+    for (size_t i = 0; i < count; i++)
+    {
+        definitions["definition_" + std::to_string(i)] = {
+            { "name", "Definition " + std::to_string(i) },
+            { "health", static_cast<int>(i % 1000) },
+            { "speed", static_cast<float>(i) * 0.5f },
+            { "armor", static_cast<float>(i % 7) },
+            { "enabled", i % 2 == 0 },
+            { "color", { 1.0f, 0.5f, 0.25f, 1.0f } },
+            { "offset", { 0.0f, 1.0f, 2.0f } },
+            { "tags", { "ship", "hostile", "large" } }
+        };
+    }
+    return definitions;
+}
+
+static void JsonBenchmark(Benchmark& benchmark)
+{
+    const size_t definitionCount = benchmark.Scale(5000);
+    ResourceDataStoreSharedPtr pDataStore = SyntheticVFS::LoadDataStore(SyntheticVFS::Path("definitions.json"), CreateDefinitions(definitionCount));
+    FileSharedPtr pFile = SyntheticVFS::ReadFile(SyntheticVFS::Path("definitions.json"));
+    const std::string_view text(pFile->GetData().data(), pFile->GetData().size());
+
+    benchmark.Run("parse", { { "definitions", definitionCount } }, text.size(), [text]() {
+        const Json::Data data = Json::Data::parse(text);
+    });
+
+    const std::string_view keys[] = { "definition_0" };
+    benchmark.Run("parse_filtered", { { "definitions", definitionCount }, { "kept", std::size(keys) } }, text.size(), [text, &keys]() {
+        const Json::Data data = Json::ParseFiltered(text, keys);
+    });
+
+    // Each definition is deserialized field by field, as a component would.
+    const ResourceDataStore* pContext = pDataStore.get();
+    const Json::Data& definitions = pDataStore->Data();
+    benchmark.Run("deserialize", { { "definitions", definitionCount } }, definitionCount * 7, [pContext, &definitions]() {
+        for (const Json::Data& definition : definitions)
+        {
+            Json::DeserializeString(pContext, definition, "name");
+            Json::DeserializeInteger(pContext, definition, "health");
+            Json::DeserializeFloat(pContext, definition, "speed");
+            Json::DeserializeFloat(pContext, definition, "armor");
+            Json::DeserializeBool(pContext, definition, "enabled");
+            Json::DeserializeVec4(pContext, definition, "color");
+            Json::DeserializeVec3(pContext, definition, "offset");
+        }
+    });
+}
+
+REGISTER_BENCHMARK("json", JsonBenchmark)
+
+} // namespace WingsOfSteel::Bench
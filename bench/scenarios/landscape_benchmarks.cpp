@@ -0,0 +1,49 @@
+#include <string>
+
+#include "benchmark.hpp"
+#include "pandora.hpp"
+#include "resources/resource_system.hpp"
+#include "scene/components/landscape_component.hpp"
+#include "scene/entity.hpp"
+#include "scene/scene.hpp"
+#include "scene/systems/landscape_system.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+static void LandscapeBenchmark(Benchmark& benchmark)
+{
+    // The heightmap's debug texture has its mips generated by a shader, which is part of the game's data.
+    if (!GetVFS()->Exists("/shaders/mip_level.wgsl"))
+    {
+        benchmark.Skip("generate", "/shaders/mip_level.wgsl isn't available, run from a game's directory (see --working-directory).");
+        return;
+    }
+
+    SceneSharedPtr pScene = std::make_shared<Scene>();
+    pScene->Initialize();
+    LandscapeSystem* pLandscapeSystem = pScene->AddSystem<LandscapeSystem>();
+
+    for (uint32_t size : { 128, 256, 512 })
+    {
+        EntitySharedPtr pLandscapeEntity = pScene->CreateEntity();
+        LandscapeComponent& landscapeComponent = pLandscapeEntity->AddComponent<LandscapeComponent>();
+        landscapeComponent.Width = size;
+        landscapeComponent.Length = size;
+
+        benchmark.Run(
+            std::to_string(size) + "x" + std::to_string(size),
+            { { "width", size }, { "length", size } },
+            size * size,
+            [pLandscapeSystem, pLandscapeEntity]() { pLandscapeSystem->Generate(pLandscapeEntity); },
+            []() { GetResourceSystem()->Update(); });
+
+        pScene->RemoveEntity(pLandscapeEntity);
+        pScene->Update(0.0f);
+    }
+}
+
+REGISTER_BENCHMARK("landscape", LandscapeBenchmark)
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,174 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmark.hpp"
+#include "core/task_scheduler.hpp"
+#include "pandora.hpp"
+#include "physics/physics_snapshot.hpp"
+#include "resources/resource_data_store.hpp"
+#include "scene/components/rigid_body_component.hpp"
+#include "scene/prefab.hpp"
+#include "scene/scene.hpp"
+#include "scene/systems/physics_simulation_system.hpp"
+#include "synthetic_data.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+static constexpr uint32_t sTickRate = 60;
+static constexpr float sBodySpacing = 2.5f;
+
+static ResourceDataStoreSharedPtr LoadPhysicsDataStore()
+{
+    return SyntheticVFS::LoadDataStore(SyntheticVFS::Path("physics.json"), {
+        { "body", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", SyntheticData::DynamicSphere(1.0f) } } },
+        { "ground", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", SyntheticData::StaticBox(glm::vec3(1000.0f, 1.0f, 1000.0f)) } } } });
+}
+
+// Spheres are stacked in columns over a static ground, so they keep colliding with each other and never sleep.
+static SceneSharedPtr CreatePhysicsScene(ResourceDataStoreSharedPtr pDataStore, PhysicsSimulationSystem::Mode mode, size_t bodyCount)
+{
+    SceneSharedPtr pScene = std::make_shared<Scene>();
+    pScene->Initialize();
+
+    PhysicsSimulationSystem* pPhysicsSimulationSystem = pScene->AddSystem<PhysicsSimulationSystem>(mode);
+    pPhysicsSimulationSystem->SetTickRate(sTickRate);
+    pPhysicsSimulationSystem->SetMaxTicksPerUpdate(1);
+
+    Prefab(pDataStore, pDataStore->Data()["ground"]).Spawn(pScene.get());
+
+    const std::vector<EntityHandle> bodies = Prefab(pDataStore, pDataStore->Data()["body"]).SpawnN(pScene.get(), bodyCount);
+    const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(bodyCount / 10.0)));
+    entt::registry& registry = pScene->GetRegistry();
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        const glm::vec3 position(
+            (static_cast<float>(i % columns) - columns * 0.5f) * sBodySpacing,
+            2.0f + static_cast<float>(i / (columns * columns)) * sBodySpacing,
+            (static_cast<float>((i / columns) % columns) - columns * 0.5f) * sBodySpacing);
+        registry.get<RigidBodyComponent>(bodies[i]).SetWorldTransform(glm::translate(glm::mat4(1.0f), position));
+    }
+
+    return pScene;
+}
+
+// Every update is a bit longer than a tick, and the ticks are capped to one per update: each frame runs exactly one tick.
+static void UpdatePhysicsScene(Scene* pScene)
+{
+    pScene->Update(1.5f / sTickRate);
+}
+
+static void PhysicsStepBenchmark(Benchmark& benchmark)
+{
+    ResourceDataStoreSharedPtr pDataStore = LoadPhysicsDataStore();
+    const size_t bodyCount = benchmark.Scale(4000);
+
+    {
+        SceneSharedPtr pScene = CreatePhysicsScene(pDataStore, PhysicsSimulationSystem::Mode::SingleThreaded, bodyCount);
+        benchmark.Run("single_threaded", { { "bodies", bodyCount } }, bodyCount, [&pScene]() { UpdatePhysicsScene(pScene.get()); });
+    }
+
+    TaskScheduler* pTaskScheduler = GetTaskScheduler();
+    const uint32_t maxThreadCount = pTaskScheduler->GetMaxThreadCount();
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreadCount);
+
+    for (uint32_t threadCount : threadCounts)
+    {
+        pTaskScheduler->SetThreadCount(threadCount);
+        SceneSharedPtr pScene = CreatePhysicsScene(pDataStore, PhysicsSimulationSystem::Mode::Multithreaded, bodyCount);
+        benchmark.Run("multithreaded_" + std::to_string(threadCount), { { "bodies", bodyCount }, { "threads", threadCount } }, bodyCount, [&pScene]() { UpdatePhysicsScene(pScene.get()); });
+    }
+    pTaskScheduler->SetThreadCount(maxThreadCount);
+}
+
+static void PhysicsSnapshotBenchmark(Benchmark& benchmark)
+{
+    ResourceDataStoreSharedPtr pDataStore = LoadPhysicsDataStore();
+    const size_t bodyCount = benchmark.Scale(10000);
+    SceneSharedPtr pScene = CreatePhysicsScene(pDataStore, PhysicsSimulationSystem::Mode::SingleThreaded, bodyCount);
+    PhysicsSimulationSystem* pPhysicsSimulationSystem = pScene->GetSystem<PhysicsSimulationSystem>();
+
+    // Lets the bodies fall for a while, so the snapshot isn't of bodies which have never moved.
+    for (int i = 0; i < 30; i++)
+    {
+        UpdatePhysicsScene(pScene.get());
+    }
+
+    PhysicsSnapshot snapshot;
+    benchmark.Run("capture", { { "bodies", bodyCount } }, bodyCount, [pPhysicsSimulationSystem, &snapshot]() {
+        pPhysicsSimulationSystem->CaptureSnapshot(snapshot);
+    });
+
+    benchmark.Run("restore", { { "bodies", bodyCount } }, bodyCount, [pPhysicsSimulationSystem, &snapshot]() {
+        pPhysicsSimulationSystem->RestoreSnapshot(snapshot);
+    });
+}
+
+// Spheres sink slightly into the ground and can't move, so each keeps touching it while asleep. Nothing changes from one
+// tick to the next, which measures what the contact events cost when there is nothing to report.
+static void PhysicsIdleContactsBenchmark(Benchmark& benchmark)
+{
+    Json::Data restingSphere = SyntheticData::DynamicSphere(1.0f);
+    restingSphere["linear_factor"] = { 0.0f, 0.0f, 0.0f };
+    restingSphere["angular_factor"] = { 0.0f, 0.0f, 0.0f };
+    restingSphere["allow_sleeping"] = true;
+    ResourceDataStoreSharedPtr pDataStore = SyntheticVFS::LoadDataStore(SyntheticVFS::Path("physics_idle_contacts.json"), {
+        { "body", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", restingSphere } } },
+        { "ground", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", SyntheticData::StaticBox(glm::vec3(1000.0f, 1.0f, 1000.0f)) } } } });
+
+    for (size_t baseContactCount : { 1000, 10000 })
+    {
+        const size_t contactCount = benchmark.Scale(baseContactCount);
+        SceneSharedPtr pScene = std::make_shared<Scene>();
+        pScene->Initialize();
+
+        PhysicsSimulationSystem* pPhysicsSimulationSystem = pScene->AddSystem<PhysicsSimulationSystem>(PhysicsSimulationSystem::Mode::SingleThreaded);
+        pPhysicsSimulationSystem->SetTickRate(sTickRate);
+        pPhysicsSimulationSystem->SetMaxTicksPerUpdate(1);
+
+        Prefab(pDataStore, pDataStore->Data()["ground"]).Spawn(pScene.get());
+
+        // A single layer of spheres, far enough apart not to touch each other. The ground's top is at y = 0.5.
+        const std::vector<EntityHandle> bodies = Prefab(pDataStore, pDataStore->Data()["body"]).SpawnN(pScene.get(), contactCount);
+        const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(contactCount))));
+        entt::registry& registry = pScene->GetRegistry();
+        for (size_t i = 0; i < bodies.size(); i++)
+        {
+            const glm::vec3 position(
+                (static_cast<float>(i % columns) - columns * 0.5f) * sBodySpacing,
+                1.4f,
+                (static_cast<float>(i / columns) - columns * 0.5f) * sBodySpacing);
+            registry.get<RigidBodyComponent>(bodies[i]).SetWorldTransform(glm::translate(glm::mat4(1.0f), position));
+        }
+
+        // Bodies fall asleep after resting for two seconds.
+        for (uint32_t i = 0; i < sTickRate * 3; i++)
+        {
+            UpdatePhysicsScene(pScene.get());
+        }
+
+        benchmark.Run(std::to_string(contactCount), { { "contacts", contactCount } }, contactCount, [&pScene]() { UpdatePhysicsScene(pScene.get()); });
+    }
+}
+
+REGISTER_BENCHMARK("physics_step", PhysicsStepBenchmark)
+REGISTER_BENCHMARK("physics_idle_contacts", PhysicsIdleContactsBenchmark)
+REGISTER_BENCHMARK("physics_snapshot", PhysicsSnapshotBenchmark)
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <string>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmark.hpp"
+#include "pandora.hpp"
+#include "render/frame_readback.hpp"
+#include "render/window.hpp"
+#include "resources/resource_model.hpp"
+#include "resources/resource_system.hpp"
+#include "scene/components/camera_component.hpp"
+#include "scene/components/model_component.hpp"
+#include "scene/components/transform_component.hpp"
+#include "scene/entity.hpp"
+#include "scene/scene.hpp"
+#include "scene/systems/model_render_system.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+static constexpr float sInstanceSpacing = 4.0f;
+
+static ResourceModelSharedPtr LoadModel(const std::string& path)
+{
+    ResourceModelSharedPtr pModel;
+    GetResourceSystem()->RequestResource(path, [&pModel](ResourceSharedPtr pResource) {
+        pModel = std::dynamic_pointer_cast<ResourceModel>(pResource);
+    });
+
+    while (!pModel)
+    {
+        GetVFS()->Update();
+        GetResourceSystem()->Update();
+    }
+    return pModel;
+}
+
+// The instances are laid out in a square grid, all of them in front of the camera.
+static SceneSharedPtr CreateModelScene(ResourceModelSharedPtr pModel, size_t instanceCount)
+{
+    SceneSharedPtr pScene = std::make_shared<Scene>();
+    pScene->Initialize();
+    pScene->AddSystem<ModelRenderSystem>();
+
+    const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+    const float extent = static_cast<float>(columns) * sInstanceSpacing;
+    for (size_t i = 0; i < instanceCount; i++)
+    {
+        const glm::vec3 position(
+            (static_cast<float>(i % columns) - columns * 0.5f) * sInstanceSpacing,
+            0.0f,
+            (static_cast<float>(i / columns) - columns * 0.5f) * sInstanceSpacing);
+
+        EntitySharedPtr pEntity = pScene->CreateEntity();
+        pEntity->AddComponent<TransformComponent>().transform = glm::translate(glm::mat4(1.0f), position);
+        pEntity->AddComponent<ModelComponent>().SetModel(pModel);
+    }
+
+    EntitySharedPtr pCamera = pScene->CreateEntity();
+    CameraComponent& cameraComponent = pCamera->AddComponent<CameraComponent>(45.0f, 0.1f, extent * 4.0f);
+    cameraComponent.camera.LookAt(glm::vec3(0.0f, extent, extent), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    pScene->SetCamera(pCamera);
+
+    return pScene;
+}
+
+static void ModelRenderBenchmark(Benchmark& benchmark)
+{
+    const std::string& modelPath = benchmark.GetSettings().model;
+    if (modelPath.empty() || !GetVFS()->Exists(modelPath))
+    {
+        benchmark.Skip("instances", "No model to render, pass one from a game's data with --model (see --working-directory).");
+        return;
+    }
+
+    ResourceModelSharedPtr pModel = LoadModel(modelPath);
+    Window* pWindow = GetWindow();
+
+    // Each frame is a full engine update, rendered to the offscreen window.
+    for (size_t baseInstanceCount : { 100, 1000, 10000 })
+    {
+        const size_t instanceCount = benchmark.Scale(baseInstanceCount);
+        SetActiveScene(CreateModelScene(pModel, instanceCount));
+        benchmark.Run(
+            std::to_string(instanceCount),
+            { { "instances", instanceCount }, { "width", pWindow->GetWidth() }, { "height", pWindow->GetHeight() } },
+            instanceCount,
+            []() { Update(); });
+    }
+
+    // Reading every frame back waits for the GPU to finish it, so this measures the whole frame's latency.
+    const size_t instanceCount = benchmark.Scale(1000);
+    SetActiveScene(CreateModelScene(pModel, instanceCount));
+    pWindow->SetReadbackEnabled(true);
+    benchmark.Run(
+        "readback_" + std::to_string(instanceCount),
+        { { "instances", instanceCount }, { "width", pWindow->GetWidth() }, { "height", pWindow->GetHeight() } },
+        instanceCount,
+        [pWindow]() {
+            Update();
+            pWindow->GetFrameReadback()->WaitForPixels();
+        });
+    pWindow->SetReadbackEnabled(false);
+
+    SetActiveScene(nullptr);
+}
+
+REGISTER_BENCHMARK("model_render", ModelRenderBenchmark)
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,50 @@
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "pandora.hpp"
+#include "resources/resource.hpp"
+#include "resources/resource_system.hpp"
+#include "synthetic_data.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+static void ResourceLoadBenchmark(Benchmark& benchmark)
+{
+    const size_t fileCount = benchmark.Scale(256);
+    std::vector<std::string> paths;
+    paths.reserve(fileCount);
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        Json::Data data = Json::Data::object();
+        for (int field = 0; field < 64; field++)
+        {
+            data["field_" + std::to_string(field)] = { { "value", field }, { "position", { 1.0f, 2.0f, 3.0f } } };
+        }
+
+        paths.push_back(SyntheticVFS::Path("resources/data_store_" + std::to_string(i) + ".json"));
+        SyntheticVFS::WriteDataStore(paths.back(), data);
+    }
+
+    // The resource system caches every resource it loads, so each frame loads the files with a new one.
+    benchmark.Run("data_stores", { { "files", fileCount } }, fileCount, [&paths]() {
+        ResourceSystem resourceSystem;
+        bool loaded = false;
+        resourceSystem.RequestResources(paths, [&loaded](const std::unordered_map<std::string, ResourceSharedPtr>& resources) {
+            loaded = true;
+        });
+
+        while (!loaded)
+        {
+            GetVFS()->Update();
+            resourceSystem.Update();
+        }
+    });
+}
+
+REGISTER_BENCHMARK("resource_load", ResourceLoadBenchmark)
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmark.hpp"
+#include "core/binary_serialization.hpp"
+#include "resources/resource_data_store.hpp"
+#include "scene/components/component_factory.hpp"
+#include "scene/entity.hpp"
+#include "scene/entity_ref.hpp"
+#include "scene/prefab.hpp"
+#include "scene/scene.hpp"
+#include "scene/scene_serialization.hpp"
+#include "synthetic_data.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+static ResourceDataStoreSharedPtr LoadPrefabDataStore()
+{
+    return SyntheticVFS::LoadDataStore(SyntheticVFS::Path("prefabs.json"), {
+        { "transform", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) } } },
+        { "rigid_body", {
+            { "transform", SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", SyntheticData::DynamicSphere(1.0f) } } } });
+}
+
+static SceneSharedPtr CreateScene()
+{
+    SceneSharedPtr pScene = std::make_shared<Scene>();
+    pScene->Initialize();
+    return pScene;
+}
+
+static void EntityRemovalBenchmark(Benchmark& benchmark)
+{
+    ResourceDataStoreSharedPtr pDataStore = LoadPrefabDataStore();
+    const Prefab prefab(pDataStore, pDataStore->Data()["transform"]);
+
+    // Half of the entities are removed, as well as a fixed number of them, so the cost of an update which removes few or
+    // no entities can be told apart from the population. The removals are spread evenly over the whole registry.
+    for (size_t basePopulation : { 1000, 10000, 100000 })
+    {
+        const size_t population = benchmark.Scale(basePopulation);
+        for (size_t removedCount : { size_t(0), std::min<size_t>(100, population), population / 2 })
+        {
+            const size_t stride = removedCount > 0 ? population / removedCount : 0;
+
+            SceneSharedPtr pScene;
+            std::vector<EntityHandle> entities;
+            benchmark.Run(
+                std::to_string(population) + "_remove_" + std::to_string(removedCount),
+                { { "population", population }, { "removed", removedCount } },
+                removedCount,
+                [&pScene, &entities, removedCount, stride]() {
+                    for (size_t i = 0; i < removedCount; i++)
+                    {
+                        pScene->RemoveEntity(EntityRef(pScene.get(), entities[i * stride]));
+                    }
+                    pScene->Update(0.0f);
+                },
+                [&pScene, &entities, &prefab, population]() {
+                    pScene = CreateScene();
+                    entities = prefab.SpawnN(pScene.get(), population);
+                });
+        }
+    }
+}
+
+static void PrefabSpawnBenchmark(Benchmark& benchmark)
+{
+    ResourceDataStoreSharedPtr pDataStore = LoadPrefabDataStore();
+    const size_t count = benchmark.Scale(10000);
+
+    for (const char* pPrefabName : { "transform", "rigid_body" })
+    {
+        const Prefab prefab(pDataStore, pDataStore->Data()[pPrefabName]);
+        SceneSharedPtr pScene;
+        benchmark.Run(
+            pPrefabName,
+            { { "entities", count } },
+            count,
+            [&pScene, &prefab, count]() { prefab.SpawnN(pScene.get(), count); },
+            [&pScene]() { pScene = CreateScene(); });
+    }
+}
+
+// Loads the entities of a JSON scene as Entity objects, the way games build their scenes from data stores.
+static void LoadJsonScene(Scene* pScene, const ResourceDataStore* pContext, const Json::Data& sceneData)
+{
+    for (const Json::Data& entityData : sceneData["entities"])
+    {
+        EntitySharedPtr pEntity = pScene->CreateEntity();
+        for (const auto& [typeName, componentData] : entityData.items())
+        {
+            ComponentFactory::Create(pEntity.get(), pContext, typeName, componentData);
+        }
+    }
+    pScene->Update(0.0f);
+}
+
+static void SceneLoadBenchmark(Benchmark& benchmark)
+{
+    const size_t entityCount = benchmark.Scale(50000);
+
+    Json::Data sceneData = { { "entities", Json::Data::array() } };
+    for (size_t i = 0; i < entityCount; i++)
+    {
+        const glm::vec3 position(static_cast<float>(i % 256) * 2.0f, 0.0f, static_cast<float>(i / 256) * 2.0f);
+        sceneData["entities"].push_back({
+            { "transform", SyntheticData::Transform(glm::translate(glm::mat4(1.0f), position)) },
+            { "rigid_body", SyntheticData::DynamicSphere(1.0f) } });
+    }
+
+    // Both versions of the scene are loaded from files, as they would be in a game.
+    ResourceDataStoreSharedPtr pDataStore = SyntheticVFS::LoadDataStore(SyntheticVFS::Path("scene.json"), sceneData);
+    FileSharedPtr pJsonFile = SyntheticVFS::ReadFile(SyntheticVFS::Path("scene.json"));
+
+    {
+        SceneSharedPtr pScene = CreateScene();
+        LoadJsonScene(pScene.get(), pDataStore.get(), pDataStore->Data());
+        Binary::Writer writer;
+        SceneSerialization::SaveBinary(pScene.get(), writer);
+        SyntheticVFS::WriteFile(SyntheticVFS::Path("scene.bin"), writer.GetData());
+    }
+    FileSharedPtr pBinaryFile = SyntheticVFS::ReadFile(SyntheticVFS::Path("scene.bin"));
+
+    SceneSharedPtr pScene;
+    const auto createScene = [&pScene]() { pScene = CreateScene(); };
+
+    const FileData& jsonData = pJsonFile->GetData();
+    benchmark.Run(
+        "json",
+        { { "entities", entityCount }, { "bytes", jsonData.size() } },
+        entityCount,
+        [&pScene, &pDataStore, &jsonData]() {
+            const Json::Data sceneData = Json::Data::parse(jsonData.begin(), jsonData.end());
+            LoadJsonScene(pScene.get(), pDataStore.get(), sceneData);
+        },
+        createScene);
+
+    const std::span<const uint8_t> binaryData(reinterpret_cast<const uint8_t*>(pBinaryFile->GetData().data()), pBinaryFile->GetData().size());
+    benchmark.Run(
+        "binary",
+        { { "entities", entityCount }, { "bytes", binaryData.size() } },
+        entityCount,
+        [&pScene, binaryData]() {
+            SceneSerialization::LoadBinary(pScene.get(), binaryData);
+            pScene->Update(0.0f);
+        },
+        createScene);
+}
+
+REGISTER_BENCHMARK("entity_removal", EntityRemovalBenchmark)
+REGISTER_BENCHMARK("prefab_spawn", PrefabSpawnBenchmark)
+REGISTER_BENCHMARK("scene_load", SceneLoadBenchmark)
+
+} // namespace WingsOfSteel::Bench
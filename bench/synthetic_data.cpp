@@ -0,0 +1,157 @@
+#include "synthetic_data.hpp"
+
+#include <filesystem>
+#include <random>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "core/log.hpp"
+#include "pandora.hpp"
+#include "resources/resource_data_store.hpp"
+#include "resources/resource_system.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel::Bench
+{
+
+// Native VFS layout: the VFS doesn't create directories, so they are created here before writing.
+static const std::filesystem::path sDataDirectory("data/core");
+static std::string sBenchDirectoryName; // Uniquely named, so a game's own files are never written to or removed.
+static std::filesystem::path sCreatedDirectory; // Outermost directory created by Prepare(), removed by Cleanup().
+
+void SyntheticVFS::Prepare()
+{
+    std::random_device randomDevice;
+    do
+    {
+        sBenchDirectoryName = "pandora_bench_" + std::to_string(randomDevice());
+    } while (std::filesystem::exists(sDataDirectory / sBenchDirectoryName));
+
+    const std::filesystem::path benchDirectory = sDataDirectory / sBenchDirectoryName;
+    if (!std::filesystem::exists("data"))
+    {
+        sCreatedDirectory = "data";
+    }
+    else if (!std::filesystem::exists(sDataDirectory))
+    {
+        sCreatedDirectory = sDataDirectory;
+    }
+    else
+    {
+        sCreatedDirectory = benchDirectory;
+    }
+    std::filesystem::create_directories(benchDirectory);
+}
+
+void SyntheticVFS::Cleanup()
+{
+    if (sCreatedDirectory.empty())
+    {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(sCreatedDirectory, error);
+    if (error)
+    {
+        Log::Warning() << "Failed to remove the benchmark files: " << error.message();
+    }
+    sCreatedDirectory.clear();
+}
+
+std::string SyntheticVFS::Path(const std::string& name)
+{
+    return "/" + sBenchDirectoryName + "/" + name;
+}
+
+void SyntheticVFS::WriteFile(const std::string& path, const std::vector<uint8_t>& bytes)
+{
+    std::filesystem::create_directories((sDataDirectory / path.substr(1)).parent_path());
+    if (!GetVFS()->FileWrite(path, bytes))
+    {
+        Log::Error() << "Failed to write '" << path << "'.";
+    }
+}
+
+void SyntheticVFS::WriteDataStore(const std::string& path, const Json::Data& data)
+{
+    const std::string text = data.dump();
+    WriteFile(path, std::vector<uint8_t>(text.begin(), text.end()));
+}
+
+FileSharedPtr SyntheticVFS::ReadFile(const std::string& path)
+{
+    FileSharedPtr pFile;
+    bool completed = false;
+    GetVFS()->FileRead(path, [&pFile, &completed, &path](FileReadResult result, FileSharedPtr pReadFile) {
+        if (result != FileReadResult::Ok)
+        {
+            Log::Error() << "Failed to read '" << path << "'.";
+        }
+        pFile = pReadFile;
+        completed = true;
+    });
+
+    while (!completed)
+    {
+        GetVFS()->Update();
+    }
+    return pFile;
+}
+
+ResourceDataStoreSharedPtr SyntheticVFS::LoadDataStore(const std::string& path, const Json::Data& data)
+{
+    WriteDataStore(path, data);
+
+    ResourceDataStoreSharedPtr pDataStore;
+    GetResourceSystem()->RequestResource(path, [&pDataStore](ResourceSharedPtr pResource) {
+        pDataStore = std::dynamic_pointer_cast<ResourceDataStore>(pResource);
+    });
+
+    while (!pDataStore)
+    {
+        GetVFS()->Update();
+        GetResourceSystem()->Update();
+    }
+    return pDataStore;
+}
+
+Json::Data SyntheticData::Transform(const glm::mat4& transform)
+{
+    const float* pValues = glm::value_ptr(transform);
+    Json::Data values = Json::Data::array();
+    for (int i = 0; i < 16; i++)
+    {
+        values.push_back(pValues[i]);
+    }
+    return { { "transform", std::move(values) } };
+}
+
+Json::Data SyntheticData::DynamicSphere(float radius)
+{
+    return {
+        { "motion_type", "Dynamic" },
+        { "mass", 1 },
+        { "linear_damping", 0.0f },
+        { "angular_damping", 0.0f },
+        { "linear_factor", { 1.0f, 1.0f, 1.0f } },
+        { "angular_factor", { 1.0f, 1.0f, 1.0f } },
+        { "allow_sleeping", false },
+        { "shape", { { "type", "Sphere" }, { "radius", radius } } }
+    };
+}
+
+Json::Data SyntheticData::StaticBox(const glm::vec3& dimensions)
+{
+    return {
+        { "motion_type", "Static" },
+        { "mass", 0 },
+        { "linear_damping", 0.0f },
+        { "angular_damping", 0.0f },
+        { "linear_factor", { 1.0f, 1.0f, 1.0f } },
+        { "angular_factor", { 1.0f, 1.0f, 1.0f } },
+        { "shape", { { "type", "Box" }, { "dimensions", { dimensions.x, dimensions.y, dimensions.z } } } }
+    };
+}
+
+} // namespace WingsOfSteel::Bench
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "core/serialization.hpp"
+#include "core/smart_ptr.hpp"
+#include "vfs/file.hpp"
+
+namespace WingsOfSteel
+{
+DECLARE_SMART_PTR(ResourceDataStore);
+}
+
+namespace WingsOfSteel::Bench
+{
+
+// Files generated by the benchmarks are written to the VFS under a uniquely named directory, which is deleted once
+// the benchmarks are done. Loading them goes through the same VFS and resource system paths as a game's data.
+namespace SyntheticVFS
+{
+
+// Must be called before the engine is initialized: the native VFS needs data/core to exist, and it is created
+// (and later removed) if the benchmarks aren't run from a game's directory.
+void Prepare();
+void Cleanup();
+
+// VFS path of a generated file, e.g. Path("scene.json").
+std::string Path(const std::string& name);
+
+void WriteFile(const std::string& path, const std::vector<uint8_t>& bytes);
+void WriteDataStore(const std::string& path, const Json::Data& data);
+FileSharedPtr ReadFile(const std::string& path);
+
+// Writes the data store, then loads it through the resource system, waiting for it to be available.
+ResourceDataStoreSharedPtr LoadDataStore(const std::string& path, const Json::Data& data);
+
+} // namespace SyntheticVFS
+
+// Component definitions, in the format used by prefabs and by ComponentFactory::Create().
+namespace SyntheticData
+{
+
+Json::Data Transform(const glm::mat4& transform);
+Json::Data DynamicSphere(float radius);
+Json::Data StaticBox(const glm::vec3& dimensions);
+
+} // namespace SyntheticData
+} // namespace WingsOfSteel::Bench
@@ -41,6 +41,7 @@ if(TARGET_PLATFORM_NATIVE)
 
     set(BUILD_EXTRAS OFF)
     set(BUILD_UNIT_TESTS OFF)
+    set(BULLET2_MULTITHREADING ON) # Required by PhysicsSimulationSystem::Mode::Multithreaded.
     FetchContent_Declare(
         bullet3
         GIT_REPOSITORY https://github.com/bulletphysics/bullet3.git
@@ -0,0 +1,168 @@
+#include "core/binary_serialization.hpp"
+
+namespace WingsOfSteel::Binary
+{
+
+static constexpr uint32_t sNullEntityIndex = ~0u;
+
+void Writer::Write(std::string_view value)
+{
+    Write<uint32_t>(static_cast<uint32_t>(value.size()));
+    WriteBytes(value.data(), value.size());
+}
+
+void Writer::WriteBytes(const void* pData, size_t size)
+{
+    if (size > 0)
+    {
+        const size_t offset = m_Data.size();
+        m_Data.resize(offset + size);
+        memcpy(m_Data.data() + offset, pData, size);
+    }
+}
+
+void Writer::Write(entt::entity entity)
+{
+    if (m_pEntityIndices == nullptr)
+    {
+        Write<uint32_t>(static_cast<uint32_t>(entt::to_integral(entity)));
+        return;
+    }
+
+    auto it = m_pEntityIndices->find(entity);
+    Write<uint32_t>((it != m_pEntityIndices->cend()) ? it->second : sNullEntityIndex);
+}
+
+void Writer::WriteFloats(const float* pValues, size_t count)
+{
+    const size_t offset = m_Data.size();
+    m_Data.resize(offset + count * sizeof(float));
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        memcpy(m_Data.data() + offset, pValues, count * sizeof(float));
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            Store(m_Data.data() + offset + i * sizeof(float), pValues[i]);
+        }
+    }
+}
+
+glm::vec2 Reader::ReadVec2()
+{
+    glm::vec2 value(0.0f);
+    ReadFloats(&value.x, 2);
+    return value;
+}
+
+glm::vec3 Reader::ReadVec3()
+{
+    glm::vec3 value(0.0f);
+    ReadFloats(&value.x, 3);
+    return value;
+}
+
+glm::vec4 Reader::ReadVec4()
+{
+    glm::vec4 value(0.0f);
+    ReadFloats(&value.x, 4);
+    return value;
+}
+
+glm::quat Reader::ReadQuat()
+{
+    const glm::vec4 value = ReadVec4();
+    return IsValid() ? glm::quat(value.w, value.x, value.y, value.z) : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+glm::mat4 Reader::ReadMat4()
+{
+    glm::mat4 value(1.0f);
+    ReadFloats(&value[0][0], 16);
+    return value;
+}
+
+std::string_view Reader::ReadString()
+{
+    const uint32_t size = Read<uint32_t>();
+    if (!Reserve(size))
+    {
+        return std::string_view();
+    }
+
+    std::string_view value(reinterpret_cast<const char*>(m_Data.data() + m_Offset), size);
+    m_Offset += size;
+    return value;
+}
+
+bool Reader::ReadBytes(void* pData, size_t size)
+{
+    if (!Reserve(size))
+    {
+        return false;
+    }
+
+    if (size > 0)
+    {
+        memcpy(pData, m_Data.data() + m_Offset, size);
+        m_Offset += size;
+    }
+    return true;
+}
+
+void Reader::Skip(size_t size)
+{
+    if (Reserve(size))
+    {
+        m_Offset += size;
+    }
+}
+
+entt::entity Reader::ReadEntity()
+{
+    const uint32_t index = Read<uint32_t>();
+    if (m_Entities.empty())
+    {
+        return IsValid() ? entt::entity{ index } : entt::entity{ entt::null };
+    }
+    else if (index == sNullEntityIndex || index >= m_Entities.size())
+    {
+        return entt::null;
+    }
+    return m_Entities[index];
+}
+
+bool Reader::Reserve(size_t size)
+{
+    if (m_Failed || size > m_Data.size() - m_Offset)
+    {
+        m_Failed = true;
+        return false;
+    }
+    return true;
+}
+
+void Reader::ReadFloats(float* pValues, size_t count)
+{
+    if (!Reserve(count * sizeof(float)))
+    {
+        return;
+    }
+
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        memcpy(pValues, m_Data.data() + m_Offset, count * sizeof(float));
+        m_Offset += count * sizeof(float);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            pValues[i] = Read<float>();
+        }
+    }
+}
+
+} // namespace WingsOfSteel::Binary
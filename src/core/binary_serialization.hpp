@@ -0,0 +1,207 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace WingsOfSteel
+{
+
+// Binary counterpart to the Json helpers, used for saves and cooked levels. JSON remains the authoring format.
+// All values are stored little-endian and unaligned, so the reader can work directly on a memory-mapped file.
+namespace Binary
+{
+
+// FNV-1a hash of a component's field layout, e.g. "transform:mat4". Any change to the layout must change the string,
+// so that data written with the old layout is rejected rather than misread.
+constexpr uint64_t SchemaHash(std::string_view schema)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : schema)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+template <typename T>
+concept Scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+class Writer
+{
+public:
+    Writer() = default;
+
+    template <Scalar T>
+    void Write(T value)
+    {
+        const size_t offset = m_Data.size();
+        m_Data.resize(offset + sizeof(T));
+        Store(m_Data.data() + offset, value);
+    }
+
+    // Overwrites a value written earlier, such as a size which is only known once a block has been written.
+    template <Scalar T>
+    void WriteAt(size_t offset, T value)
+    {
+        Store(m_Data.data() + offset, value);
+    }
+
+    void Write(bool value) { Write<uint8_t>(value ? 1 : 0); }
+    void Write(const glm::vec2& value) { WriteFloats(&value.x, 2); }
+    void Write(const glm::vec3& value) { WriteFloats(&value.x, 3); }
+    void Write(const glm::vec4& value) { WriteFloats(&value.x, 4); }
+    void Write(const glm::quat& value) { Write(glm::vec4(value.x, value.y, value.z, value.w)); }
+    void Write(const glm::mat4& value) { WriteFloats(&value[0][0], 16); }
+    void Write(std::string_view value);
+    void WriteBytes(const void* pData, size_t size);
+
+    // Entities are written as indices into the table given to SetEntityIndices(), as handles aren't stable between
+    // registries. Entities which aren't in the table are written as null. Without a table, handles are written as they
+    // are, which is only meaningful when reading back into the same registry layout (see RegistrySnapshot).
+    void Write(entt::entity entity);
+    void SetEntityIndices(const std::unordered_map<entt::entity, uint32_t>* pEntityIndices) { m_pEntityIndices = pEntityIndices; }
+
+    size_t GetOffset() const { return m_Data.size(); }
+    const std::vector<uint8_t>& GetData() const { return m_Data; }
+    std::vector<uint8_t>& GetData() { return m_Data; }
+
+private:
+    template <Scalar T>
+    static void Store(uint8_t* pDestination, T value)
+    {
+        memcpy(pDestination, &value, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
+        {
+            for (size_t i = 0; i < sizeof(T) / 2; i++)
+            {
+                std::swap(pDestination[i], pDestination[sizeof(T) - 1 - i]);
+            }
+        }
+    }
+
+    void WriteFloats(const float* pValues, size_t count);
+
+    std::vector<uint8_t> m_Data;
+    const std::unordered_map<entt::entity, uint32_t>* m_pEntityIndices{ nullptr };
+};
+
+// Reads from a buffer owned by someone else. Reading past the end of the buffer returns default values and puts the
+// reader in a failed state, which is checked once after a batch of reads rather than after every value.
+class Reader
+{
+public:
+    Reader(std::span<const uint8_t> data)
+        : m_Data(data)
+    {
+    }
+
+    template <Scalar T>
+    T Read()
+    {
+        T value{};
+        if (Reserve(sizeof(T)))
+        {
+            memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+            if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
+            {
+                uint8_t* pBytes = reinterpret_cast<uint8_t*>(&value);
+                for (size_t i = 0; i < sizeof(T) / 2; i++)
+                {
+                    std::swap(pBytes[i], pBytes[sizeof(T) - 1 - i]);
+                }
+            }
+            m_Offset += sizeof(T);
+        }
+        return value;
+    }
+
+    bool ReadBool() { return Read<uint8_t>() != 0; }
+    glm::vec2 ReadVec2();
+    glm::vec3 ReadVec3();
+    glm::vec4 ReadVec4();
+    glm::quat ReadQuat();
+    glm::mat4 ReadMat4();
+    // The returned view points into the reader's buffer, so it is only valid for as long as the buffer is.
+    std::string_view ReadString();
+    bool ReadBytes(void* pData, size_t size);
+    void Skip(size_t size);
+
+    // Entities are read back through the table given to SetEntities(), see Writer::Write(entt::entity). Without a table,
+    // handles are read as they are.
+    entt::entity ReadEntity();
+    void SetEntities(std::span<const entt::entity> entities) { m_Entities = entities; }
+
+    bool IsValid() const { return !m_Failed; }
+    size_t GetOffset() const { return m_Offset; }
+    size_t GetRemaining() const { return m_Data.size() - m_Offset; }
+
+private:
+    bool Reserve(size_t size);
+    void ReadFloats(float* pValues, size_t count);
+
+    std::span<const uint8_t> m_Data;
+    std::span<const entt::entity> m_Entities;
+    size_t m_Offset{ 0 };
+    bool m_Failed{ false };
+};
+
+// Archives for entt::snapshot and entt::snapshot_loader. Entities are written as they are, and components through
+// their binary Serialize() and Deserialize() functions.
+class OutputArchive
+{
+public:
+    OutputArchive(Writer& writer)
+        : m_Writer(writer)
+    {
+    }
+
+    void operator()(std::underlying_type_t<entt::entity> value) { m_Writer.Write(value); }
+    void operator()(entt::entity entity) { m_Writer.Write(entity); }
+
+    template <typename T>
+    void operator()(const T& component)
+    {
+        component.Serialize(m_Writer);
+    }
+
+private:
+    Writer& m_Writer;
+};
+
+class InputArchive
+{
+public:
+    InputArchive(Reader& reader)
+        : m_Reader(reader)
+    {
+    }
+
+    void operator()(std::underlying_type_t<entt::entity>& value) { value = m_Reader.Read<std::underlying_type_t<entt::entity>>(); }
+    void operator()(entt::entity& entity) { entity = m_Reader.ReadEntity(); }
+
+    template <typename T>
+    void operator()(T& component)
+    {
+        component.Deserialize(m_Reader);
+    }
+
+private:
+    Reader& m_Reader;
+};
+
+} // namespace Binary
+} // namespace WingsOfSteel
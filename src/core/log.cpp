@@ -16,13 +16,22 @@
 // along with Genesis. If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef _WIN32
 #include "windows.h"
 #endif
 
+#include "core/binary_serialization.hpp"
 #include "core/debug_trap.hpp"
 #include "core/log.hpp"
+#include "core/mpsc_ring_buffer.hpp"
 
 namespace WingsOfSteel
 {
@@ -33,6 +42,90 @@ namespace WingsOfSteel
 
 std::mutex Log::m_Mutex;
 Log::LogTargetList Log::m_Targets;
+std::atomic<Log::Level> Log::m_Levels[static_cast<size_t>(Log::Category::Count)] = {
+    Log::Level::Info, Log::Level::Info, Log::Level::Info, Log::Level::Info, Log::Level::Info, Log::Level::Info
+};
+static_assert(static_cast<size_t>(Log::Category::Count) == 6, "Log::m_Levels must be initialized for every category.");
+
+#if defined(TARGET_PLATFORM_NATIVE)
+struct LogRecord
+{
+    std::string text;
+    Log::Level level{ Log::Level::Info };
+    bool binary{ false };
+};
+
+// How long the writer thread sleeps between batches when nothing asks it to wake up.
+static constexpr std::chrono::milliseconds sWriterInterval(10);
+
+struct AsyncLogState
+{
+    std::unique_ptr<MPSCRingBuffer<LogRecord>> pQueue;
+    Log::OverflowPolicy overflowPolicy{ Log::OverflowPolicy::Drop };
+    std::thread writerThread;
+    std::thread::id writerThreadId;
+    std::atomic<uint64_t> droppedMessages{ 0 };
+    uint64_t reportedDroppedMessages{ 0 }; // Only used by whichever thread drains the queue.
+
+    // Guarded by wakeMutex.
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable drainedCondition; // Notified after every batch, for flushes and producers waiting for space.
+    bool stop{ false };
+    bool spaceRequested{ false };
+    uint64_t drainCount{ 0 };
+    uint64_t flushRequested{ 0 };
+    uint64_t flushCompleted{ 0 };
+};
+
+// Never destroyed, as Log::Error() exits the program while the writer thread is still running.
+static AsyncLogState* sAsyncLogState = nullptr;
+static std::atomic<bool> sAsyncLogEnabled{ false };
+// Threads currently using the queue. StopAsync() waits for them before stopping the writer thread, so no record is
+// pushed after the final drain and no producer waits on a writer which is gone.
+static std::atomic<uint32_t> sAsyncLogProducers{ 0 };
+
+static bool IsAsyncLogEnabled()
+{
+    return sAsyncLogEnabled.load() && std::this_thread::get_id() != sAsyncLogState->writerThreadId;
+}
+
+// Registers the calling thread as a producer for its lifetime. The producer count is incremented before the enabled
+// flag is read, and StopAsync() clears the flag before reading the count: either the producer sees that
+// asynchronous logging is stopping and logs synchronously, or StopAsync() waits for it.
+class AsyncLogProducerScope
+{
+public:
+    AsyncLogProducerScope()
+    {
+        sAsyncLogProducers.fetch_add(1);
+        m_Enabled = IsAsyncLogEnabled();
+    }
+
+    ~AsyncLogProducerScope()
+    {
+        sAsyncLogProducers.fetch_sub(1);
+    }
+
+    bool IsEnabled() const { return m_Enabled; }
+
+private:
+    bool m_Enabled{ false };
+};
+
+// Binary log file layout: magic, version, then one record per message until the end of the file.
+// A record is: level (u8), category (u8), microseconds since the log was started (u64), arguments, End.
+// Values are stored in the host's byte order, which is little-endian on every platform we target.
+static constexpr uint32_t sBinaryLogMagic = 0x474F4C50; // "PLOG"
+static constexpr uint32_t sBinaryLogVersion = 1;
+
+// Guarded by Log::m_Mutex.
+static std::ofstream sBinaryLogFile;
+static std::atomic<bool> sBinaryLogEnabled{ false };
+static std::chrono::steady_clock::time_point sBinaryLogStartTime;
+// Incremented whenever literals previously sent may be missing from the file, so that every thread sends them again.
+static std::atomic<uint32_t> sBinaryLogLiteralGeneration{ 0 };
+#endif
 
 void Log::AddLogTarget(LogTargetSharedPtr pLogTarget)
 {
@@ -46,31 +139,401 @@ void Log::RemoveLogTarget(LogTargetSharedPtr pLogTarget)
     m_Targets.remove(pLogTarget);
 }
 
-Log::Stream Log::Info()
+void Log::SetLevel(Level level)
 {
-    return Log::Stream(Log::Level::Info);
+    for (auto& categoryLevel : m_Levels)
+    {
+        categoryLevel.store(level, std::memory_order_relaxed);
+    }
 }
 
-Log::Stream Log::Warning()
+void Log::SetLevel(Category category, Level level)
 {
-    return Log::Stream(Log::Level::Warning);
+    m_Levels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
 }
 
-Log::Stream Log::Error()
+const char* Log::GetCategoryName(Category category)
 {
-    return Log::Stream(Log::Level::Error);
+    static const char* sNames[static_cast<size_t>(Category::Count)] = { "General", "VFS", "Resources", "Render", "Physics", "Scene" };
+    return (category < Category::Count) ? sNames[static_cast<size_t>(category)] : "Unknown";
 }
 
-// Internal logging function. Should only be called by Log::Stream's destructor.
-void Log::LogInternal(const std::string& text, Log::Level level)
+void Log::StartAsync(size_t queueCapacity, OverflowPolicy overflowPolicy)
 {
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (sAsyncLogEnabled.load())
+    {
+        Log::Warning() << "Asynchronous logging has already been started.";
+        return;
+    }
+
+    if (sAsyncLogState == nullptr)
+    {
+        sAsyncLogState = new AsyncLogState();
+    }
+
+    sAsyncLogState->pQueue = std::make_unique<MPSCRingBuffer<LogRecord>>(queueCapacity);
+    sAsyncLogState->overflowPolicy = overflowPolicy;
+    sAsyncLogState->stop = false;
+    sAsyncLogState->spaceRequested = false;
+    sAsyncLogState->drainCount = 0;
+    sAsyncLogState->flushRequested = 0;
+    sAsyncLogState->flushCompleted = 0;
+    sAsyncLogState->writerThread = std::thread(&Log::WriterThreadMain);
+    sAsyncLogState->writerThreadId = sAsyncLogState->writerThread.get_id();
+    sAsyncLogEnabled.store(true, std::memory_order_release);
+#endif
+}
+
+void Log::StopAsync()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (!sAsyncLogEnabled.exchange(false))
+    {
+        return;
+    }
+
+    // New messages are now logged synchronously. Producers which were already using the queue are waited for while
+    // the writer thread is still running, as they may be blocked until it makes space.
+    while (sAsyncLogProducers.load() > 0)
+    {
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sAsyncLogState->wakeMutex);
+        sAsyncLogState->stop = true;
+    }
+    sAsyncLogState->wakeCondition.notify_one();
+    sAsyncLogState->writerThread.join();
+
     std::lock_guard<std::mutex> lock(m_Mutex);
+    if (DrainAsyncQueue())
+    {
+        FlushTargets();
+    }
+#endif
+}
+
+void Log::Flush()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    AsyncLogProducerScope producer;
+    if (producer.IsEnabled())
+    {
+        std::unique_lock<std::mutex> lock(sAsyncLogState->wakeMutex);
+        const uint64_t request = ++sAsyncLogState->flushRequested;
+        sAsyncLogState->wakeCondition.notify_one();
+        sAsyncLogState->drainedCondition.wait(lock, [request]() { return sAsyncLogState->flushCompleted >= request; });
+        return;
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    FlushTargets();
+}
+
+uint64_t Log::GetDroppedMessageCount()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    return sAsyncLogState ? sAsyncLogState->droppedMessages.load(std::memory_order_relaxed) : 0;
+#else
+    return 0;
+#endif
+}
+
+bool Log::StartBinaryLog(const std::filesystem::path& filePath)
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (sBinaryLogFile.is_open())
+        {
+            sBinaryLogFile.close();
+        }
+
+        sBinaryLogFile.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (sBinaryLogFile.is_open())
+        {
+            sBinaryLogFile.write(reinterpret_cast<const char*>(&sBinaryLogMagic), sizeof(sBinaryLogMagic));
+            sBinaryLogFile.write(reinterpret_cast<const char*>(&sBinaryLogVersion), sizeof(sBinaryLogVersion));
+            sBinaryLogStartTime = std::chrono::steady_clock::now();
+            sBinaryLogLiteralGeneration.fetch_add(1, std::memory_order_relaxed);
+            sBinaryLogEnabled.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+
+    Log::Warning() << "Failed to open binary log " << filePath << ".";
+    return false;
+#else
+    Log::Warning() << "Binary logging is not supported on this platform.";
+    return false;
+#endif
+}
+
+void Log::StopBinaryLog()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (!sBinaryLogEnabled.exchange(false))
+    {
+        return;
+    }
+
+    // Messages which were already queued are still written to the file.
+    Flush();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    sBinaryLogFile.close();
+#endif
+}
+
+bool Log::DecodeBinaryLog(std::span<const uint8_t> data, std::ostream& output)
+{
+    Binary::Reader reader(data);
+    if (reader.Read<uint32_t>() != sBinaryLogMagic || reader.Read<uint32_t>() != sBinaryLogVersion || !reader.IsValid())
+    {
+        return false;
+    }
+
+    static const char* sLevelNames[static_cast<size_t>(Level::Count)] = { "VERBOSE", "INFO", "WARNING", "ERROR" };
+    std::unordered_map<uint64_t, std::string_view> literals;
+    std::string text;
+    while (reader.GetRemaining() > 0)
+    {
+        const uint8_t level = reader.Read<uint8_t>();
+        const Category category = static_cast<Category>(reader.Read<uint8_t>());
+        const uint64_t timestamp = reader.Read<uint64_t>();
+
+        text.clear();
+        bool complete = false;
+        while (reader.IsValid() && !complete)
+        {
+            switch (static_cast<BinaryArgument>(reader.Read<uint8_t>()))
+            {
+            case BinaryArgument::End:
+                complete = true;
+                break;
+            case BinaryArgument::LiteralDefinition:
+            {
+                const uint64_t id = reader.Read<uint64_t>();
+                const std::string_view literal = reader.ReadString();
+                literals[id] = literal;
+                text += literal;
+                break;
+            }
+            case BinaryArgument::Literal:
+            {
+                auto it = literals.find(reader.Read<uint64_t>());
+                text += (it != literals.cend()) ? it->second : std::string_view("<unknown literal>");
+                break;
+            }
+            case BinaryArgument::String:
+                text += reader.ReadString();
+                break;
+            case BinaryArgument::Char:
+                text += reader.Read<char>();
+                break;
+            case BinaryArgument::Bool:
+                text += std::to_string(reader.Read<uint8_t>());
+                break;
+            case BinaryArgument::Int64:
+                text += std::to_string(reader.Read<int64_t>());
+                break;
+            case BinaryArgument::UInt64:
+                text += std::to_string(reader.Read<uint64_t>());
+                break;
+            case BinaryArgument::Double:
+            {
+                // Matches the default formatting of the text log.
+                std::ostringstream formatted;
+                formatted << reader.Read<double>();
+                text += formatted.str();
+                break;
+            }
+            default:
+                // Unknown argument type: the rest of the file can't be interpreted.
+                return true;
+            }
+        }
+
+        if (!complete)
+        {
+            // The file was cut short, e.g. by a crash while it was being written.
+            return true;
+        }
+
+        output << "[" << (timestamp / 1000000) << "." << std::setw(6) << std::setfill('0') << (timestamp % 1000000) << std::setfill(' ') << "] ";
+        output << "[" << ((level < static_cast<uint8_t>(Level::Count)) ? sLevelNames[level] : "?") << "] ";
+        if (category != Category::General)
+        {
+            output << "[" << GetCategoryName(category) << "] ";
+        }
+        output << text << '\n';
+    }
+    return true;
+}
+
+// Internal logging function. Should only be called by Log::Stream's destructor.
+void Log::LogInternal(std::string&& text, Log::Level level, bool binary)
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    AsyncLogProducerScope producer;
+    if (producer.IsEnabled())
+    {
+        // Errors are never dropped, as they are the last thing logged before aborting.
+        const bool block = (level == Log::Level::Error) || (sAsyncLogState->overflowPolicy == OverflowPolicy::Block);
+        LogRecord record{ std::move(text), level, binary };
+        while (!sAsyncLogState->pQueue->TryPush(std::move(record)))
+        {
+            if (!block)
+            {
+                sAsyncLogState->droppedMessages.fetch_add(1, std::memory_order_relaxed);
+                if (binary)
+                {
+                    // The dropped record may have been the one defining some literals.
+                    sBinaryLogLiteralGeneration.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            }
+
+            // Wakes the writer thread up and sleeps until it has drained the queue.
+            std::unique_lock<std::mutex> lock(sAsyncLogState->wakeMutex);
+            const uint64_t drainCount = sAsyncLogState->drainCount;
+            sAsyncLogState->spaceRequested = true;
+            sAsyncLogState->wakeCondition.notify_one();
+            sAsyncLogState->drainedCondition.wait(lock, [drainCount]() { return sAsyncLogState->drainCount != drainCount; });
+        }
+
+        if (level == Log::Level::Error)
+        {
+            Flush();
+            AbortOnError(level);
+        }
+        return;
+    }
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (binary)
+        {
+            WriteBinaryRecord(text);
+            return;
+        }
+
+        WriteToTargets(text, level);
+        FlushTargets();
+    }
+    AbortOnError(level);
+}
+
+// Must be called with m_Mutex locked.
+void Log::WriteToTargets(const std::string& text, Log::Level level)
+{
     for (auto& pTarget : m_Targets)
     {
         pTarget->Log(text, level);
     }
+}
 
-    AbortOnError(level);
+// Must be called with m_Mutex locked.
+void Log::WriteBinaryRecord(const std::string& record)
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (sBinaryLogFile.is_open())
+    {
+        sBinaryLogFile.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+#endif
+}
+
+// Must be called with m_Mutex locked.
+void Log::FlushTargets()
+{
+    for (auto& pTarget : m_Targets)
+    {
+        pTarget->Flush();
+    }
+
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (sBinaryLogFile.is_open())
+    {
+        sBinaryLogFile.flush();
+    }
+#endif
+}
+
+void Log::WriterThreadMain()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    while (true)
+    {
+        uint64_t flushRequested = 0;
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lock(sAsyncLogState->wakeMutex);
+            sAsyncLogState->wakeCondition.wait_for(lock, sWriterInterval, []() {
+                return sAsyncLogState->stop || sAsyncLogState->spaceRequested || sAsyncLogState->flushRequested > sAsyncLogState->flushCompleted;
+            });
+            flushRequested = sAsyncLogState->flushRequested;
+            stop = sAsyncLogState->stop;
+            sAsyncLogState->spaceRequested = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (DrainAsyncQueue())
+            {
+                FlushTargets();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sAsyncLogState->wakeMutex);
+            sAsyncLogState->flushCompleted = flushRequested;
+            sAsyncLogState->drainCount++;
+        }
+        sAsyncLogState->drainedCondition.notify_all();
+
+        if (stop)
+        {
+            return;
+        }
+    }
+#endif
+}
+
+// Must be called with m_Mutex locked, by the writer thread or once it has stopped. Returns true if anything was written.
+bool Log::DrainAsyncQueue()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    LogRecord record;
+    bool written = false;
+    while (sAsyncLogState->pQueue->TryPop(record))
+    {
+        if (record.binary)
+        {
+            WriteBinaryRecord(record.text);
+        }
+        else
+        {
+            WriteToTargets(record.text, record.level);
+        }
+        written = true;
+    }
+
+    const uint64_t droppedMessages = sAsyncLogState->droppedMessages.load(std::memory_order_relaxed);
+    if (droppedMessages != sAsyncLogState->reportedDroppedMessages)
+    {
+        WriteToTargets(std::to_string(droppedMessages - sAsyncLogState->reportedDroppedMessages) + " log messages were dropped, as the log queue was full.", Log::Level::Warning);
+        sAsyncLogState->reportedDroppedMessages = droppedMessages;
+        written = true;
+    }
+    return written;
+#else
+    return false;
+#endif
 }
 
 void Log::AbortOnError(Log::Level level)
@@ -88,14 +551,121 @@ void Log::AbortOnError(Log::Level level)
 // Log::Stream
 //////////////////////////////////////////////////////////////////////////
 
-Log::Stream::Stream(Log::Level level)
+static thread_local std::ostringstream tCollector;
+static thread_local bool tCollectorInUse = false;
+
+#if defined(TARGET_PLATFORM_NATIVE)
+static thread_local std::string tBinaryRecord;
+static thread_local bool tBinaryRecordInUse = false;
+// Ids of the literals this thread has already sent to the binary log.
+static thread_local std::unordered_set<uint64_t> tDefinedLiterals;
+static thread_local uint32_t tDefinedLiteralsGeneration = 0;
+#endif
+
+void Log::Stream::Begin()
 {
-    m_Level = level;
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (m_Level <= Level::Info && sBinaryLogEnabled.load(std::memory_order_acquire))
+    {
+        if (tBinaryRecordInUse)
+        {
+            m_pOwnedBinaryRecord = std::make_unique<std::string>();
+            m_pBinaryRecord = m_pOwnedBinaryRecord.get();
+        }
+        else
+        {
+            tBinaryRecord.clear();
+            tBinaryRecordInUse = true;
+            m_pBinaryRecord = &tBinaryRecord;
+        }
+
+        const uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sBinaryLogStartTime).count();
+        m_pBinaryRecord->push_back(static_cast<char>(m_Level));
+        m_pBinaryRecord->push_back(static_cast<char>(m_Category));
+        m_pBinaryRecord->append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+        return;
+    }
+#endif
+
+    if (tCollectorInUse)
+    {
+        m_pOwnedCollector = std::make_unique<std::ostringstream>();
+        m_pCollector = m_pOwnedCollector.get();
+    }
+    else
+    {
+        // Any formatting state left by the previous message is reset along with its text.
+        tCollector.str(std::string());
+        tCollector.clear();
+        tCollector.flags(std::ios_base::dec | std::ios_base::skipws);
+        tCollector.precision(6);
+        tCollector.fill(' ');
+        tCollectorInUse = true;
+        m_pCollector = &tCollector;
+    }
+
+    if (m_Category != Category::General)
+    {
+        *m_pCollector << "[" << GetCategoryName(m_Category) << "] ";
+    }
 }
 
-Log::Stream::~Stream()
+void Log::Stream::End()
 {
-    Log::LogInternal(m_Collector.str(), m_Level);
+#if defined(TARGET_PLATFORM_NATIVE)
+    if (m_pBinaryRecord)
+    {
+        m_pBinaryRecord->push_back(static_cast<char>(BinaryArgument::End));
+        std::string record(*m_pBinaryRecord);
+        if (!m_pOwnedBinaryRecord)
+        {
+            tBinaryRecordInUse = false;
+        }
+        Log::LogInternal(std::move(record), m_Level, true);
+        return;
+    }
+#endif
+
+    std::string text = m_pCollector->str();
+    if (!m_pOwnedCollector)
+    {
+        tCollectorInUse = false;
+    }
+    Log::LogInternal(std::move(text), m_Level, false);
+}
+
+void Log::Stream::AppendLiteral(const char* pLiteral)
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    const std::string_view literal(pLiteral);
+    const uint64_t id = Binary::SchemaHash(literal);
+
+    const uint32_t generation = sBinaryLogLiteralGeneration.load(std::memory_order_relaxed);
+    if (tDefinedLiteralsGeneration != generation)
+    {
+        tDefinedLiterals.clear();
+        tDefinedLiteralsGeneration = generation;
+    }
+
+    if (tDefinedLiterals.insert(id).second)
+    {
+        AppendArgument(BinaryArgument::LiteralDefinition, id);
+        const uint32_t size = static_cast<uint32_t>(literal.size());
+        m_pBinaryRecord->append(reinterpret_cast<const char*>(&size), sizeof(size));
+        m_pBinaryRecord->append(literal);
+    }
+    else
+    {
+        AppendArgument(BinaryArgument::Literal, id);
+    }
+#endif
+}
+
+void Log::Stream::AppendString(std::string_view value)
+{
+    const uint32_t size = static_cast<uint32_t>(value.size());
+    AppendArgument(BinaryArgument::String, size);
+    m_pBinaryRecord->append(value);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -105,7 +675,7 @@ Log::Stream::~Stream()
 
 const std::string& ILogTarget::GetPrefix(Log::Level level)
 {
-    static std::string prefixes[static_cast<size_t>(Log::Level::Count)] = { "[INFO] ", "[WARNING] ", "[ERROR] " };
+    static std::string prefixes[static_cast<size_t>(Log::Level::Count)] = { "[VERBOSE] ", "[INFO] ", "[WARNING] ", "[ERROR] " };
 
     return prefixes[static_cast<size_t>(level)];
 }
@@ -117,7 +687,12 @@ const std::string& ILogTarget::GetPrefix(Log::Level level)
 
 void StdOutLogger::Log(const std::string& text, Log::Level type)
 {
-    std::cout << GetPrefix(type) << text << std::endl;
+    std::cout << GetPrefix(type) << text << '\n';
+}
+
+void StdOutLogger::Flush()
+{
+    std::cout.flush();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -142,7 +717,14 @@ void FileLogger::Log(const std::string& text, Log::Level type)
 {
     if (m_File.is_open())
     {
-        m_File << GetPrefix(type) << text << std::endl;
+        m_File << GetPrefix(type) << text << '\n';
+    }
+}
+
+void FileLogger::Flush()
+{
+    if (m_File.is_open())
+    {
         m_File.flush();
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <codecvt>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -9,8 +11,11 @@
 #include <memory>
 #include <mutex>
 #include <regex>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace WingsOfSteel
 {
@@ -21,16 +26,24 @@ class ILogTarget;
 // Log
 // Contains any number of ILogTargets, which are responsible for actually
 // logging the message in various ways.
-// This class is thread safe.
+// This class is thread safe. By default the targets are called on the
+// logging thread; StartAsync() moves them to a background thread.
 //////////////////////////////////////////////////////////////////////////
 
 using LogTargetSharedPtr = std::shared_ptr<ILogTarget>;
 
+// Messages below this level are compiled out: their Stream is always disabled, so nothing is formatted.
+// 0 = Verbose, 1 = Info, 2 = Warning. Errors can't be compiled out.
+#ifndef PANDORA_LOG_MIN_LEVEL
+#define PANDORA_LOG_MIN_LEVEL 0
+#endif
+
 class Log
 {
 public:
-    enum class Level
+    enum class Level : uint8_t
     {
+        Verbose,
         Info,
         Warning,
         Error,
@@ -38,56 +51,231 @@ public:
         Count
     };
 
+    enum class Category : uint8_t
+    {
+        General,
+        VFS,
+        Resources,
+        Render,
+        Physics,
+        Scene,
+
+        Count
+    };
+
+    // Argument types in binary log records, see StartBinaryLog().
+    enum class BinaryArgument : uint8_t
+    {
+        End,
+        LiteralDefinition, // Id, followed by the literal's text. Sent the first time a thread logs a literal.
+        Literal, // Id of a literal previously defined by the same thread.
+        String,
+        Char,
+        Bool,
+        Int64,
+        UInt64,
+        Double
+    };
+
+    static constexpr Level sCompiledMinimumLevel = static_cast<Level>(PANDORA_LOG_MIN_LEVEL);
+
+    // Disabled streams (below the compiled or runtime level of their category) ignore everything written to them.
     class Stream
     {
     public:
-        Stream(Level level);
-        ~Stream();
+        Stream(Level level, Category category = Category::General)
+            : m_Level(level)
+            , m_Category(category)
+        {
+            if (IsEnabled(level, category))
+            {
+                Begin();
+            }
+        }
+
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+
+        ~Stream()
+        {
+            if (m_pCollector || m_pBinaryRecord)
+            {
+                End();
+            }
+        }
 
         template <typename T>
         Stream& operator<<(T const& value)
         {
-            m_Collector << value;
+            if (m_pBinaryRecord)
+            {
+                AppendBinary(value);
+            }
+            else if (m_pCollector)
+            {
+                *m_pCollector << value;
+            }
+            return *this;
+        }
+
+        // String literals are only sent once per thread to the binary log. Any other char array is treated the
+        // same way, as it can't be told apart from a literal.
+        template <size_t N>
+        Stream& operator<<(const char (&value)[N])
+        {
+            if (m_pBinaryRecord)
+            {
+                AppendLiteral(value);
+            }
+            else if (m_pCollector)
+            {
+                *m_pCollector << value;
+            }
             return *this;
         }
 
 #if defined(TARGET_PLATFORM_WINDOWS)
         Stream& operator<<(const std::filesystem::path& value)
         {
-            // Cleanup all the slashes and display them in Windows' standard format ('\').
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-            m_Collector << std::regex_replace(converter.to_bytes(value), std::regex("(\\\\|/)"), "\\");
+            if (m_pCollector || m_pBinaryRecord)
+            {
+                // Cleanup all the slashes and display them in Windows' standard format ('\').
+                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+                return *this << std::regex_replace(converter.to_bytes(value), std::regex("(\\\\|/)"), "\\");
+            }
             return *this;
         }
 
         Stream& operator<<(const std::wstring& value)
         {
-            std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-            m_Collector << converter.to_bytes(value);
+            if (m_pCollector || m_pBinaryRecord)
+            {
+                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+                return *this << converter.to_bytes(value);
+            }
             return *this;
         }
 #endif
 
     private:
+        void Begin();
+        void End();
+
+        template <typename T>
+        void AppendBinary(const T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                AppendArgument(BinaryArgument::Bool, static_cast<uint8_t>(value ? 1 : 0));
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                AppendArgument(BinaryArgument::Char, value);
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                AppendArgument(BinaryArgument::Int64, static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                AppendArgument(BinaryArgument::UInt64, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                AppendArgument(BinaryArgument::Double, static_cast<double>(value));
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                AppendString(value);
+            }
+            else
+            {
+                std::ostringstream formatted;
+                formatted << value;
+                AppendString(formatted.str());
+            }
+        }
+
+        template <typename T>
+        void AppendArgument(BinaryArgument type, T value)
+        {
+            m_pBinaryRecord->push_back(static_cast<char>(type));
+            m_pBinaryRecord->append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void AppendLiteral(const char* pLiteral);
+        void AppendString(std::string_view value);
+
         Level m_Level;
-        std::ostringstream m_Collector;
+        Category m_Category;
+        // Messages are formatted into a stream which is reused by every message on the thread. A message
+        // logged while formatting another (e.g. from an operator<<) gets its own stream.
+        std::ostringstream* m_pCollector{ nullptr };
+        std::unique_ptr<std::ostringstream> m_pOwnedCollector;
+        // Set instead of the collector when the message is recorded in the binary log.
+        std::string* m_pBinaryRecord{ nullptr };
+        std::unique_ptr<std::string> m_pOwnedBinaryRecord;
+    };
+
+    enum class OverflowPolicy
+    {
+        Drop, // Messages logged while the queue is full are discarded and counted.
+        Block // The logging thread waits for the writer thread to make room.
     };
 
-    static Stream Info();
-    static Stream Warning();
-    static Stream Error();
+    static Stream Verbose(Category category = Category::General) { return Stream(Level::Verbose, category); }
+    static Stream Info(Category category = Category::General) { return Stream(Level::Info, category); }
+    static Stream Warning(Category category = Category::General) { return Stream(Level::Warning, category); }
+    static Stream Error(Category category = Category::General) { return Stream(Level::Error, category); }
+
+    // Runtime thresholds, by default Info for every category. Setting the level of all categories at once
+    // overrides any per-category level.
+    static void SetLevel(Level level);
+    static void SetLevel(Category category, Level level);
+    static Level GetLevel(Category category) { return m_Levels[static_cast<size_t>(category)].load(std::memory_order_relaxed); }
+    static bool IsEnabled(Level level, Category category)
+    {
+        return level == Level::Error || (level >= sCompiledMinimumLevel && level >= GetLevel(category));
+    }
+    static const char* GetCategoryName(Category category);
 
     static void AddLogTarget(LogTargetSharedPtr pLogTarget);
     static void RemoveLogTarget(LogTargetSharedPtr pLogTarget);
 
+    // Messages are queued in a lock-free ring buffer and written to the targets in batches by a background thread,
+    // so logging never waits on I/O. Errors are always written and flushed before the program aborts.
+    // Native only: on web, logging stays synchronous.
+    static void StartAsync(size_t queueCapacity = 8192, OverflowPolicy overflowPolicy = OverflowPolicy::Drop);
+    // Writes any queued messages, then stops the background thread.
+    static void StopAsync();
+    // Blocks until every message logged so far has been written and the targets flushed.
+    static void Flush();
+    static uint64_t GetDroppedMessageCount();
+
+    // Verbose and Info messages are written to the given file as binary records instead of being formatted: literals
+    // are sent once per thread and then referred to by id, and other arguments are stored raw. This makes verbose
+    // logging cheap enough to leave on in production. Warnings and errors are still written to the targets as text.
+    // Native only. Files are turned back into text with DecodeBinaryLog(), or with the pandora_logdecode tool.
+    static bool StartBinaryLog(const std::filesystem::path& filePath);
+    static void StopBinaryLog();
+    // Returns false if the data isn't a binary log. A log cut short (e.g. by a crash) is decoded up to its last
+    // complete record.
+    static bool DecodeBinaryLog(std::span<const uint8_t> data, std::ostream& output);
+
 private:
     using LogTargetList = std::list<LogTargetSharedPtr>;
 
-    static void LogInternal(const std::string& text, Log::Level level);
+    static void LogInternal(std::string&& text, Log::Level level, bool binary);
+    static void WriteToTargets(const std::string& text, Log::Level level);
+    static void WriteBinaryRecord(const std::string& record);
+    static void FlushTargets();
+    static void WriterThreadMain();
+    static bool DrainAsyncQueue();
     static void AbortOnError(Log::Level level);
 
     static std::mutex m_Mutex;
     static LogTargetList m_Targets;
+    static std::atomic<Level> m_Levels[static_cast<size_t>(Category::Count)];
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -100,6 +288,8 @@ class ILogTarget
 public:
     virtual ~ILogTarget() {}
     virtual void Log(const std::string& text, Log::Level level) = 0;
+    // Called after each batch of messages, rather than after every message.
+    virtual void Flush() {}
 
 protected:
     static const std::string& GetPrefix(Log::Level level);
@@ -114,12 +304,13 @@ class StdOutLogger : public ILogTarget
 {
 public:
     virtual void Log(const std::string& text, Log::Level type) override;
+    virtual void Flush() override;
 };
 
 //////////////////////////////////////////////////////////////////////////
 // FileLogger - Native only
 // Dumps the logging into file given in "filename". It is flushed
-// after every entry.
+// after every batch of entries.
 //////////////////////////////////////////////////////////////////////////
 
 #if defined(TARGET_PLATFORM_NATIVE)
@@ -129,6 +320,7 @@ public:
     FileLogger(const std::filesystem::path& filePath);
     virtual ~FileLogger() override;
     virtual void Log(const std::string& text, Log::Level type) override;
+    virtual void Flush() override;
 
 private:
     std::ofstream m_File;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace WingsOfSteel
+{
+
+// Bounded lock-free queue for any number of producers and a single consumer, based on Dmitry Vyukov's bounded
+// MPMC queue. Each cell carries a sequence number which tells producers and the consumer whether it is free or full,
+// so the only contended operation is the producers' increment of the enqueue position.
+// The capacity is rounded up to a power of two.
+template <typename T>
+class MPSCRingBuffer
+{
+public:
+    explicit MPSCRingBuffer(size_t capacity)
+    {
+        const size_t cellCount = std::bit_ceil(capacity < 2 ? size_t(2) : capacity);
+        m_pCells = std::make_unique<Cell[]>(cellCount);
+        m_Mask = cellCount - 1;
+        for (size_t i = 0; i < cellCount; i++)
+        {
+            m_pCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false if the buffer is full, in which case value is left untouched.
+    bool TryPush(T&& value)
+    {
+        Cell* pCell = nullptr;
+        size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            pCell = &m_pCells[position & m_Mask];
+            const size_t sequence = pCell->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_EnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        pCell->value = std::move(value);
+        pCell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Must only be called from the consumer thread. Returns false if the buffer is empty.
+    bool TryPop(T& value)
+    {
+        Cell& cell = m_pCells[m_DequeuePosition & m_Mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != m_DequeuePosition + 1)
+        {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        cell.sequence.store(m_DequeuePosition + m_Mask + 1, std::memory_order_release);
+        m_DequeuePosition++;
+        return true;
+    }
+
+    size_t GetCapacity() const { return m_Mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_pCells;
+    size_t m_Mask{ 0 };
+    // Kept on separate cache lines, as they are written by different threads.
+    alignas(64) std::atomic<size_t> m_EnqueuePosition{ 0 };
+    alignas(64) size_t m_DequeuePosition{ 0 };
+};
+
+} // namespace WingsOfSteel
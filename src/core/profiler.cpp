@@ -0,0 +1,238 @@
+#include "core/profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace WingsOfSteel
+{
+
+// Zones each thread can record between two calls to Profiler::EndFrame(). Must be a power of two.
+static constexpr uint64_t sThreadBufferSize = 1 << 14;
+
+// Zones are written by the thread which owns the buffer and read by the main thread at the end of the frame.
+// The owning thread publishes each zone by incrementing the write position, so the main thread never reads a zone
+// which is still being written, unless the owning thread has gone all the way around the buffer since the last
+// frame. Those zones are detected after being read and discarded.
+struct ProfilerThreadBuffer
+{
+    ProfilerThreadBuffer(uint32_t index)
+        : index(index)
+        , zones(sThreadBufferSize)
+    {
+    }
+
+    uint32_t index;
+    std::string name; // Guarded by sThreadBuffersMutex.
+    std::vector<ProfilerZone> zones;
+    std::atomic<uint64_t> writePosition{ 0 };
+    uint64_t readPosition{ 0 }; // Main thread only.
+    uint32_t depth{ 0 }; // Owning thread only.
+};
+
+std::atomic<bool> Profiler::m_Enabled{ false };
+
+static const std::chrono::steady_clock::time_point sStartTime = std::chrono::steady_clock::now();
+
+// Buffers are never destroyed, as zones recorded by a thread which has since exited are still collected.
+static std::mutex sThreadBuffersMutex;
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> sThreadBuffers;
+static thread_local ProfilerThreadBuffer* tThreadBuffer = nullptr;
+
+// Main thread only.
+static std::deque<ProfilerFrame> sFrameHistory;
+static uint64_t sFrameStart = 0;
+static bool sPaused = false;
+
+static ProfilerThreadBuffer* GetThreadBuffer()
+{
+    if (tThreadBuffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(sThreadBuffersMutex);
+        const uint32_t index = static_cast<uint32_t>(sThreadBuffers.size());
+        sThreadBuffers.push_back(std::make_unique<ProfilerThreadBuffer>(index));
+        sThreadBuffers.back()->name = "Thread " + std::to_string(index);
+        tThreadBuffer = sThreadBuffers.back().get();
+    }
+    return tThreadBuffer;
+}
+
+void Profiler::Scope::Begin(std::string_view name)
+{
+    GetThreadBuffer()->depth++;
+    m_Name = name;
+    m_Active = true;
+    m_Start = GetTime();
+}
+
+void Profiler::Scope::End()
+{
+    const uint64_t end = GetTime();
+    ProfilerThreadBuffer* pBuffer = GetThreadBuffer();
+    const uint32_t depth = --pBuffer->depth;
+    const uint64_t position = pBuffer->writePosition.load(std::memory_order_relaxed);
+    ProfilerZone& zone = pBuffer->zones[position & (sThreadBufferSize - 1)];
+    zone.name = m_Name;
+    zone.start = m_Start;
+    zone.end = end;
+    zone.thread = pBuffer->index;
+    zone.depth = depth;
+    pBuffer->writePosition.store(position + 1, std::memory_order_release);
+}
+
+void Profiler::SetPaused(bool paused)
+{
+    sPaused = paused;
+}
+
+bool Profiler::IsPaused()
+{
+    return sPaused;
+}
+
+void Profiler::BeginFrame()
+{
+    sFrameStart = GetTime();
+}
+
+void Profiler::EndFrame()
+{
+    ProfilerFrame frame;
+    frame.start = sFrameStart;
+    frame.end = GetTime();
+
+    {
+        std::lock_guard<std::mutex> lock(sThreadBuffersMutex);
+        for (auto& pBuffer : sThreadBuffers)
+        {
+            const uint64_t writePosition = pBuffer->writePosition.load(std::memory_order_acquire);
+            uint64_t readPosition = pBuffer->readPosition;
+            if (writePosition - readPosition > sThreadBufferSize)
+            {
+                frame.droppedZones += static_cast<uint32_t>(writePosition - readPosition - sThreadBufferSize);
+                readPosition = writePosition - sThreadBufferSize;
+            }
+
+            const size_t firstZone = frame.zones.size();
+            for (uint64_t position = readPosition; position < writePosition; position++)
+            {
+                frame.zones.push_back(pBuffer->zones[position & (sThreadBufferSize - 1)]);
+            }
+
+            // Discard any zone the owning thread may have overwritten while it was being copied.
+            const uint64_t overwrittenEnd = pBuffer->writePosition.load(std::memory_order_acquire) + 1;
+            if (overwrittenEnd - readPosition > sThreadBufferSize)
+            {
+                const size_t overwritten = std::min<size_t>(overwrittenEnd - readPosition - sThreadBufferSize, writePosition - readPosition);
+                frame.zones.erase(frame.zones.begin() + firstZone, frame.zones.begin() + firstZone + overwritten);
+                frame.droppedZones += static_cast<uint32_t>(overwritten);
+            }
+
+            pBuffer->readPosition = writePosition;
+        }
+    }
+
+    if (sPaused)
+    {
+        return;
+    }
+
+    std::sort(frame.zones.begin(), frame.zones.end(), [](const ProfilerZone& a, const ProfilerZone& b) {
+        return (a.thread != b.thread) ? (a.thread < b.thread) : (a.start < b.start);
+    });
+
+    sFrameHistory.push_back(std::move(frame));
+    if (sFrameHistory.size() > sFrameHistorySize)
+    {
+        sFrameHistory.pop_front();
+    }
+}
+
+void Profiler::SetThreadName(std::string_view name)
+{
+    ProfilerThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(sThreadBuffersMutex);
+    pBuffer->name = name;
+}
+
+std::vector<std::string> Profiler::GetThreadNames()
+{
+    std::lock_guard<std::mutex> lock(sThreadBuffersMutex);
+    std::vector<std::string> names;
+    names.reserve(sThreadBuffers.size());
+    for (auto& pBuffer : sThreadBuffers)
+    {
+        names.push_back(pBuffer->name);
+    }
+    return names;
+}
+
+const std::deque<ProfilerFrame>& Profiler::GetFrameHistory()
+{
+    return sFrameHistory;
+}
+
+void Profiler::ClearFrameHistory()
+{
+    sFrameHistory.clear();
+}
+
+static void WriteJsonString(std::ostream& output, std::string_view text)
+{
+    output << '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            output << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            output << ' ';
+        }
+        else
+        {
+            output << c;
+        }
+    }
+    output << '"';
+}
+
+void Profiler::WriteChromeTrace(std::ostream& output)
+{
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    const std::vector<std::string> threadNames = GetThreadNames();
+    bool first = true;
+    for (size_t i = 0; i < threadNames.size(); i++)
+    {
+        output << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":";
+        WriteJsonString(output, threadNames[i]);
+        output << "}}";
+        first = false;
+    }
+
+    // Timestamps are in microseconds.
+    output.setf(std::ios::fixed);
+    output.precision(3);
+    for (const ProfilerFrame& frame : sFrameHistory)
+    {
+        for (const ProfilerZone& zone : frame.zones)
+        {
+            output << (first ? "\n" : ",\n") << "{\"name\":";
+            WriteJsonString(output, zone.name);
+            output << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.thread << ",\"ts\":" << (zone.start / 1000.0) << ",\"dur\":" << ((zone.end - zone.start) / 1000.0) << "}";
+            first = false;
+        }
+    }
+
+    output << "\n]}\n";
+}
+
+uint64_t Profiler::GetTime()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sStartTime).count());
+}
+
+} // namespace WingsOfSteel
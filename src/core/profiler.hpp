@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WingsOfSteel
+{
+
+struct ProfilerZone
+{
+    std::string_view name; // Must outlive the profiler's frame history, e.g. a string literal or a type name.
+    uint64_t start{ 0 }; // Nanoseconds since the profiler was started.
+    uint64_t end{ 0 };
+    uint32_t thread{ 0 }; // Index into Profiler::GetThreadNames().
+    uint32_t depth{ 0 }; // Number of zones the zone is nested in, on its thread.
+};
+
+struct ProfilerFrame
+{
+    uint64_t start{ 0 };
+    uint64_t end{ 0 };
+    // Every zone which ended during the frame, sorted by thread then start time.
+    std::vector<ProfilerZone> zones;
+    // Number of zones which were lost because a thread recorded more zones than its buffer holds during the frame.
+    uint32_t droppedZones{ 0 };
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Profiler
+// Scoped CPU zones, recorded by any thread into a lock-free buffer owned by
+// that thread. Once per frame, the main thread collects the zones from
+// every buffer into the frame history, which is shown by the profiler
+// window and can be exported to the Chrome trace format.
+// Zones are timed with steady_clock. While the profiler is disabled, a
+// zone costs a single relaxed load.
+//////////////////////////////////////////////////////////////////////////
+
+class Profiler
+{
+public:
+    class Scope
+    {
+    public:
+        Scope(std::string_view name)
+        {
+            if (IsEnabled())
+            {
+                Begin(name);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            if (m_Active)
+            {
+                End();
+            }
+        }
+
+    private:
+        void Begin(std::string_view name);
+        void End();
+
+        std::string_view m_Name;
+        uint64_t m_Start{ 0 };
+        bool m_Active{ false };
+    };
+
+    static void SetEnabled(bool enabled) { m_Enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return m_Enabled.load(std::memory_order_relaxed); }
+
+    // While paused, zones are still recorded but frames are no longer added to the history, so it can be inspected.
+    static void SetPaused(bool paused);
+    static bool IsPaused();
+
+    // Called by the engine at the start and end of every frame, on the main thread.
+    static void BeginFrame();
+    static void EndFrame();
+
+    // Names the calling thread in the profiler window and in exported traces.
+    static void SetThreadName(std::string_view name);
+    static std::vector<std::string> GetThreadNames();
+
+    // Oldest frame first. Must only be used on the main thread.
+    static const std::deque<ProfilerFrame>& GetFrameHistory();
+    static void ClearFrameHistory();
+
+    // Writes the frame history in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto.
+    static void WriteChromeTrace(std::ostream& output);
+
+    static uint64_t GetTime();
+
+    static constexpr size_t sFrameHistorySize = 300;
+
+private:
+    static std::atomic<bool> m_Enabled;
+};
+
+} // namespace WingsOfSteel
+
+#define PROFILE_SCOPE_CONCAT_INTERNAL(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_INTERNAL(a, b)
+
+#if defined(PANDORA_PROFILER_DISABLED)
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_SCOPE(name) ::WingsOfSteel::Profiler::Scope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(name)
+#endif
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
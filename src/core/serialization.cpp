@@ -1,5 +1,7 @@
 #include "core/serialization.hpp"
 
+#include <algorithm>
+
 #include <magic_enum.hpp>
 
 #include "core/log.hpp"
@@ -8,10 +10,9 @@
 namespace WingsOfSteel::Json
 {
 
-void DefaultErrorHandler(const ResourceDataStore* pContext, const std::string& key, DeserializationError error, const std::string& expectedType)
+void DefaultErrorHandler(const ResourceDataStore* pContext, std::string_view key, DeserializationError error, const char* expectedType)
 {
-    const std::string contextPath = pContext ? pContext->GetPath() : "<no context>";
-
+    const std::string_view contextPath = GetContextPath(pContext);
     if (error == DeserializationError::KeyNotFound)
     {
         Log::Error() << contextPath << ": failed to find key '" << key << "'.";
@@ -26,49 +27,60 @@ void DefaultErrorHandler(const ResourceDataStore* pContext, const std::string& k
     }
 }
 
-Result<DeserializationError, const Data> DeserializeArray(const ResourceDataStore* pContext, const Data& data, const std::string& key)
+Result<DeserializationError, DataRef> DeserializeArray(const ResourceDataStore* pContext, const Data& data, std::string_view key)
 {
-    const std::string contextPath = pContext ? pContext->GetPath() : "<no context>";
-
     auto it = data.find(key);
     if (it == data.cend())
     {
-        Log::Warning() << contextPath << ": failed to find key '" << key << "'.";
-        return Result<DeserializationError, const Data>(DeserializationError::KeyNotFound);
+        Log::Warning() << GetContextPath(pContext) << ": failed to find key '" << key << "'.";
+        return Result<DeserializationError, DataRef>(DeserializationError::KeyNotFound);
     }
     else if (!it->is_array())
     {
-        Log::Warning() << contextPath << ": key '" << key << "' is not an array.";
-        return Result<DeserializationError, const Data>(DeserializationError::TypeMismatch);
+        Log::Warning() << GetContextPath(pContext) << ": key '" << key << "' is not an array.";
+        return Result<DeserializationError, DataRef>(DeserializationError::TypeMismatch);
     }
     else
     {
-        return Result<DeserializationError, const Data>(*it);
+        return Result<DeserializationError, DataRef>(std::cref(*it));
     }
 }
 
-Result<DeserializationError, const Data> DeserializeObject(const ResourceDataStore* pContext, const Data& data, const std::string& key)
+Result<DeserializationError, DataRef> DeserializeObject(const ResourceDataStore* pContext, const Data& data, std::string_view key)
 {
-    const std::string contextPath = pContext ? pContext->GetPath() : "<no context>";
-
     auto it = data.find(key);
     if (it == data.cend())
     {
-        Log::Warning() << contextPath << ": failed to find key '" << key << "'.";
-        return Result<DeserializationError, const Data>(DeserializationError::KeyNotFound);
+        Log::Warning() << GetContextPath(pContext) << ": failed to find key '" << key << "'.";
+        return Result<DeserializationError, DataRef>(DeserializationError::KeyNotFound);
     }
     else if (!it->is_object())
     {
-        Log::Warning() << contextPath << ": key '" << key << "' is not an object.";
-        return Result<DeserializationError, const Data>(DeserializationError::TypeMismatch);
+        Log::Warning() << GetContextPath(pContext) << ": key '" << key << "' is not an object.";
+        return Result<DeserializationError, DataRef>(DeserializationError::TypeMismatch);
     }
     else
     {
-        return Result<DeserializationError, const Data>(*it);
+        return Result<DeserializationError, DataRef>(std::cref(*it));
     }
 }
 
-std::string DeserializeString(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<std::string> defaultValue /* = std::nullopt */)
+Data ParseFiltered(std::string_view text, std::span<const std::string_view> keys)
+{
+    // Returning false from the callback for a top-level key makes the parser skip its value entirely.
+    Data::parser_callback_t callback = [keys](int depth, Data::parse_event_t event, Data& parsed) -> bool {
+        if (depth == 1 && event == Data::parse_event_t::key)
+        {
+            const std::string& key = parsed.get_ref<const std::string&>();
+            return std::find(keys.begin(), keys.end(), key) != keys.end();
+        }
+        return true;
+    };
+
+    return Data::parse(text.begin(), text.end(), callback, false);
+}
+
+std::string DeserializeString(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<std::string> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeString(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -82,7 +94,7 @@ std::string DeserializeString(const ResourceDataStore* pContext, const Data& dat
     }
 }
 
-Result<DeserializationError, std::string> TryDeserializeString(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<std::string> defaultValue /* = std::nullopt */)
+Result<DeserializationError, std::string> TryDeserializeString(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<std::string> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -102,12 +114,11 @@ Result<DeserializationError, std::string> TryDeserializeString(const ResourceDat
     }
     else
     {
-        const std::string value = it->get<std::string>();
-        return Result<DeserializationError, std::string>(value);
+        return Result<DeserializationError, std::string>(it->get_ref<const std::string&>());
     }
 }
 
-uint32_t DeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<uint32_t> defaultValue /* = std::nullopt */)
+uint32_t DeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<uint32_t> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeUnsignedInteger(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -121,7 +132,7 @@ uint32_t DeserializeUnsignedInteger(const ResourceDataStore* pContext, const Dat
     }
 }
 
-Result<DeserializationError, uint32_t> TryDeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<uint32_t> defaultValue /* = std::nullopt */)
+Result<DeserializationError, uint32_t> TryDeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<uint32_t> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -146,7 +157,7 @@ Result<DeserializationError, uint32_t> TryDeserializeUnsignedInteger(const Resou
     }
 }
 
-int32_t DeserializeInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<int32_t> defaultValue /* = std::nullopt */)
+int32_t DeserializeInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<int32_t> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeInteger(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -160,7 +171,7 @@ int32_t DeserializeInteger(const ResourceDataStore* pContext, const Data& data,
     }
 }
 
-Result<DeserializationError, int32_t> TryDeserializeInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<int32_t> defaultValue /* = std::nullopt */)
+Result<DeserializationError, int32_t> TryDeserializeInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<int32_t> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -185,7 +196,7 @@ Result<DeserializationError, int32_t> TryDeserializeInteger(const ResourceDataSt
     }
 }
 
-float DeserializeFloat(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<float> defaultValue /* = std::nullopt */)
+float DeserializeFloat(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<float> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeFloat(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -199,7 +210,7 @@ float DeserializeFloat(const ResourceDataStore* pContext, const Data& data, cons
     }
 }
 
-Result<DeserializationError, float> TryDeserializeFloat(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<float> defaultValue /* = std::nullopt */)
+Result<DeserializationError, float> TryDeserializeFloat(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<float> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -224,7 +235,7 @@ Result<DeserializationError, float> TryDeserializeFloat(const ResourceDataStore*
     }
 }
 
-bool DeserializeBool(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<bool> defaultValue /* = std::nullopt */)
+bool DeserializeBool(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<bool> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeBool(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -238,7 +249,7 @@ bool DeserializeBool(const ResourceDataStore* pContext, const Data& data, const
     }
 }
 
-Result<DeserializationError, bool> TryDeserializeBool(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<bool> defaultValue /* = std::nullopt */)
+Result<DeserializationError, bool> TryDeserializeBool(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<bool> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -263,7 +274,7 @@ Result<DeserializationError, bool> TryDeserializeBool(const ResourceDataStore* p
     }
 }
 
-glm::vec2 DeserializeVec2(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec2> defaultValue /* = std::nullopt */)
+glm::vec2 DeserializeVec2(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec2> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeVec2(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -277,7 +288,7 @@ glm::vec2 DeserializeVec2(const ResourceDataStore* pContext, const Data& data, c
     }
 }
 
-Result<DeserializationError, glm::vec2> TryDeserializeVec2(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec2> defaultValue /* = std::nullopt */)
+Result<DeserializationError, glm::vec2> TryDeserializeVec2(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec2> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -302,7 +313,7 @@ Result<DeserializationError, glm::vec2> TryDeserializeVec2(const ResourceDataSto
     }
 }
 
-glm::vec3 DeserializeVec3(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec3> defaultValue /* = std::nullopt */)
+glm::vec3 DeserializeVec3(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec3> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeVec3(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -316,7 +327,7 @@ glm::vec3 DeserializeVec3(const ResourceDataStore* pContext, const Data& data, c
     }
 }
 
-Result<DeserializationError, glm::vec3> TryDeserializeVec3(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec3> defaultValue /* = std::nullopt */)
+Result<DeserializationError, glm::vec3> TryDeserializeVec3(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec3> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -341,7 +352,7 @@ Result<DeserializationError, glm::vec3> TryDeserializeVec3(const ResourceDataSto
     }
 }
 
-glm::vec4 DeserializeVec4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec4> defaultValue /* = std::nullopt */)
+glm::vec4 DeserializeVec4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec4> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeVec4(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -355,7 +366,7 @@ glm::vec4 DeserializeVec4(const ResourceDataStore* pContext, const Data& data, c
     }
 }
 
-Result<DeserializationError, glm::vec4> TryDeserializeVec4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec4> defaultValue /* = std::nullopt */)
+Result<DeserializationError, glm::vec4> TryDeserializeVec4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec4> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -380,7 +391,7 @@ Result<DeserializationError, glm::vec4> TryDeserializeVec4(const ResourceDataSto
     }
 }
 
-glm::mat4 DeserializeMat4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::mat4> defaultValue /* = std::nullopt */)
+glm::mat4 DeserializeMat4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::mat4> defaultValue /* = std::nullopt */)
 {
     auto result = TryDeserializeMat4(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -394,7 +405,7 @@ glm::mat4 DeserializeMat4(const ResourceDataStore* pContext, const Data& data, c
     }
 }
 
-Result<DeserializationError, glm::mat4> TryDeserializeMat4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::mat4> defaultValue /* = std::nullopt */)
+Result<DeserializationError, glm::mat4> TryDeserializeMat4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::mat4> defaultValue /* = std::nullopt */)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -427,4 +438,64 @@ Result<DeserializationError, glm::mat4> TryDeserializeMat4(const ResourceDataSto
     }
 }
 
+// The table is per thread, so entities can be loaded on several threads at once.
+static thread_local std::span<const entt::entity> tEntityTable;
+
+EntityTableScope::EntityTableScope(std::span<const entt::entity> entities)
+    : m_PreviousEntities(tEntityTable)
+{
+    tEntityTable = entities;
+}
+
+EntityTableScope::~EntityTableScope()
+{
+    tEntityTable = m_PreviousEntities;
+}
+
+entt::entity DeserializeEntity(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<entt::entity> defaultValue /* = std::nullopt */)
+{
+    auto result = TryDeserializeEntity(pContext, data, key, defaultValue);
+    if (result.has_value())
+    {
+        return result.value();
+    }
+    else
+    {
+        DefaultErrorHandler(pContext, key, result.error(), "entity index");
+        return entt::null;
+    }
+}
+
+Result<DeserializationError, entt::entity> TryDeserializeEntity(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<entt::entity> defaultValue /* = std::nullopt */)
+{
+    auto it = data.find(key);
+    if (it == data.cend())
+    {
+        if (defaultValue.has_value())
+        {
+            return Result<DeserializationError, entt::entity>(defaultValue.value());
+        }
+        else
+        {
+            return Result<DeserializationError, entt::entity>(DeserializationError::KeyNotFound);
+        }
+    }
+    else if (!it->is_number_unsigned())
+    {
+        return Result<DeserializationError, entt::entity>(DeserializationError::TypeMismatch);
+    }
+
+    const uint32_t index = it->get<uint32_t>();
+    if (tEntityTable.empty())
+    {
+        return Result<DeserializationError, entt::entity>(entt::entity{ index });
+    }
+    else if (index >= tEntityTable.size())
+    {
+        Log::Warning() << GetContextPath(pContext) << ": key '" << key << "' refers to entity " << index << ", but only " << tEntityTable.size() << " entities are being loaded.";
+        return Result<DeserializationError, entt::entity>(entt::entity{ entt::null });
+    }
+    return Result<DeserializationError, entt::entity>(tEntityTable[index]);
+}
+
 } // namespace WingsOfSteel
\ No newline at end of file
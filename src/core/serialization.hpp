@@ -1,8 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
+#include <entt/entity/entity.hpp>
 #include <nlohmann/json.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
@@ -22,6 +26,11 @@ namespace Json
 {
 
 using Data = nlohmann::json;
+// Reference to part of a larger document, so looking up an array or object doesn't copy it.
+using DataRef = std::reference_wrapper<const Data>;
+
+// Keys are looked up as std::string_view, which nlohmann::json compares against its keys without allocating,
+// so passing a string literal doesn't create a temporary std::string. Error messages are only built on failure.
 
 enum class DeserializationError
 {
@@ -29,41 +38,68 @@ enum class DeserializationError
     TypeMismatch
 };
 
-Result<DeserializationError, const Data> DeserializeArray(const ResourceDataStore* pContext, const Data& data, const std::string& key);
-Result<DeserializationError, const Data> DeserializeObject(const ResourceDataStore* pContext, const Data& data, const std::string& key);
+Result<DeserializationError, DataRef> DeserializeArray(const ResourceDataStore* pContext, const Data& data, std::string_view key);
+Result<DeserializationError, DataRef> DeserializeObject(const ResourceDataStore* pContext, const Data& data, std::string_view key);
+
+// Parses a JSON object but only keeps the given top-level keys. Everything else is skipped by the parser rather than
+// built and then thrown away, which is much cheaper when only part of a large data store is needed.
+// Returns a discarded value (see Data::is_discarded()) if the text isn't valid JSON.
+Data ParseFiltered(std::string_view text, std::span<const std::string_view> keys);
+
+// Path of the data store, for error messages.
+inline std::string_view GetContextPath(const ResourceDataStore* pContext)
+{
+    return pContext ? std::string_view(pContext->GetPath()) : std::string_view("<no context>");
+}
 
-std::string DeserializeString(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<std::string> defaultValue = std::nullopt);
-Result<DeserializationError, std::string> TryDeserializeString(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<std::string> defaultValue = std::nullopt);
+std::string DeserializeString(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<std::string> defaultValue = std::nullopt);
+Result<DeserializationError, std::string> TryDeserializeString(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<std::string> defaultValue = std::nullopt);
 
-uint32_t DeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<uint32_t> defaultValue = std::nullopt);
-Result<DeserializationError, uint32_t> TryDeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<uint32_t> defaultValue = std::nullopt);
+uint32_t DeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<uint32_t> defaultValue = std::nullopt);
+Result<DeserializationError, uint32_t> TryDeserializeUnsignedInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<uint32_t> defaultValue = std::nullopt);
 
-int32_t DeserializeInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<int32_t> defaultValue = std::nullopt);
-Result<DeserializationError, int32_t> TryDeserializeInteger(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<int32_t> defaultValue = std::nullopt);
+int32_t DeserializeInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<int32_t> defaultValue = std::nullopt);
+Result<DeserializationError, int32_t> TryDeserializeInteger(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<int32_t> defaultValue = std::nullopt);
 
-float DeserializeFloat(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<float> defaultValue = std::nullopt);
-Result<DeserializationError, float> TryDeserializeFloat(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<float> defaultValue = std::nullopt);
+float DeserializeFloat(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<float> defaultValue = std::nullopt);
+Result<DeserializationError, float> TryDeserializeFloat(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<float> defaultValue = std::nullopt);
 
-bool DeserializeBool(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<bool> defaultValue = std::nullopt);
-Result<DeserializationError, bool> TryDeserializeBool(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<bool> defaultValue = std::nullopt);
+bool DeserializeBool(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<bool> defaultValue = std::nullopt);
+Result<DeserializationError, bool> TryDeserializeBool(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<bool> defaultValue = std::nullopt);
 
-glm::vec2 DeserializeVec2(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec2> defaultValue = std::nullopt);
-Result<DeserializationError, glm::vec2> TryDeserializeVec2(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec2> defaultValue = std::nullopt);
+glm::vec2 DeserializeVec2(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec2> defaultValue = std::nullopt);
+Result<DeserializationError, glm::vec2> TryDeserializeVec2(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec2> defaultValue = std::nullopt);
 
-glm::vec3 DeserializeVec3(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec3> defaultValue = std::nullopt);
-Result<DeserializationError, glm::vec3> TryDeserializeVec3(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec3> defaultValue = std::nullopt);
+glm::vec3 DeserializeVec3(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec3> defaultValue = std::nullopt);
+Result<DeserializationError, glm::vec3> TryDeserializeVec3(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec3> defaultValue = std::nullopt);
 
-glm::vec4 DeserializeVec4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec4> defaultValue = std::nullopt);
-Result<DeserializationError, glm::vec4> TryDeserializeVec4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::vec4> defaultValue = std::nullopt);
+glm::vec4 DeserializeVec4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec4> defaultValue = std::nullopt);
+Result<DeserializationError, glm::vec4> TryDeserializeVec4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::vec4> defaultValue = std::nullopt);
 
-glm::mat4 DeserializeMat4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::mat4> defaultValue = std::nullopt);
-Result<DeserializationError, glm::mat4> TryDeserializeMat4(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<glm::mat4> defaultValue = std::nullopt);
+glm::mat4 DeserializeMat4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::mat4> defaultValue = std::nullopt);
+Result<DeserializationError, glm::mat4> TryDeserializeMat4(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<glm::mat4> defaultValue = std::nullopt);
+
+// Entities are referred to by their index in the list of entities being loaded, which the loader makes available with
+// an EntityTableScope, as Binary::Reader::SetEntities() does for binary data. Without a table, indices are read as
+// entity handles. Indices outside of the table are read as entt::null.
+class EntityTableScope
+{
+public:
+    EntityTableScope(std::span<const entt::entity> entities);
+    ~EntityTableScope();
+
+private:
+    std::span<const entt::entity> m_PreviousEntities;
+};
+
+entt::entity DeserializeEntity(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<entt::entity> defaultValue = std::nullopt);
+Result<DeserializationError, entt::entity> TryDeserializeEntity(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<entt::entity> defaultValue = std::nullopt);
 
 // Enum deserialization (template functions must be defined in header)
 // Uses magic_enum to convert string values to enum types
 // Note: TryDeserializeEnum must be declared before DeserializeEnum for proper template instantiation
 template<typename EnumType>
-Result<DeserializationError, EnumType> TryDeserializeEnum(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<EnumType> defaultValue = std::nullopt)
+Result<DeserializationError, EnumType> TryDeserializeEnum(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<EnumType> defaultValue = std::nullopt)
 {
     auto it = data.find(key);
     if (it == data.cend())
@@ -83,7 +119,7 @@ Result<DeserializationError, EnumType> TryDeserializeEnum(const ResourceDataStor
     }
     else
     {
-        const std::string enumString = it->get<std::string>();
+        const std::string& enumString = it->get_ref<const std::string&>();
         auto enumValue = magic_enum::enum_cast<EnumType>(enumString, magic_enum::case_insensitive);
 
         if (enumValue.has_value())
@@ -93,8 +129,7 @@ Result<DeserializationError, EnumType> TryDeserializeEnum(const ResourceDataStor
         else
         {
             // Invalid enum string - log a warning and use default if available
-            const std::string contextPath = pContext ? pContext->GetPath() : "<no context>";
-            Log::Warning() << contextPath << ": invalid enum value '" << enumString << "' for key '" << key << "'.";
+            Log::Warning() << GetContextPath(pContext) << ": invalid enum value '" << enumString << "' for key '" << key << "'.";
 
             if (defaultValue.has_value())
             {
@@ -109,7 +144,7 @@ Result<DeserializationError, EnumType> TryDeserializeEnum(const ResourceDataStor
 }
 
 template<typename EnumType>
-EnumType DeserializeEnum(const ResourceDataStore* pContext, const Data& data, const std::string& key, std::optional<EnumType> defaultValue = std::nullopt)
+EnumType DeserializeEnum(const ResourceDataStore* pContext, const Data& data, std::string_view key, std::optional<EnumType> defaultValue = std::nullopt)
 {
     auto result = TryDeserializeEnum<EnumType>(pContext, data, key, defaultValue);
     if (result.has_value())
@@ -118,15 +153,13 @@ EnumType DeserializeEnum(const ResourceDataStore* pContext, const Data& data, co
     }
     else
     {
-        const std::string contextPath = pContext ? pContext->GetPath() : "<no context>";
-
         if (result.error() == DeserializationError::KeyNotFound)
         {
-            Log::Error() << contextPath << ": failed to find enum key '" << key << "'.";
+            Log::Error() << GetContextPath(pContext) << ": failed to find enum key '" << key << "'.";
         }
         else if (result.error() == DeserializationError::TypeMismatch)
         {
-            Log::Error() << contextPath << ": key '" << key << "' is not a valid enum string.";
+            Log::Error() << GetContextPath(pContext) << ": key '" << key << "' is not a valid enum string.";
         }
 
         return defaultValue.value_or(static_cast<EnumType>(0));
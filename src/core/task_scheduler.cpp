@@ -0,0 +1,155 @@
+#include "core/task_scheduler.hpp"
+
+#include <algorithm>
+
+#include "core/log.hpp"
+#include "core/profiler.hpp"
+
+namespace WingsOfSteel
+{
+
+// Bullet supports at most 64 threads, including the main thread.
+static constexpr uint32_t sMaxWorkers = 63;
+
+static thread_local bool sInParallelFor = false;
+
+TaskScheduler::TaskScheduler()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const uint32_t numWorkers = std::min(hardwareThreads - 1, sMaxWorkers);
+    m_Workers.reserve(numWorkers);
+    for (uint32_t i = 0; i < numWorkers; i++)
+    {
+        m_Workers.emplace_back(&TaskScheduler::WorkerMain, this, i);
+    }
+#endif
+
+    m_ThreadCount = GetMaxThreadCount();
+    Log::Info() << "Task scheduler initialized with " << m_ThreadCount << " thread(s).";
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ShuttingDown = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for (std::thread& worker : m_Workers)
+    {
+        worker.join();
+    }
+}
+
+void TaskScheduler::ParallelFor(size_t begin, size_t end, size_t grainSize, const ParallelForFunction& func)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (m_ThreadCount <= 1 || sInParallelFor || end - begin <= grainSize)
+    {
+        func(begin, end);
+        return;
+    }
+
+    // Only one loop is spread across the workers at a time; any other thread runs its loop by itself rather than waiting.
+    std::unique_lock<std::mutex> jobLock(m_JobMutex, std::try_to_lock);
+    if (!jobLock.owns_lock())
+    {
+        func(begin, end);
+        return;
+    }
+
+    Job job;
+    job.pFunc = &func;
+    job.end = end;
+    job.grainSize = grainSize;
+    job.next = begin;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_pJob = &job;
+        m_JobId++;
+    }
+    m_WakeCondition.notify_all();
+
+    sInParallelFor = true;
+    RunChunks(job);
+    sInParallelFor = false;
+
+    // Workers only join a job while m_pJob is set, so once it is cleared no worker can still be using it.
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_DoneCondition.wait(lock, [this]() { return m_ActiveWorkers == 0; });
+    m_pJob = nullptr;
+}
+
+void TaskScheduler::SetThreadCount(uint32_t threadCount)
+{
+    m_ThreadCount = std::clamp(threadCount, 1u, GetMaxThreadCount());
+}
+
+bool TaskScheduler::IsInParallelFor()
+{
+    return sInParallelFor;
+}
+
+void TaskScheduler::WorkerMain(uint32_t workerIndex)
+{
+    // Anything a worker runs is already part of a loop.
+    sInParallelFor = true;
+    Profiler::SetThreadName("Worker " + std::to_string(workerIndex));
+
+    uint64_t lastJobId = 0;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true)
+    {
+        m_WakeCondition.wait(lock, [this, &lastJobId]() { return m_ShuttingDown || m_JobId != lastJobId; });
+        if (m_ShuttingDown)
+        {
+            return;
+        }
+
+        lastJobId = m_JobId;
+
+        // Worker 0 is the second thread taking part in a loop, as the calling thread is always the first.
+        if (m_pJob == nullptr || workerIndex + 1 >= m_ThreadCount)
+        {
+            continue;
+        }
+
+        Job* pJob = m_pJob;
+        m_ActiveWorkers++;
+        lock.unlock();
+
+        RunChunks(*pJob);
+
+        lock.lock();
+        m_ActiveWorkers--;
+        if (m_ActiveWorkers == 0)
+        {
+            m_DoneCondition.notify_all();
+        }
+    }
+}
+
+void TaskScheduler::RunChunks(Job& job)
+{
+    while (true)
+    {
+        const size_t chunkBegin = job.next.fetch_add(job.grainSize);
+        if (chunkBegin >= job.end)
+        {
+            return;
+        }
+
+        const size_t chunkEnd = std::min(chunkBegin + job.grainSize, job.end);
+        (*job.pFunc)(chunkBegin, chunkEnd);
+    }
+}
+
+} // namespace WingsOfSteel
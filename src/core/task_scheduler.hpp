@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+//////////////////////////////////////////////////////////////////////////
+// TaskScheduler
+// Runs parallel loops over a pool of worker threads, with the calling
+// thread taking part in the work. Chunks of a loop are handed out on
+// demand, so threads which finish early pick up the remaining chunks.
+// Web builds are single threaded: every loop runs on the calling thread.
+//////////////////////////////////////////////////////////////////////////
+
+using ParallelForFunction = std::function<void(size_t begin, size_t end)>;
+
+DECLARE_SMART_PTR(TaskScheduler);
+class TaskScheduler
+{
+public:
+    TaskScheduler();
+    ~TaskScheduler();
+
+    // Splits [begin, end) into chunks of up to grainSize elements and runs func over them, returning once all chunks are done.
+    // Loops started from within another loop, or while another thread is running one, run on the calling thread.
+    void ParallelFor(size_t begin, size_t end, size_t grainSize, const ParallelForFunction& func);
+
+    // Number of threads taking part in each loop, including the calling thread.
+    uint32_t GetThreadCount() const { return m_ThreadCount.load(); }
+    uint32_t GetMaxThreadCount() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+    void SetThreadCount(uint32_t threadCount);
+
+    // True if the calling thread is currently running part of a loop.
+    static bool IsInParallelFor();
+
+private:
+    struct Job
+    {
+        const ParallelForFunction* pFunc{ nullptr };
+        size_t end{ 0 };
+        size_t grainSize{ 1 };
+        std::atomic<size_t> next{ 0 };
+    };
+
+    void WorkerMain(uint32_t workerIndex);
+    static void RunChunks(Job& job);
+
+    std::vector<std::thread> m_Workers;
+    std::atomic<uint32_t> m_ThreadCount{ 1 };
+
+    std::mutex m_JobMutex; // Held by the thread running a loop.
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCondition;
+    std::condition_variable m_DoneCondition;
+    Job* m_pJob{ nullptr };
+    uint64_t m_JobId{ 0 };
+    uint32_t m_ActiveWorkers{ 0 };
+    bool m_ShuttingDown{ false };
+};
+
+} // namespace WingsOfSteel
@@ -11,6 +11,7 @@
 #include "imgui/fonts/supplymono_regular_data.hpp"
 #include "imgui/fonts/supplymono_semibold_data.hpp"
 #include "imgui/fonts/ubuntu_mono_data.hpp"
+#include "imgui/profiler_window.hpp"
 #include "input/input_system.hpp"
 #include "pandora.hpp"
 #include "render/lighting/lighting_system.hpp"
@@ -46,6 +47,8 @@ ImGuiSystem::ImGuiSystem()
 
     RegisterFonts();
     ApplyStyle();
+
+    m_pProfilerWindow = std::make_unique<ProfilerWindow>();
 }
 
 ImGuiSystem::~ImGuiSystem()
@@ -103,6 +106,11 @@ void ImGuiSystem::Update()
                 GetRenderSystem()->GetShaderEditor()->Show(m_ShowShaderEditor);
             }
 
+            if (ImGui::MenuItem("Profiler", nullptr, &m_ShowProfiler))
+            {
+                m_pProfilerWindow->Show(m_ShowProfiler);
+            }
+
             ImGui::EndMenu();
         }
 
@@ -118,6 +126,9 @@ void ImGuiSystem::Update()
     {
         ImGui::ShowDemoWindow(&m_ShowDemoWindow);
     }
+
+    m_pProfilerWindow->Update();
+    m_ShowProfiler = m_pProfilerWindow->IsVisible();
 #endif // BUILD_DEBUG
 }
 
@@ -7,9 +7,13 @@
 #include <magic_enum.hpp>
 #include <webgpu/webgpu_cpp.h>
 
+#include "core/smart_ptr.hpp"
+
 namespace WingsOfSteel
 {
 
+DECLARE_SMART_PTR(ProfilerWindow);
+
 using ImGuiGameMenuBarCallback = std::function<void()>;
 
 enum class Font
@@ -48,6 +52,8 @@ private:
     bool m_ShowDemoWindow{ false };
     bool m_DebugDrawDemo{ false };
     bool m_ShowShaderEditor{ false };
+    bool m_ShowProfiler{ false };
+    ProfilerWindowUniquePtr m_pProfilerWindow;
     ImGuiGameMenuBarCallback m_GameMenuBarCallback;
     std::array<ImFont*, magic_enum::enum_count<Font>()> m_Fonts;
 };
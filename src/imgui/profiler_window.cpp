@@ -0,0 +1,320 @@
+#include "imgui/profiler_window.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/log.hpp"
+#include "core/profiler.hpp"
+#include "imgui/fonts/icons_font_awesome.hpp"
+#include "imgui/imgui.hpp"
+#include "pandora.hpp"
+#include "render/gpu_profiler.hpp"
+#include "render/rendersystem.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr float sHistoryHeight = 80.0f;
+static constexpr float sFlameGraphRowHeight = 20.0f;
+static constexpr double sTargetFrameMilliseconds = 1000.0 / 60.0;
+
+static double ToMilliseconds(uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1000000.0;
+}
+
+// Zones with the same name always get the same color, so they can be followed from frame to frame.
+static ImU32 GetZoneColor(std::string_view name)
+{
+    const size_t hash = std::hash<std::string_view>()(name);
+    const float hue = static_cast<float>(hash % 360) / 360.0f;
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.7f, r, g, b);
+    return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1.0f));
+}
+
+ProfilerWindow::ProfilerWindow()
+{
+}
+
+ProfilerWindow::~ProfilerWindow()
+{
+}
+
+void ProfilerWindow::Update()
+{
+    if (!m_Show)
+    {
+        return;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(1000, 600), ImGuiCond_Once);
+    if (ImGui::Begin("Profiler", &m_Show))
+    {
+        m_ThreadNames = Profiler::GetThreadNames();
+
+        DrawToolbar();
+        DrawFrameHistory();
+        DrawGpuTimings();
+
+        const std::deque<ProfilerFrame>& frames = Profiler::GetFrameHistory();
+        if (m_SelectedFrame >= static_cast<int>(frames.size()))
+        {
+            m_SelectedFrame = -1;
+        }
+
+        if (!frames.empty())
+        {
+            DrawFlameGraph((m_SelectedFrame >= 0) ? frames[m_SelectedFrame] : frames.back());
+        }
+    }
+    ImGui::End();
+
+    if (!m_Show)
+    {
+        Show(false);
+    }
+}
+
+void ProfilerWindow::Show(bool state)
+{
+    m_Show = state;
+    Profiler::SetEnabled(state);
+    if (!state)
+    {
+        Profiler::SetPaused(false);
+        Profiler::ClearFrameHistory();
+        m_SelectedFrame = -1;
+    }
+}
+
+void ProfilerWindow::DrawToolbar()
+{
+    bool paused = Profiler::IsPaused();
+    if (ImGui::Checkbox("Paused", &paused))
+    {
+        Profiler::SetPaused(paused);
+        if (!paused)
+        {
+            m_SelectedFrame = -1;
+        }
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button(ICON_FA_FLOPPY_DISK " Export trace"))
+    {
+        ExportChromeTrace();
+    }
+
+    const std::deque<ProfilerFrame>& frames = Profiler::GetFrameHistory();
+    if (!frames.empty())
+    {
+        double total = 0.0;
+        double worst = 0.0;
+        for (const ProfilerFrame& frame : frames)
+        {
+            const double milliseconds = ToMilliseconds(frame.end - frame.start);
+            total += milliseconds;
+            worst = std::max(worst, milliseconds);
+        }
+
+        ImGui::SameLine();
+        ImGui::Text("Average: %.2f ms, worst: %.2f ms over %zu frames.", total / frames.size(), worst, frames.size());
+    }
+}
+
+void ProfilerWindow::DrawFrameHistory()
+{
+    const std::deque<ProfilerFrame>& frames = Profiler::GetFrameHistory();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImVec2 size(ImGui::GetContentRegionAvail().x, sHistoryHeight);
+    ImGui::InvisibleButton("##FrameHistory", size);
+    const bool hovered = ImGui::IsItemHovered();
+    const bool clicked = ImGui::IsItemClicked();
+
+    ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+    pDrawList->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(30, 30, 30, 255));
+    if (frames.empty())
+    {
+        return;
+    }
+
+    double maxMilliseconds = sTargetFrameMilliseconds * 2.0;
+    for (const ProfilerFrame& frame : frames)
+    {
+        maxMilliseconds = std::max(maxMilliseconds, ToMilliseconds(frame.end - frame.start));
+    }
+
+    const float barWidth = size.x / static_cast<float>(Profiler::sFrameHistorySize);
+    const int selectedFrame = (m_SelectedFrame >= 0) ? m_SelectedFrame : static_cast<int>(frames.size()) - 1;
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        const double milliseconds = ToMilliseconds(frames[i].end - frames[i].start);
+        const float height = static_cast<float>(milliseconds / maxMilliseconds) * size.y;
+        const float x = origin.x + static_cast<float>(i) * barWidth;
+        ImU32 color = (milliseconds > sTargetFrameMilliseconds) ? IM_COL32(200, 90, 60, 255) : IM_COL32(90, 170, 90, 255);
+        if (static_cast<int>(i) == selectedFrame)
+        {
+            color = IM_COL32(240, 240, 240, 255);
+        }
+        pDrawList->AddRectFilled(ImVec2(x, origin.y + size.y - height), ImVec2(x + std::max(barWidth - 1.0f, 1.0f), origin.y + size.y), color);
+    }
+
+    const float targetY = origin.y + size.y - static_cast<float>(sTargetFrameMilliseconds / maxMilliseconds) * size.y;
+    pDrawList->AddLine(ImVec2(origin.x, targetY), ImVec2(origin.x + size.x, targetY), IM_COL32(255, 255, 255, 80));
+
+    if (hovered)
+    {
+        const int index = static_cast<int>((ImGui::GetIO().MousePos.x - origin.x) / barWidth);
+        if (index >= 0 && index < static_cast<int>(frames.size()))
+        {
+            ImGui::SetTooltip("%.2f ms", ToMilliseconds(frames[index].end - frames[index].start));
+
+            // Selecting a frame pauses the profiler, otherwise the frame would scroll away.
+            if (clicked)
+            {
+                m_SelectedFrame = index;
+                Profiler::SetPaused(true);
+            }
+        }
+    }
+}
+
+void ProfilerWindow::DrawFlameGraph(const ProfilerFrame& frame)
+{
+    ImGui::Text("Frame: %.3f ms, %zu zones.", ToMilliseconds(frame.end - frame.start), frame.zones.size());
+    if (frame.droppedZones > 0)
+    {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.3f, 1.0f), "%u zones dropped.", frame.droppedZones);
+    }
+
+    if (!ImGui::BeginChild("FlameGraph", ImVec2(0, 0), ImGuiChildFlags_Border))
+    {
+        ImGui::EndChild();
+        return;
+    }
+
+    ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+    const float width = ImGui::GetContentRegionAvail().x;
+    const double frameDuration = static_cast<double>(std::max<uint64_t>(frame.end - frame.start, 1));
+    const ImVec2 mousePosition = ImGui::GetIO().MousePos;
+    const ImU32 textColor = IM_COL32(255, 255, 255, 255);
+
+    // Zones are sorted by thread, so each thread's zones are a contiguous range.
+    size_t threadBegin = 0;
+    while (threadBegin < frame.zones.size())
+    {
+        const uint32_t thread = frame.zones[threadBegin].thread;
+        size_t threadEnd = threadBegin;
+        uint32_t maxDepth = 0;
+        while (threadEnd < frame.zones.size() && frame.zones[threadEnd].thread == thread)
+        {
+            maxDepth = std::max(maxDepth, frame.zones[threadEnd].depth);
+            threadEnd++;
+        }
+
+        ImGui::TextUnformatted((thread < m_ThreadNames.size()) ? m_ThreadNames[thread].c_str() : "Unknown thread");
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float height = static_cast<float>(maxDepth + 1) * sFlameGraphRowHeight;
+        ImGui::PushID(static_cast<int>(thread));
+        ImGui::InvisibleButton("##Thread", ImVec2(width, height));
+        const bool hovered = ImGui::IsItemHovered();
+        ImGui::PopID();
+
+        for (size_t i = threadBegin; i < threadEnd; i++)
+        {
+            const ProfilerZone& zone = frame.zones[i];
+
+            // Zones on other threads can start before the frame they ended in.
+            const uint64_t start = std::max(zone.start, frame.start);
+            const float x0 = origin.x + static_cast<float>((start - frame.start) / frameDuration) * width;
+            const float x1 = std::max(origin.x + static_cast<float>((zone.end - frame.start) / frameDuration) * width, x0 + 1.0f);
+            const float y0 = origin.y + static_cast<float>(zone.depth) * sFlameGraphRowHeight;
+            const float y1 = y0 + sFlameGraphRowHeight - 1.0f;
+            pDrawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), GetZoneColor(zone.name));
+
+            if (x1 - x0 > 20.0f)
+            {
+                const ImVec4 clipRect(x0, y0, x1 - 2.0f, y1);
+                pDrawList->AddText(nullptr, 0.0f, ImVec2(x0 + 2.0f, y0 + 2.0f), textColor, zone.name.data(), zone.name.data() + zone.name.size(), 0.0f, &clipRect);
+            }
+
+            if (hovered && mousePosition.x >= x0 && mousePosition.x < x1 && mousePosition.y >= y0 && mousePosition.y < y1)
+            {
+                ImGui::SetTooltip("%.*s: %.3f ms", static_cast<int>(zone.name.size()), zone.name.data(), ToMilliseconds(zone.end - zone.start));
+            }
+        }
+
+        threadBegin = threadEnd;
+    }
+
+    ImGui::EndChild();
+}
+
+// GPU timings are measured on a different clock from the CPU zones, so they are shown on their own timeline.
+void ProfilerWindow::DrawGpuTimings()
+{
+    GpuProfiler* pGpuProfiler = GetRenderSystem()->GetGpuProfiler();
+    if (!pGpuProfiler->IsSupported())
+    {
+        ImGui::TextDisabled("GPU: timestamp queries aren't supported by this device.");
+        return;
+    }
+
+    const std::vector<GpuPassTiming>& passTimings = pGpuProfiler->GetPassTimings();
+    uint64_t gpuFrameEnd = 1;
+    for (const GpuPassTiming& passTiming : passTimings)
+    {
+        gpuFrameEnd = std::max(gpuFrameEnd, passTiming.end);
+    }
+    ImGui::Text("GPU: %.3f ms", ToMilliseconds(gpuFrameEnd));
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = ImGui::GetContentRegionAvail().x;
+    ImGui::InvisibleButton("##GpuTimings", ImVec2(width, sFlameGraphRowHeight));
+    const bool hovered = ImGui::IsItemHovered();
+    const ImVec2 mousePosition = ImGui::GetIO().MousePos;
+
+    ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+    for (const GpuPassTiming& passTiming : passTimings)
+    {
+        const float x0 = origin.x + static_cast<float>(static_cast<double>(passTiming.start) / gpuFrameEnd) * width;
+        const float x1 = std::max(origin.x + static_cast<float>(static_cast<double>(passTiming.end) / gpuFrameEnd) * width, x0 + 1.0f);
+        const float y1 = origin.y + sFlameGraphRowHeight - 1.0f;
+        pDrawList->AddRectFilled(ImVec2(x0, origin.y), ImVec2(x1, y1), GetZoneColor(passTiming.name));
+
+        if (x1 - x0 > 20.0f)
+        {
+            const ImVec4 clipRect(x0, origin.y, x1 - 2.0f, y1);
+            pDrawList->AddText(nullptr, 0.0f, ImVec2(x0 + 2.0f, origin.y + 2.0f), IM_COL32(255, 255, 255, 255), passTiming.name.c_str(), nullptr, 0.0f, &clipRect);
+        }
+
+        if (hovered && mousePosition.x >= x0 && mousePosition.x < x1)
+        {
+            ImGui::SetTooltip("%s: %.3f ms", passTiming.name.c_str(), ToMilliseconds(passTiming.end - passTiming.start));
+        }
+    }
+}
+
+void ProfilerWindow::ExportChromeTrace()
+{
+    std::ostringstream trace;
+    Profiler::WriteChromeTrace(trace);
+    const std::string text = trace.str();
+
+    const std::string path = "profiler_trace.json";
+    GetVFS()->FileWriteAsync(path, std::vector<uint8_t>(text.begin(), text.end()), [path](bool success) {
+        if (success)
+        {
+            Log::Info() << "Exported profiler trace to '" << path << "'.";
+        }
+        else
+        {
+            Log::Warning() << "Failed to export profiler trace to '" << path << "'.";
+        }
+    });
+}
+
+} // namespace WingsOfSteel
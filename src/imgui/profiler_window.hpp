@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+struct ProfilerFrame;
+
+// Shows the profiler's frame history as a bar chart, and the zones of the
+// selected frame as a flame graph with one row per nesting level and thread.
+// Opening the window enables the profiler.
+DECLARE_SMART_PTR(ProfilerWindow);
+class ProfilerWindow
+{
+public:
+    ProfilerWindow();
+    ~ProfilerWindow();
+
+    void Update();
+    void Show(bool state);
+    bool IsVisible() const { return m_Show; }
+
+private:
+    void DrawToolbar();
+    void DrawFrameHistory();
+    void DrawFlameGraph(const ProfilerFrame& frame);
+    void DrawGpuTimings();
+    void ExportChromeTrace();
+
+    bool m_Show{ false };
+    int m_SelectedFrame{ -1 }; // Index into the frame history, or -1 to follow the latest frame.
+    std::vector<std::string> m_ThreadNames;
+};
+
+} // namespace WingsOfSteel
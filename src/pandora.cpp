@@ -9,13 +9,18 @@
 #include <emscripten/emscripten.h>
 #endif
 
+#include <chrono>
 #include <memory>
 
 #include "core/log.hpp"
+#include "core/profiler.hpp"
 #include "core/random.hpp"
+#include "core/task_scheduler.hpp"
 #include "imgui/imgui_system.hpp"
 #include "input/input_system.hpp"
 #include "pandora.hpp"
+#include "physics/collision_shape_cache.hpp"
+#include "physics/internal/bullet_task_scheduler.hpp"
 #include "render/debug_render.hpp"
 #include "render/rendersystem.hpp"
 #include "render/window.hpp"
@@ -27,12 +32,17 @@
 namespace WingsOfSteel
 {
 
+#if defined(TARGET_PLATFORM_NATIVE)
+std::unique_ptr<BulletTaskScheduler> g_pBulletTaskScheduler;
+#endif
+std::unique_ptr<CollisionShapeCache> g_pCollisionShapeCache;
 std::unique_ptr<DebugRender> g_pDebugRender;
 std::unique_ptr<ImGuiSystem> g_pImGuiSystem;
 std::unique_ptr<InputSystem> g_pInputSystem;
 std::unique_ptr<RenderSystem> g_pRenderSystem;
 std::unique_ptr<ResourceSystem> g_pResourceSystem;
 std::shared_ptr<Scene> g_pActiveScene;
+std::unique_ptr<TaskScheduler> g_pTaskScheduler;
 std::unique_ptr<VFS> g_pVFS;
 std::unique_ptr<Window> g_pWindow;
 
@@ -43,19 +53,11 @@ GameShutdownCallback g_GameShutdownCallback;
 float g_PreviousFrameStart = 0.0f;
 
 void InitializeLogging();
+void InitializeCommon(GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback);
 
 void Initialize(const WindowSettings& windowSettings, GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback)
 {
-    g_GameInitializeCallback = gameInitializeCallback;
-    g_GameUpdateCallback = gameUpdateCallback;
-    g_GameShutdownCallback = gameShutdownCallback;
-
-    InitializeLogging();
-
-    Random::Initialize();
-
-    g_pVFS = std::make_unique<VFS>();
-    g_pVFS->Initialize();
+    InitializeCommon(gameInitializeCallback, gameUpdateCallback, gameShutdownCallback);
 
     g_pRenderSystem = std::make_unique<RenderSystem>();
     g_pRenderSystem->Initialize(
@@ -67,7 +69,7 @@ void Initialize(const WindowSettings& windowSettings, GameInitializeCallback gam
             g_pImGuiSystem = std::make_unique<ImGuiSystem>();
             g_pDebugRender = std::make_unique<DebugRender>();
             g_GameInitializeCallback();
-            g_PreviousFrameStart = static_cast<float>(glfwGetTime());
+            g_PreviousFrameStart = GetTime();
 
 #if defined(TARGET_PLATFORM_NATIVE)
             while (!glfwWindowShouldClose(GetWindow()->GetRawWindow()))
@@ -84,29 +86,115 @@ void Initialize(const WindowSettings& windowSettings, GameInitializeCallback gam
         });
 }
 
+void InitializeHeadless(const HeadlessSettings& headlessSettings, GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback)
+{
+    InitializeCommon(gameInitializeCallback, gameUpdateCallback, gameShutdownCallback);
+
+    g_pRenderSystem = std::make_unique<RenderSystem>();
+    g_pRenderSystem->Initialize(
+        [headlessSettings]() -> void {
+            g_pResourceSystem = std::make_unique<ResourceSystem>();
+            if (headlessSettings.HasRenderTarget())
+            {
+                g_pWindow = std::make_unique<Window>(headlessSettings);
+            }
+            g_PreviousFrameStart = GetTime();
+            g_GameInitializeCallback();
+            Shutdown();
+        },
+        headlessSettings.GetAdapter(), true);
+}
+
+void InitializeCommon(GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback)
+{
+    g_GameInitializeCallback = gameInitializeCallback;
+    g_GameUpdateCallback = gameUpdateCallback;
+    g_GameShutdownCallback = gameShutdownCallback;
+
+    InitializeLogging();
+    Profiler::SetThreadName("Main");
+
+    Random::Initialize();
+
+    g_pTaskScheduler = std::make_unique<TaskScheduler>();
+#if defined(TARGET_PLATFORM_NATIVE)
+    // Bullet has a single global task scheduler, shared by every multithreaded world.
+    g_pBulletTaskScheduler = std::make_unique<BulletTaskScheduler>(g_pTaskScheduler.get());
+    btSetTaskScheduler(g_pBulletTaskScheduler.get());
+#endif
+    g_pCollisionShapeCache = std::make_unique<CollisionShapeCache>();
+
+    g_pVFS = std::make_unique<VFS>();
+    g_pVFS->Initialize();
+}
+
 void Update()
 {
-    const float now = static_cast<float>(glfwGetTime());
+    const float now = GetTime();
     const float delta = now - g_PreviousFrameStart;
     g_PreviousFrameStart = now;
 
-    GetImGuiSystem()->OnFrameStart();
-
-    GetVFS()->Update();
-    GetResourceSystem()->Update();
-    GetInputSystem()->Update();
-    GetDebugRender()->Update(delta);
-    GetImGuiSystem()->Update();
+    // Headless engines have no input or UI, and only render if they have a render target.
+    const bool headless = GetRenderSystem()->IsHeadless();
 
-    g_GameUpdateCallback(delta);
+    Profiler::BeginFrame();
 
-    Scene* pActiveScene = GetActiveScene();
-    if (pActiveScene)
     {
-        pActiveScene->Update(delta);
+        PROFILE_SCOPE("Frame");
+
+        if (!headless)
+        {
+            GetImGuiSystem()->OnFrameStart();
+        }
+
+        {
+            PROFILE_SCOPE("VFS");
+            GetVFS()->Update();
+        }
+
+        {
+            PROFILE_SCOPE("Resources");
+            GetResourceSystem()->Update();
+        }
+
+        if (!headless)
+        {
+            {
+                PROFILE_SCOPE("Input");
+                GetInputSystem()->Update();
+            }
+
+            {
+                PROFILE_SCOPE("Debug render");
+                GetDebugRender()->Update(delta);
+            }
+
+            {
+                PROFILE_SCOPE("ImGui");
+                GetImGuiSystem()->Update();
+            }
+        }
+
+        {
+            PROFILE_SCOPE("Game");
+            g_GameUpdateCallback(delta);
+        }
+
+        Scene* pActiveScene = GetActiveScene();
+        if (pActiveScene)
+        {
+            PROFILE_SCOPE("Scene");
+            pActiveScene->Update(delta);
+        }
+
+        if (GetWindow())
+        {
+            PROFILE_SCOPE("Render");
+            GetRenderSystem()->Update();
+        }
     }
 
-    GetRenderSystem()->Update();
+    Profiler::EndFrame();
 }
 
 void Shutdown()
@@ -119,9 +207,22 @@ void Shutdown()
     g_pInputSystem.reset();
     g_pWindow.reset();
     g_pActiveScene.reset();
+    g_pCollisionShapeCache.reset();
     g_pRenderSystem.reset();
     g_pImGuiSystem.reset();
     g_pVFS.reset();
+#if defined(TARGET_PLATFORM_NATIVE)
+    btSetTaskScheduler(btGetSequentialTaskScheduler());
+    g_pBulletTaskScheduler.reset();
+#endif
+    g_pTaskScheduler.reset();
+
+    Log::StopAsync();
+}
+
+CollisionShapeCache* GetCollisionShapeCache()
+{
+    return g_pCollisionShapeCache.get();
 }
 
 DebugRender* GetDebugRender()
@@ -159,6 +260,11 @@ void SetActiveScene(SceneSharedPtr pScene)
     g_pActiveScene = pScene;
 }
 
+TaskScheduler* GetTaskScheduler()
+{
+    return g_pTaskScheduler.get();
+}
+
 VFS* GetVFS()
 {
     return g_pVFS.get();
@@ -169,12 +275,19 @@ Window* GetWindow()
     return g_pWindow.get();
 }
 
+float GetTime()
+{
+    static const std::chrono::steady_clock::time_point sStartTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - sStartTime).count();
+}
+
 void InitializeLogging()
 {
     Log::AddLogTarget(std::make_shared<StdOutLogger>());
 
 #if defined(TARGET_PLATFORM_NATIVE)
     Log::AddLogTarget(std::make_shared<FileLogger>("log.txt"));
+    Log::StartAsync();
 #endif
 
     Log::Info() << "Logging initialized.";
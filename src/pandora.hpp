@@ -3,17 +3,20 @@
 #include <functional>
 
 #include "core/smart_ptr.hpp"
+#include "render/headless_settings.hpp"
 #include "render/window_settings.hpp"
 
 namespace WingsOfSteel
 {
 
+DECLARE_SMART_PTR(CollisionShapeCache);
 DECLARE_SMART_PTR(DebugRender);
 DECLARE_SMART_PTR(ImGuiSystem);
 DECLARE_SMART_PTR(InputSystem);
 DECLARE_SMART_PTR(RenderSystem);
 DECLARE_SMART_PTR(ResourceSystem);
 DECLARE_SMART_PTR(Scene);
+DECLARE_SMART_PTR(TaskScheduler);
 DECLARE_SMART_PTR(VFS);
 DECLARE_SMART_PTR(Window);
 
@@ -22,9 +25,14 @@ using GameUpdateCallback = std::function<void(float)>;
 using GameShutdownCallback = std::function<void()>;
 
 void Initialize(const WindowSettings& windowSettings, GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback);
+// Initializes the engine without a window, input or UI, for servers, tools and benchmarks. There is no main loop:
+// the initialize callback drives the frames by calling Update() itself, and the engine shuts down once it returns.
+// Frames are only rendered if the settings have a render target, to an offscreen window.
+void InitializeHeadless(const HeadlessSettings& headlessSettings, GameInitializeCallback gameInitializeCallback, GameUpdateCallback gameUpdateCallback, GameShutdownCallback gameShutdownCallback);
 void Update();
 void Shutdown();
 
+CollisionShapeCache* GetCollisionShapeCache();
 DebugRender* GetDebugRender();
 ImGuiSystem* GetImGuiSystem();
 InputSystem* GetInputSystem();
@@ -32,7 +40,11 @@ RenderSystem* GetRenderSystem();
 ResourceSystem* GetResourceSystem();
 Scene* GetActiveScene();
 void SetActiveScene(SceneSharedPtr pScene);
+TaskScheduler* GetTaskScheduler();
 VFS* GetVFS();
 Window* GetWindow();
 
+// Seconds since the engine started. Not taken from GLFW, which headless engines don't initialize.
+float GetTime();
+
 } // namespace WingsOfSteel
\ No newline at end of file
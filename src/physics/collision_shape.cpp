@@ -1,3 +1,5 @@
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
 #include <btBulletCollisionCommon.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -124,6 +126,23 @@ CollisionShapeSphere::CollisionShapeSphere(float radius)
 CollisionShapeConvexHull::CollisionShapeConvexHull(const ConvexHullVertices& vertices)
 {
     auto pConvexHullShape = std::make_unique<btConvexHullShape>(reinterpret_cast<const btScalar*>(vertices.data()), static_cast<int>(vertices.size()), static_cast<int>(sizeof(glm::vec3)));
+
+    // Hulls built from render meshes often have far more vertices than needed, and every support
+    // function call in the narrowphase walks all of them. btShapeHull rebuilds the hull from a fixed
+    // set of sampled directions, which keeps the overall shape with a few dozen vertices at most.
+    if (vertices.size() > sMaxConvexHullVertices)
+    {
+        btShapeHull shapeHull(pConvexHullShape.get());
+        if (shapeHull.buildHull(pConvexHullShape->getMargin()))
+        {
+            pConvexHullShape = std::make_unique<btConvexHullShape>(reinterpret_cast<const btScalar*>(shapeHull.getVertexPointer()), shapeHull.numVertices(), static_cast<int>(sizeof(btVector3)));
+        }
+        else
+        {
+            Log::Warning() << "Failed to simplify convex hull with " << vertices.size() << " vertices.";
+        }
+    }
+
     #if !defined(TARGET_PLATFORM_WEB)
     pConvexHullShape->optimizeConvexHull();
 #endif
@@ -154,4 +173,26 @@ CollisionShapeCylinder::CollisionShapeCylinder(Axis axis, float width, float hei
     m_pShape->setUserPointer(this);
 }
 
+/////////////////////////////////////////////////////////////////////
+// HeightfieldShape
+/////////////////////////////////////////////////////////////////////
+
+CollisionShapeHeightfield::CollisionShapeHeightfield(uint32_t width, uint32_t length, const float* pHeights, float minHeight, float maxHeight, const glm::vec3& scale)
+{
+    auto pHeightfieldShape = std::make_unique<btHeightfieldTerrainShape>(static_cast<int>(width), static_cast<int>(length), pHeights, 1.0f, minHeight, maxHeight, 1, PHY_FLOAT, false);
+    pHeightfieldShape->setLocalScaling(btVector3(scale.x, scale.y, scale.z));
+    pHeightfieldShape->setUserPointer(this);
+    m_pShape = std::move(pHeightfieldShape);
+    OnHeightsChanged();
+}
+
+void CollisionShapeHeightfield::OnHeightsChanged()
+{
+    // The accelerator lets raycasts skip over whole chunks of the heightfield rather than walking it cell by cell.
+    // It isn't available in the Bullet version provided by Emscripten.
+#if !defined(TARGET_PLATFORM_WEB)
+    static_cast<btHeightfieldTerrainShape*>(m_pShape.get())->buildAccelerator();
+#endif
+}
+
 } // namespace WingsOfSteel
\ No newline at end of file
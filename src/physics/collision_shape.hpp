@@ -35,7 +35,8 @@ public:
         Compound,
         Sphere,
         ConvexHull,
-        Cylinder
+        Cylinder,
+        Heightfield
     };
 
     virtual Type GetType() const = 0;
@@ -106,10 +107,13 @@ public:
 
 using ConvexHullVertices = std::vector<glm::vec3>;
 
+// Hulls with more vertices than sMaxConvexHullVertices are simplified when created.
 DECLARE_SMART_PTR(CollisionShapeConvexHull);
 class CollisionShapeConvexHull : public CollisionShape
 {
 public:
+    static constexpr size_t sMaxConvexHullVertices = 64;
+
     CollisionShapeConvexHull(const ConvexHullVertices& vertices);
 
     virtual Type GetType() const override { return Type::ConvexHull; }
@@ -135,4 +139,23 @@ public:
     virtual Type GetType() const override { return Type::Cylinder; }
 };
 
+/////////////////////////////////////////////////////////////////////
+// CollisionShapeHeightfield
+/////////////////////////////////////////////////////////////////////
+
+// Wraps a btHeightfieldTerrainShape which reads directly from the provided heights, without copying them.
+// The heights must remain valid and at the same address for as long as the shape exists.
+// The shape is centered on its local origin, with each sample spaced by scale.x and scale.z and heights multiplied by scale.y.
+DECLARE_SMART_PTR(CollisionShapeHeightfield);
+class CollisionShapeHeightfield : public CollisionShape
+{
+public:
+    CollisionShapeHeightfield(uint32_t width, uint32_t length, const float* pHeights, float minHeight, float maxHeight, const glm::vec3& scale);
+
+    // Must be called whenever the heights change, so raycasts against the shape remain accurate.
+    void OnHeightsChanged();
+
+    virtual Type GetType() const override { return Type::Heightfield; }
+};
+
 } // namespace WingsOfSteel
\ No newline at end of file
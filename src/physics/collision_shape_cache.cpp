@@ -0,0 +1,78 @@
+#include "physics/collision_shape_cache.hpp"
+
+#include <algorithm>
+
+#include <xxhash.h>
+
+namespace WingsOfSteel
+{
+
+size_t CollisionShapeCache::KeyHash::operator()(const Key& key) const
+{
+    // Shapes are only shared when their parameters are exactly the same. Adding zero turns -0 into +0,
+    // as they compare equal and so must hash the same.
+    struct
+    {
+        int type;
+        int axis;
+        float x;
+        float y;
+        float z;
+    } data{ static_cast<int>(key.type), static_cast<int>(key.axis), key.dimensions.x + 0.0f, key.dimensions.y + 0.0f, key.dimensions.z + 0.0f };
+    return static_cast<size_t>(XXH3_64bits(&data, sizeof(data)));
+}
+
+CollisionShapeSharedPtr CollisionShapeCache::GetSphere(float radius)
+{
+    return GetOrCreate(Key{ CollisionShape::Type::Sphere, CollisionShapeCylinder::Axis::Y, glm::vec3(radius, 0.0f, 0.0f) }, [radius]() {
+        return std::make_shared<CollisionShapeSphere>(radius);
+    });
+}
+
+CollisionShapeSharedPtr CollisionShapeCache::GetBox(const glm::vec3& dimensions)
+{
+    return GetOrCreate(Key{ CollisionShape::Type::Box, CollisionShapeCylinder::Axis::Y, dimensions }, [&dimensions]() {
+        return std::make_shared<CollisionShapeBox>(dimensions.x, dimensions.y, dimensions.z);
+    });
+}
+
+CollisionShapeSharedPtr CollisionShapeCache::GetCylinder(CollisionShapeCylinder::Axis axis, const glm::vec3& dimensions)
+{
+    return GetOrCreate(Key{ CollisionShape::Type::Cylinder, axis, dimensions }, [axis, &dimensions]() {
+        return std::make_shared<CollisionShapeCylinder>(axis, dimensions.x, dimensions.y, dimensions.z);
+    });
+}
+
+template <typename CreateFunction>
+CollisionShapeSharedPtr CollisionShapeCache::GetOrCreate(const Key& key, CreateFunction createFunction)
+{
+    auto it = m_Shapes.find(key);
+    if (it != m_Shapes.end())
+    {
+        CollisionShapeSharedPtr pShape = it->second.lock();
+        if (pShape)
+        {
+            return pShape;
+        }
+    }
+
+    CollisionShapeSharedPtr pShape = createFunction();
+    m_Shapes[key] = pShape;
+
+    if (m_Shapes.size() >= m_PruneThreshold)
+    {
+        PruneExpiredShapes();
+    }
+
+    return pShape;
+}
+
+void CollisionShapeCache::PruneExpiredShapes()
+{
+    std::erase_if(m_Shapes, [](const auto& entry) { return entry.second.expired(); });
+
+    // Keep pruning proportional to the number of live shapes, so the cost is amortized over insertions.
+    m_PruneThreshold = std::max<size_t>(64, m_Shapes.size() * 2);
+}
+
+} // namespace WingsOfSteel
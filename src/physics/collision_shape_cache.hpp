@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+#include <glm/vec3.hpp>
+
+#include "core/smart_ptr.hpp"
+#include "physics/collision_shape.hpp"
+
+namespace WingsOfSteel
+{
+
+// Bullet shapes hold no per-body state, so any number of collision objects can share one.
+// The cache hands out the same shape for identical parameters, as long as something still uses it:
+// the cache itself only keeps weak references, so unused shapes are freed as normal.
+// Convex hulls aren't cached here, as they are already shared through their ResourceModel.
+DECLARE_SMART_PTR(CollisionShapeCache);
+class CollisionShapeCache
+{
+public:
+    CollisionShapeCache() = default;
+    ~CollisionShapeCache() = default;
+
+    CollisionShapeSharedPtr GetSphere(float radius);
+    CollisionShapeSharedPtr GetBox(const glm::vec3& dimensions);
+    CollisionShapeSharedPtr GetCylinder(CollisionShapeCylinder::Axis axis, const glm::vec3& dimensions);
+
+    size_t GetCachedShapeCount() const { return m_Shapes.size(); }
+
+private:
+    struct Key
+    {
+        CollisionShape::Type type;
+        CollisionShapeCylinder::Axis axis;
+        glm::vec3 dimensions;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    template <typename CreateFunction>
+    CollisionShapeSharedPtr GetOrCreate(const Key& key, CreateFunction createFunction);
+    void PruneExpiredShapes();
+
+    std::unordered_map<Key, CollisionShapeWeakPtr, KeyHash> m_Shapes;
+    size_t m_PruneThreshold{ 64 };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,119 @@
+#include "physics/contact_events.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <btBulletCollisionCommon.h>
+
+namespace WingsOfSteel
+{
+
+void ContactEventStream::BeginUpdate()
+{
+    Clear();
+    m_Steps = 0;
+
+    if (m_PersistEventsEnabled)
+    {
+        m_UpdateStartPairs = m_PreviousPairs;
+    }
+}
+
+void ContactEventStream::OnStep(btDispatcher* pDispatcher)
+{
+    m_CurrentPairs.clear();
+
+    const int numManifolds = pDispatcher->getNumManifolds();
+    for (int i = 0; i < numManifolds; i++)
+    {
+        const btPersistentManifold* pManifold = pDispatcher->getManifoldByIndexInternal(i);
+        const int userIndexA = pManifold->getBody0()->getUserIndex();
+        const int userIndexB = pManifold->getBody1()->getUserIndex();
+        if (userIndexA == -1 || userIndexB == -1 || userIndexA == userIndexB)
+        {
+            continue;
+        }
+
+        // Manifolds keep points which are within the contact breaking threshold, so only count the pair if the objects actually touch.
+        const int numContacts = pManifold->getNumContacts();
+        for (int j = 0; j < numContacts; j++)
+        {
+            if (pManifold->getContactPoint(j).getDistance() <= 0.0f)
+            {
+                m_CurrentPairs.push_back(MakePairKey(userIndexA, userIndexB));
+                break;
+            }
+        }
+    }
+
+    // An entity can have several collision objects (e.g. landscape chunks), so the same pair can show up more than once.
+    std::sort(m_CurrentPairs.begin(), m_CurrentPairs.end());
+    m_CurrentPairs.erase(std::unique(m_CurrentPairs.begin(), m_CurrentPairs.end()), m_CurrentPairs.end());
+
+    std::set_difference(m_CurrentPairs.begin(), m_CurrentPairs.end(), m_PreviousPairs.begin(), m_PreviousPairs.end(), std::back_inserter(m_ScratchPairs));
+    AppendEvents(ContactEventType::Begin);
+
+    std::set_difference(m_PreviousPairs.begin(), m_PreviousPairs.end(), m_CurrentPairs.begin(), m_CurrentPairs.end(), std::back_inserter(m_ScratchPairs));
+    AppendEvents(ContactEventType::End);
+
+    std::swap(m_PreviousPairs, m_CurrentPairs);
+    m_Steps++;
+}
+
+void ContactEventStream::EndUpdate(const entt::registry& registry)
+{
+    // Pairs touching both before and after the update persist, even if they separated for some of its steps.
+    if (m_PersistEventsEnabled && m_Steps > 0)
+    {
+        std::set_intersection(m_PreviousPairs.begin(), m_PreviousPairs.end(), m_UpdateStartPairs.begin(), m_UpdateStartPairs.end(), std::back_inserter(m_ScratchPairs));
+        AppendEvents(ContactEventType::Persist);
+    }
+
+    // Entities can be destroyed between updates, after which their pairs end on the next step.
+    for (ContactEvent& event : m_Events[static_cast<size_t>(ContactEventType::End)])
+    {
+        event.destroyed = !registry.valid(event.entityA) || !registry.valid(event.entityB);
+    }
+}
+
+void ContactEventStream::AppendEvents(ContactEventType type)
+{
+    std::vector<ContactEvent>& events = m_Events[static_cast<size_t>(type)];
+    events.reserve(events.size() + m_ScratchPairs.size());
+    for (uint64_t key : m_ScratchPairs)
+    {
+        events.push_back(PairKeyToEvent(key));
+    }
+    m_ScratchPairs.clear();
+}
+
+void ContactEventStream::Clear()
+{
+    for (std::vector<ContactEvent>& events : m_Events)
+    {
+        events.clear();
+    }
+}
+
+void ContactEventStream::RestoreTouchingPairs(std::span<const uint64_t> pairs)
+{
+    m_PreviousPairs.assign(pairs.begin(), pairs.end());
+    Clear();
+}
+
+uint64_t ContactEventStream::MakePairKey(int userIndexA, int userIndexB)
+{
+    const uint64_t a = static_cast<uint32_t>(std::min(userIndexA, userIndexB));
+    const uint64_t b = static_cast<uint32_t>(std::max(userIndexA, userIndexB));
+    return (a << 32) | b;
+}
+
+ContactEvent ContactEventStream::PairKeyToEvent(uint64_t key)
+{
+    ContactEvent event;
+    event.entityA = static_cast<EntityHandle>(static_cast<uint32_t>(key >> 32));
+    event.entityB = static_cast<EntityHandle>(static_cast<uint32_t>(key & 0xFFFFFFFF));
+    return event;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "scene/entity.hpp"
+
+class btDispatcher;
+
+namespace WingsOfSteel
+{
+
+enum class ContactEventType : uint8_t
+{
+    Begin,   // The entities started touching during the last update.
+    Persist, // The entities were already touching and still are. Only generated if persist events are enabled.
+    End,     // The entities stopped touching during the last update.
+
+    Count
+};
+
+struct ContactEvent
+{
+    EntityHandle entityA{ entt::null };
+    EntityHandle entityB{ entt::null };
+    // Set if either entity has been destroyed by the time the events are published. This is only ever the case for
+    // End events, whose pair stopped touching because one of its entities' collision objects was removed.
+    bool destroyed{ false };
+
+    bool Involves(EntityHandle entity) const { return entityA == entity || entityB == entity; }
+};
+
+// Read-only view over the contact events of a single type, following the style of EnTT's views:
+// it can be iterated directly, or with each() which receives both entities.
+class ContactEventView
+{
+public:
+    ContactEventView(const std::vector<ContactEvent>& events)
+        : m_Events(events)
+    {
+    }
+
+    auto begin() const { return m_Events.cbegin(); }
+    auto end() const { return m_Events.cend(); }
+    size_t size() const { return m_Events.size(); }
+    bool empty() const { return m_Events.empty(); }
+
+    template <typename Func>
+    void each(Func func) const
+    {
+        for (const ContactEvent& event : m_Events)
+        {
+            func(event.entityA, event.entityB);
+        }
+    }
+
+private:
+    const std::vector<ContactEvent>& m_Events;
+};
+
+// Builds contact events by comparing the pairs of entities touching after each simulation step with the previous step's.
+// Pairs are gathered from the dispatcher's manifolds in a single pass, so ghost objects don't need to track their own
+// overlapping pairs, and consumers only ever see the pairs which changed unless they ask for persist events.
+// Events from every step of an update are kept, in step order, so contacts lasting fewer steps than an update are
+// reported too: such a pair has both a Begin and an End event.
+class ContactEventStream
+{
+public:
+    ContactEventStream() {}
+
+    // Called around each update, and after each simulation step in between.
+    void BeginUpdate();
+    void OnStep(btDispatcher* pDispatcher);
+    void EndUpdate(const entt::registry& registry);
+    void Clear();
+
+    // Pairs touching after the last update, which the next update's events are relative to. Snapshots keep them so
+    // that a rollback doesn't report the contacts which changed between the snapshot and the rollback.
+    const std::vector<uint64_t>& GetTouchingPairs() const { return m_PreviousPairs; }
+    void RestoreTouchingPairs(std::span<const uint64_t> pairs);
+
+    ContactEventView GetEvents(ContactEventType type) const { return ContactEventView(m_Events[static_cast<size_t>(type)]); }
+
+    void SetPersistEventsEnabled(bool enabled) { m_PersistEventsEnabled = enabled; }
+    bool ArePersistEventsEnabled() const { return m_PersistEventsEnabled; }
+
+private:
+    static uint64_t MakePairKey(int userIndexA, int userIndexB);
+    static ContactEvent PairKeyToEvent(uint64_t key);
+    void AppendEvents(ContactEventType type);
+
+    std::vector<uint64_t> m_PreviousPairs;
+    std::vector<uint64_t> m_CurrentPairs;
+    std::vector<uint64_t> m_UpdateStartPairs; // Only kept for persist events.
+    std::vector<uint64_t> m_ScratchPairs;
+    std::array<std::vector<ContactEvent>, static_cast<size_t>(ContactEventType::Count)> m_Events;
+    uint32_t m_Steps{ 0 };
+    bool m_PersistEventsEnabled{ false };
+};
+
+} // namespace WingsOfSteel
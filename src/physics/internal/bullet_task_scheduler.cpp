@@ -0,0 +1,54 @@
+#include "physics/internal/bullet_task_scheduler.hpp"
+
+#if defined(TARGET_PLATFORM_NATIVE)
+
+#include <mutex>
+
+#include "core/task_scheduler.hpp"
+
+namespace WingsOfSteel
+{
+
+BulletTaskScheduler::BulletTaskScheduler(TaskScheduler* pTaskScheduler)
+    : btITaskScheduler("Pandora")
+    , m_pTaskScheduler(pTaskScheduler)
+{
+}
+
+int BulletTaskScheduler::getMaxNumThreads() const
+{
+    return static_cast<int>(m_pTaskScheduler->GetMaxThreadCount());
+}
+
+int BulletTaskScheduler::getNumThreads() const
+{
+    return static_cast<int>(m_pTaskScheduler->GetThreadCount());
+}
+
+void BulletTaskScheduler::setNumThreads(int numThreads)
+{
+    m_pTaskScheduler->SetThreadCount(static_cast<uint32_t>(numThreads));
+}
+
+void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+{
+    m_pTaskScheduler->ParallelFor(static_cast<size_t>(iBegin), static_cast<size_t>(iEnd), static_cast<size_t>(grainSize), [&body](size_t begin, size_t end) {
+        body.forLoop(static_cast<int>(begin), static_cast<int>(end));
+    });
+}
+
+btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+{
+    std::mutex sumMutex;
+    btScalar sum = 0;
+    m_pTaskScheduler->ParallelFor(static_cast<size_t>(iBegin), static_cast<size_t>(iEnd), static_cast<size_t>(grainSize), [&body, &sumMutex, &sum](size_t begin, size_t end) {
+        const btScalar partialSum = body.sumLoop(static_cast<int>(begin), static_cast<int>(end));
+        std::lock_guard<std::mutex> lock(sumMutex);
+        sum += partialSum;
+    });
+    return sum;
+}
+
+} // namespace WingsOfSteel
+
+#endif // TARGET_PLATFORM_NATIVE
@@ -0,0 +1,34 @@
+#pragma once
+
+// Multithreaded simulation is only supported on native builds.
+#if defined(TARGET_PLATFORM_NATIVE)
+
+#include <LinearMath/btThreads.h>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+class TaskScheduler;
+
+// Lets Bullet's multithreaded world run its parallel loops on the engine's TaskScheduler.
+DECLARE_SMART_PTR(BulletTaskScheduler);
+class BulletTaskScheduler : public btITaskScheduler
+{
+public:
+    BulletTaskScheduler(TaskScheduler* pTaskScheduler);
+
+    int getMaxNumThreads() const override;
+    int getNumThreads() const override;
+    void setNumThreads(int numThreads) override;
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+private:
+    TaskScheduler* m_pTaskScheduler{ nullptr };
+};
+
+} // namespace WingsOfSteel
+
+#endif // TARGET_PLATFORM_NATIVE
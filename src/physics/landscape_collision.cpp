@@ -0,0 +1,138 @@
+#include "physics/landscape_collision.hpp"
+
+#include <algorithm>
+
+#include <btBulletCollisionCommon.h>
+#include <xxhash.h>
+
+#include "scene/components/landscape_component.hpp"
+
+namespace WingsOfSteel
+{
+
+LandscapeCollision::LandscapeCollision(btCollisionWorld* pWorld, EntityHandle entity)
+    : m_pWorld(pWorld)
+    , m_Entity(entity)
+{
+}
+
+LandscapeCollision::~LandscapeCollision()
+{
+    Clear();
+}
+
+void LandscapeCollision::Update(const LandscapeComponent& landscapeComponent)
+{
+    if (landscapeComponent.Generation == m_Generation)
+    {
+        return;
+    }
+
+    m_Generation = landscapeComponent.Generation;
+
+    if (landscapeComponent.Width < 2 || landscapeComponent.Length < 2 || landscapeComponent.Heightmap.size() != landscapeComponent.Width * landscapeComponent.Length)
+    {
+        Clear();
+    }
+    else if (RequiresRebuild(landscapeComponent))
+    {
+        Rebuild(landscapeComponent);
+    }
+    else
+    {
+        Refresh(landscapeComponent);
+    }
+}
+
+bool LandscapeCollision::RequiresRebuild(const LandscapeComponent& landscapeComponent) const
+{
+    return m_Chunks.empty() || m_pHeightmapData != landscapeComponent.Heightmap.data() || m_Width != landscapeComponent.Width || m_Length != landscapeComponent.Length || m_Height != landscapeComponent.Height || m_WaterLevel != landscapeComponent.WaterLevel || m_CellSize != landscapeComponent.CellSize;
+}
+
+void LandscapeCollision::Rebuild(const LandscapeComponent& landscapeComponent)
+{
+    Clear();
+
+    m_pHeightmapData = landscapeComponent.Heightmap.data();
+    m_Width = landscapeComponent.Width;
+    m_Length = landscapeComponent.Length;
+    m_Height = landscapeComponent.Height;
+    m_WaterLevel = landscapeComponent.WaterLevel;
+    m_CellSize = landscapeComponent.CellSize;
+
+    // The heights are stored normalized, so the shape is built in the [0, 1] range and scaled to the landscape's height.
+    // Bullet centers a heightfield on its local origin, so the chunk's origin is offset to match the rendered geometry,
+    // where sample (x, z) sits at (x * CellSize - halfGridSize, height * Height - WaterLevel, z * CellSize - halfGridSize).
+    const glm::vec3 scale(m_CellSize, m_Height, m_CellSize);
+    const float halfGridSize = (m_Width * m_CellSize) / 2.0f;
+    const float originX = (m_Width - 1) * m_CellSize / 2.0f - halfGridSize;
+    const float originY = m_Height / 2.0f - m_WaterLevel;
+
+    const uint32_t lastRow = m_Length - 1;
+    for (uint32_t firstRow = 0; firstRow < lastRow; firstRow += sChunkRows)
+    {
+        Chunk chunk;
+        chunk.firstRow = firstRow;
+        chunk.rowCount = std::min(sChunkRows, lastRow - firstRow);
+        chunk.hash = CalculateChunkHash(landscapeComponent, chunk.firstRow, chunk.rowCount);
+
+        // Neighbouring chunks share their boundary row, so there are no gaps between them.
+        const float* pChunkHeights = m_pHeightmapData + static_cast<size_t>(chunk.firstRow) * m_Width;
+        chunk.pShape = std::make_unique<CollisionShapeHeightfield>(m_Width, chunk.rowCount + 1, pChunkHeights, 0.0f, 1.0f, scale);
+
+        const float originZ = (chunk.firstRow + chunk.rowCount / 2.0f) * m_CellSize - halfGridSize;
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(btVector3(originX, originY, originZ));
+
+        chunk.pCollisionObject = std::make_unique<btCollisionObject>();
+        chunk.pCollisionObject->setCollisionShape(chunk.pShape->GetBulletShape());
+        chunk.pCollisionObject->setWorldTransform(transform);
+        chunk.pCollisionObject->setCollisionFlags(chunk.pCollisionObject->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
+        chunk.pCollisionObject->setUserIndex(static_cast<int>(entt::to_integral(m_Entity)));
+        m_pWorld->addCollisionObject(chunk.pCollisionObject.get(), btBroadphaseProxy::StaticFilter, btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+
+        m_Chunks.push_back(std::move(chunk));
+    }
+}
+
+void LandscapeCollision::Refresh(const LandscapeComponent& landscapeComponent)
+{
+    for (Chunk& chunk : m_Chunks)
+    {
+        const uint64_t hash = CalculateChunkHash(landscapeComponent, chunk.firstRow, chunk.rowCount);
+        if (hash == chunk.hash)
+        {
+            continue;
+        }
+
+        chunk.hash = hash;
+        chunk.pShape->OnHeightsChanged();
+
+        // The chunk's bounds are fixed, so it stays in the broadphase, but any cached contacts against the old heights are stale.
+        btBroadphaseProxy* pProxy = chunk.pCollisionObject->getBroadphaseHandle();
+        if (pProxy)
+        {
+            m_pWorld->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(pProxy, m_pWorld->getDispatcher());
+        }
+    }
+}
+
+void LandscapeCollision::Clear()
+{
+    for (Chunk& chunk : m_Chunks)
+    {
+        m_pWorld->removeCollisionObject(chunk.pCollisionObject.get());
+    }
+    m_Chunks.clear();
+    m_pHeightmapData = nullptr;
+}
+
+uint64_t LandscapeCollision::CalculateChunkHash(const LandscapeComponent& landscapeComponent, uint32_t firstRow, uint32_t rowCount) const
+{
+    const float* pChunkHeights = landscapeComponent.Heightmap.data() + static_cast<size_t>(firstRow) * landscapeComponent.Width;
+    const size_t numBytes = static_cast<size_t>(rowCount + 1) * landscapeComponent.Width * sizeof(float);
+    return XXH3_64bits(pChunkHeights, numBytes);
+}
+
+} // namespace WingsOfSteel
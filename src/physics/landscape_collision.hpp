@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/smart_ptr.hpp"
+#include "physics/collision_shape.hpp"
+#include "scene/entity.hpp"
+
+class btCollisionObject;
+class btCollisionWorld;
+
+namespace WingsOfSteel
+{
+
+class LandscapeComponent;
+
+// Static collision for a landscape, built as strips of heightfield chunks which read directly from the
+// LandscapeComponent's heightmap. Each strip spans the landscape's full width, so its heights are contiguous
+// in the heightmap and can be shared rather than copied.
+// When the landscape is regenerated with the same dimensions, only the chunks whose heights changed are refreshed.
+DECLARE_SMART_PTR(LandscapeCollision);
+class LandscapeCollision
+{
+public:
+    LandscapeCollision(btCollisionWorld* pWorld, EntityHandle entity);
+    ~LandscapeCollision();
+
+    void Update(const LandscapeComponent& landscapeComponent);
+
+private:
+    bool RequiresRebuild(const LandscapeComponent& landscapeComponent) const;
+    void Rebuild(const LandscapeComponent& landscapeComponent);
+    void Refresh(const LandscapeComponent& landscapeComponent);
+    void Clear();
+    uint64_t CalculateChunkHash(const LandscapeComponent& landscapeComponent, uint32_t firstRow, uint32_t rowCount) const;
+
+    static constexpr uint32_t sChunkRows = 32;
+
+    struct Chunk
+    {
+        CollisionShapeHeightfieldUniquePtr pShape;
+        std::unique_ptr<btCollisionObject> pCollisionObject;
+        uint32_t firstRow{ 0 };
+        uint32_t rowCount{ 0 };
+        uint64_t hash{ 0 };
+    };
+
+    btCollisionWorld* m_pWorld{ nullptr };
+    EntityHandle m_Entity{ entt::null };
+    std::vector<Chunk> m_Chunks;
+    uint32_t m_Generation{ 0 };
+
+    // Parameters the chunks were built with; if any of these change, all chunks need to be rebuilt.
+    const float* m_pHeightmapData{ nullptr };
+    uint32_t m_Width{ 0 };
+    uint32_t m_Length{ 0 };
+    float m_Height{ 0.0f };
+    float m_WaterLevel{ 0.0f };
+    float m_CellSize{ 0.0f };
+};
+
+} // namespace WingsOfSteel
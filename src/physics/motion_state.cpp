@@ -0,0 +1,69 @@
+#include "physics/motion_state.hpp"
+
+#include <algorithm>
+
+namespace WingsOfSteel
+{
+
+MotionState::MotionState(const btTransform& worldTransform)
+{
+    Teleport(worldTransform);
+}
+
+void MotionState::getWorldTransform(btTransform& worldTransform) const
+{
+    worldTransform = m_WorldTransform;
+}
+
+void MotionState::setWorldTransform(const btTransform& worldTransform)
+{
+    m_WorldTransform = worldTransform;
+    m_PreviousPosition = m_CurrentPosition;
+    m_PreviousRotation = m_CurrentRotation;
+
+    const btVector3& origin = worldTransform.getOrigin();
+    const btQuaternion rotation = worldTransform.getRotation();
+    m_CurrentPosition = glm::vec3(origin.x(), origin.y(), origin.z());
+    m_CurrentRotation = glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z());
+
+    MarkMoved();
+}
+
+void MotionState::Teleport(const btTransform& worldTransform)
+{
+    setWorldTransform(worldTransform);
+    m_PreviousPosition = m_CurrentPosition;
+    m_PreviousRotation = m_CurrentRotation;
+}
+
+void MotionState::Bind(EntityHandle entity, std::vector<MotionState*>* pMovedMotionStates)
+{
+    m_Entity = entity;
+    m_pMovedMotionStates = pMovedMotionStates;
+
+    // Newly bound motion states always need their transform written out at least once.
+    MarkMoved();
+}
+
+void MotionState::Unbind()
+{
+    if (m_pMovedMotionStates && m_Moved)
+    {
+        m_pMovedMotionStates->erase(std::remove(m_pMovedMotionStates->begin(), m_pMovedMotionStates->end(), this), m_pMovedMotionStates->end());
+    }
+
+    m_Entity = entt::null;
+    m_pMovedMotionStates = nullptr;
+    m_Moved = false;
+}
+
+void MotionState::MarkMoved()
+{
+    if (m_pMovedMotionStates && !m_Moved)
+    {
+        m_pMovedMotionStates->push_back(this);
+        m_Moved = true;
+    }
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include <LinearMath/btMotionState.h>
+#include <LinearMath/btTransform.h>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include "scene/entity.hpp"
+
+namespace WingsOfSteel
+{
+
+// Motion state which keeps a body's transform at both the previous and the current simulation tick,
+// so the transform can be interpolated when the frame rate doesn't match the tick rate.
+// Bullet only calls setWorldTransform() for active bodies, so once bound to a list, the motion state
+// adds itself to it whenever it moves. This lets the simulation system process only the bodies which moved.
+class MotionState : public btMotionState
+{
+public:
+    BT_DECLARE_ALIGNED_ALLOCATOR();
+
+    MotionState(const btTransform& worldTransform);
+    ~MotionState() override {}
+
+    void getWorldTransform(btTransform& worldTransform) const override;
+    void setWorldTransform(const btTransform& worldTransform) override;
+
+    // Moves the body without interpolating from its previous transform.
+    void Teleport(const btTransform& worldTransform);
+
+    void Bind(EntityHandle entity, std::vector<MotionState*>* pMovedMotionStates);
+    void Unbind();
+
+    EntityHandle GetEntity() const { return m_Entity; }
+    const glm::vec3& GetPreviousPosition() const { return m_PreviousPosition; }
+    const glm::vec3& GetCurrentPosition() const { return m_CurrentPosition; }
+    const glm::quat& GetPreviousRotation() const { return m_PreviousRotation; }
+    const glm::quat& GetCurrentRotation() const { return m_CurrentRotation; }
+
+    // Set while the motion state is in its moved list, to avoid adding it more than once.
+    bool IsMoved() const { return m_Moved; }
+    void ClearMoved() { m_Moved = false; }
+
+    // Set while the simulation system is interpolating this motion state.
+    bool IsInterpolated() const { return m_Interpolated; }
+    void SetInterpolated(bool interpolated) { m_Interpolated = interpolated; }
+
+private:
+    void MarkMoved();
+
+    btTransform m_WorldTransform;
+    glm::vec3 m_PreviousPosition{ 0.0f };
+    glm::vec3 m_CurrentPosition{ 0.0f };
+    glm::quat m_PreviousRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::quat m_CurrentRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    EntityHandle m_Entity{ entt::null };
+    std::vector<MotionState*>* m_pMovedMotionStates{ nullptr };
+    bool m_Moved{ false };
+    bool m_Interpolated{ false };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "scene/entity.hpp"
+
+namespace WingsOfSteel
+{
+
+class CollisionShape;
+
+// Queries used by PhysicsSimulationSystem's batched query functions.
+// Each query reports the closest hit into the matching QueryHit. Objects belonging to ignoredEntity are skipped,
+// which is useful to stop e.g. a projectile from hitting the ship which fired it.
+
+struct RayQuery
+{
+    glm::vec3 from{ 0.0f };
+    glm::vec3 to{ 0.0f };
+    EntityHandle ignoredEntity{ entt::null };
+};
+
+struct SphereCastQuery
+{
+    glm::vec3 from{ 0.0f };
+    glm::vec3 to{ 0.0f };
+    float radius{ 1.0f };
+    EntityHandle ignoredEntity{ entt::null };
+};
+
+// The shape must be convex, and must outlive the query.
+struct ConvexSweepQuery
+{
+    const CollisionShape* pShape{ nullptr };
+    glm::mat4 from{ 1.0f };
+    glm::mat4 to{ 1.0f };
+    EntityHandle ignoredEntity{ entt::null };
+};
+
+enum class QueryStatus : uint8_t
+{
+    Ok,
+    InvalidShape // The query's shape is missing or isn't convex, so nothing was tested.
+};
+
+struct QueryHit
+{
+    QueryStatus status{ QueryStatus::Ok };
+    bool hit{ false };
+    EntityHandle entity{ entt::null };
+    glm::vec3 position{ 0.0f };
+    glm::vec3 normal{ 0.0f };
+    float fraction{ 1.0f }; // Fraction along the query's path at which the hit occurred.
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,77 @@
+#include "physics/physics_snapshot.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#include "core/log.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr uint32_t sPhysicsSnapshotMagic = 0x53485950; // "PHYS"
+
+void PhysicsSnapshot::Clear()
+{
+    m_Bodies.clear();
+    m_ContactPairs.clear();
+    m_Accumulator = 0.0f;
+    m_SolverSeed = 0;
+}
+
+size_t PhysicsSnapshot::GetDataSize() const
+{
+    return sizeof(Header) + m_Bodies.size() * sizeof(PhysicsBodyState) + m_ContactPairs.size() * sizeof(uint64_t);
+}
+
+void PhysicsSnapshot::WriteData(std::span<uint8_t> data) const
+{
+    assert(data.size() >= GetDataSize());
+
+    const Header header{ sPhysicsSnapshotMagic, static_cast<uint32_t>(m_Bodies.size()), static_cast<uint32_t>(m_ContactPairs.size()), m_Accumulator, m_SolverSeed };
+    memcpy(data.data(), &header, sizeof(Header));
+    const size_t bodiesSize = m_Bodies.size() * sizeof(PhysicsBodyState);
+    if (!m_Bodies.empty())
+    {
+        memcpy(data.data() + sizeof(Header), m_Bodies.data(), bodiesSize);
+    }
+    if (!m_ContactPairs.empty())
+    {
+        memcpy(data.data() + sizeof(Header) + bodiesSize, m_ContactPairs.data(), m_ContactPairs.size() * sizeof(uint64_t));
+    }
+}
+
+bool PhysicsSnapshot::ReadData(std::span<const uint8_t> data)
+{
+    Header header;
+    if (data.size() < sizeof(Header))
+    {
+        Log::Warning() << "Physics snapshot is too small to be valid.";
+        return false;
+    }
+
+    memcpy(&header, data.data(), sizeof(Header));
+    const size_t bodiesSize = header.bodyCount * sizeof(PhysicsBodyState);
+    const size_t contactPairsSize = header.contactPairCount * sizeof(uint64_t);
+    if (header.magic != sPhysicsSnapshotMagic || data.size() != sizeof(Header) + bodiesSize + contactPairsSize)
+    {
+        Log::Warning() << "Physics snapshot data is invalid.";
+        return false;
+    }
+
+    m_Accumulator = header.accumulator;
+    m_SolverSeed = header.solverSeed;
+    m_Bodies.resize(header.bodyCount);
+    if (header.bodyCount > 0)
+    {
+        memcpy(m_Bodies.data(), data.data() + sizeof(Header), bodiesSize);
+    }
+
+    m_ContactPairs.resize(header.contactPairCount);
+    if (header.contactPairCount > 0)
+    {
+        memcpy(m_ContactPairs.data(), data.data() + sizeof(Header) + bodiesSize, contactPairsSize);
+    }
+    return true;
+}
+
+} // namespace WingsOfSteel
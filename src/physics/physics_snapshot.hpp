@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include "scene/entity.hpp"
+
+namespace WingsOfSteel
+{
+
+// State of a single dynamic or kinematic body. Plain data, so a snapshot can be copied as a block of bytes.
+struct PhysicsBodyState
+{
+    EntityHandle entity{ entt::null };
+    int32_t activationState{ 0 };
+    float deactivationTime{ 0.0f };
+    glm::vec3 position{ 0.0f };
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 linearVelocity{ 0.0f };
+    glm::vec3 angularVelocity{ 0.0f };
+};
+
+static_assert(std::is_trivially_copyable_v<PhysicsBodyState>);
+
+// Captured by PhysicsSimulationSystem::CaptureSnapshot(). Snapshots are meant to be kept around and reused, e.g. one
+// per tick in a rollback buffer, so capturing into an existing snapshot doesn't allocate once it has grown large enough.
+// The binary data uses the native layout, so it can only be exchanged between builds of the same platform.
+class PhysicsSnapshot
+{
+public:
+    PhysicsSnapshot() = default;
+    ~PhysicsSnapshot() = default;
+
+    void Clear();
+
+    const std::vector<PhysicsBodyState>& GetBodies() const { return m_Bodies; }
+    std::vector<PhysicsBodyState>& GetBodies() { return m_Bodies; }
+    // Pairs of entities touching when the snapshot was captured, as kept by ContactEventStream.
+    const std::vector<uint64_t>& GetContactPairs() const { return m_ContactPairs; }
+    std::vector<uint64_t>& GetContactPairs() { return m_ContactPairs; }
+    float GetAccumulator() const { return m_Accumulator; }
+    void SetAccumulator(float accumulator) { m_Accumulator = accumulator; }
+    // Random seed of the single threaded solver, which it advances while solving.
+    uint64_t GetSolverSeed() const { return m_SolverSeed; }
+    void SetSolverSeed(uint64_t solverSeed) { m_SolverSeed = solverSeed; }
+
+    size_t GetDataSize() const;
+    void WriteData(std::span<uint8_t> data) const;
+    bool ReadData(std::span<const uint8_t> data);
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t bodyCount;
+        uint32_t contactPairCount;
+        float accumulator;
+        uint64_t solverSeed;
+    };
+
+    std::vector<PhysicsBodyState> m_Bodies;
+    std::vector<uint64_t> m_ContactPairs;
+    float m_Accumulator{ 0.0f };
+    uint64_t m_SolverSeed{ 0 };
+};
+
+} // namespace WingsOfSteel
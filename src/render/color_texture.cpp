@@ -3,11 +3,11 @@
 namespace WingsOfSteel
 {
 
-ColorTexture::ColorTexture(wgpu::Device& device, uint32_t width, uint32_t height, wgpu::TextureFormat format, uint32_t sampleCount, const std::string& label)
+ColorTexture::ColorTexture(wgpu::Device& device, uint32_t width, uint32_t height, wgpu::TextureFormat format, uint32_t sampleCount, const std::string& label, wgpu::TextureUsage additionalUsage)
 {
     wgpu::TextureDescriptor textureDesc{
         .label = label.c_str(),
-        .usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding,
+        .usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding | additionalUsage,
         .dimension = wgpu::TextureDimension::e2D,
         .size{
             .width = width,
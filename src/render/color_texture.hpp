@@ -10,7 +10,7 @@ class ColorTexture
 {
 public:
     ColorTexture() = default;
-    ColorTexture(wgpu::Device& device, uint32_t width, uint32_t height, wgpu::TextureFormat format, uint32_t sampleCount, const std::string& label);
+    ColorTexture(wgpu::Device& device, uint32_t width, uint32_t height, wgpu::TextureFormat format, uint32_t sampleCount, const std::string& label, wgpu::TextureUsage additionalUsage = wgpu::TextureUsage::None);
     ~ColorTexture() = default;
 
     inline wgpu::Texture& GetTexture() { return m_Texture; }
@@ -0,0 +1,119 @@
+#include "render/frame_readback.hpp"
+
+#include <cstring>
+
+#include "core/log.hpp"
+#include "pandora.hpp"
+#include "render/rendersystem.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr uint32_t sBytesPerRowAlignment = 256;
+
+FrameReadback::FrameReadback(uint32_t width, uint32_t height)
+    : m_Width(width)
+    , m_Height(height)
+{
+    const uint32_t bytesPerRow = width * sBytesPerPixel;
+    m_BytesPerRow = (bytesPerRow + sBytesPerRowAlignment - 1) / sBytesPerRowAlignment * sBytesPerRowAlignment;
+
+    wgpu::BufferDescriptor bufferDescriptor{
+        .label = "Frame readback buffer",
+        .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+        .size = static_cast<uint64_t>(m_BytesPerRow) * height
+    };
+    m_Buffer = GetRenderSystem()->GetDevice().CreateBuffer(&bufferDescriptor);
+}
+
+FrameReadback::~FrameReadback()
+{
+    // A readback still being mapped keeps the buffer alive, and OnMapped() would then run on a deleted FrameReadback.
+    // Destroying it runs OnMapped() right away, with a cancelled status.
+    if (m_Buffer)
+    {
+        m_Buffer.Destroy();
+    }
+}
+
+void FrameReadback::Encode(wgpu::CommandEncoder& encoder, const wgpu::Texture& texture)
+{
+    if (m_State != State::Free)
+    {
+        return;
+    }
+
+    wgpu::ImageCopyTexture source{
+        .texture = texture
+    };
+
+    wgpu::ImageCopyBuffer destination{
+        .layout = wgpu::TextureDataLayout{
+            .bytesPerRow = m_BytesPerRow,
+            .rowsPerImage = m_Height },
+        .buffer = m_Buffer
+    };
+
+    wgpu::Extent3D size{
+        .width = m_Width,
+        .height = m_Height,
+        .depthOrArrayLayers = 1
+    };
+
+    encoder.CopyTextureToBuffer(&source, &destination, &size);
+    m_State = State::Encoded;
+}
+
+void FrameReadback::OnSubmitted()
+{
+    if (m_State != State::Encoded)
+    {
+        return;
+    }
+
+    m_State = State::Mapping;
+    m_Buffer.MapAsync(wgpu::MapMode::Read, 0, m_Buffer.GetSize(), &FrameReadback::OnMapped, this);
+}
+
+void FrameReadback::WaitForPixels()
+{
+#if defined(TARGET_PLATFORM_NATIVE)
+    while (m_State == State::Mapping)
+    {
+        GetRenderSystem()->GetInstance().ProcessEvents();
+    }
+#elif defined(TARGET_PLATFORM_WEB)
+    // The mapping can only complete once control has returned to the browser.
+    Log::Warning(Log::Category::Render) << "Waiting for frame readbacks isn't supported on the web.";
+#endif
+}
+
+void FrameReadback::OnMapped(WGPUBufferMapAsyncStatus status, void* pUserData)
+{
+    FrameReadback* pReadback = reinterpret_cast<FrameReadback*>(pUserData);
+    if (status == WGPUBufferMapAsyncStatus_Success)
+    {
+        pReadback->ReadPixels();
+        pReadback->m_Buffer.Unmap();
+    }
+    pReadback->m_State = State::Free;
+}
+
+void FrameReadback::ReadPixels()
+{
+    const uint8_t* pData = static_cast<const uint8_t*>(m_Buffer.GetConstMappedRange(0, m_Buffer.GetSize()));
+    if (pData == nullptr)
+    {
+        return;
+    }
+
+    const size_t packedBytesPerRow = static_cast<size_t>(m_Width) * sBytesPerPixel;
+    m_Pixels.resize(packedBytesPerRow * m_Height);
+    for (uint32_t row = 0; row < m_Height; row++)
+    {
+        memcpy(m_Pixels.data() + row * packedBytesPerRow, pData + static_cast<size_t>(row) * m_BytesPerRow, packedBytesPerRow);
+    }
+    m_FrameCount++;
+}
+
+} // namespace WingsOfSteel
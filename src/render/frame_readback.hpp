@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+//////////////////////////////////////////////////////////////////////////
+// FrameReadback
+// Copies the frames rendered by an offscreen window into a readback
+// buffer, which is mapped asynchronously once the frame has been
+// submitted. There is a single buffer: frames rendered while the previous
+// one is still being mapped aren't read back, unless WaitForPixels() is
+// called in between, as image tests do.
+//////////////////////////////////////////////////////////////////////////
+
+DECLARE_SMART_PTR(FrameReadback);
+class FrameReadback
+{
+public:
+    FrameReadback(uint32_t width, uint32_t height);
+    ~FrameReadback();
+
+    // Must be called before the encoder is finished.
+    void Encode(wgpu::CommandEncoder& encoder, const wgpu::Texture& texture);
+    // Must be called once the frame's command buffer has been submitted.
+    void OnSubmitted();
+    // Blocks until the frame being read back, if any, is available.
+    void WaitForPixels();
+
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+
+    // Tightly packed RGBA8 rows of the most recent frame which has been read back, or empty until one has.
+    const std::vector<uint8_t>& GetPixels() const { return m_Pixels; }
+    // Number of frames read back so far, to tell whether the pixels have changed.
+    uint64_t GetFrameCount() const { return m_FrameCount; }
+
+    static constexpr uint32_t sBytesPerPixel = 4;
+
+private:
+    enum class State
+    {
+        Free,
+        Encoded,
+        Mapping
+    };
+
+    static void OnMapped(WGPUBufferMapAsyncStatus status, void* pUserData);
+    void ReadPixels();
+
+    uint32_t m_Width{ 0 };
+    uint32_t m_Height{ 0 };
+    uint32_t m_BytesPerRow{ 0 }; // Rows of texture copies must be aligned to 256 bytes in the buffer.
+    wgpu::Buffer m_Buffer;
+    State m_State{ State::Free };
+    std::vector<uint8_t> m_Pixels;
+    uint64_t m_FrameCount{ 0 };
+};
+
+} // namespace WingsOfSteel
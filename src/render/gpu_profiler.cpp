@@ -0,0 +1,175 @@
+#include "render/gpu_profiler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "core/log.hpp"
+#include "core/profiler.hpp"
+#include "pandora.hpp"
+#include "render/rendersystem.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr uint32_t sQueryCount = GpuProfiler::sMaxPasses * 2;
+static constexpr uint64_t sQueryBufferSize = sQueryCount * sizeof(uint64_t);
+
+GpuProfiler::GpuProfiler()
+{
+    wgpu::Device& device = GetRenderSystem()->GetDevice();
+    m_Supported = device.HasFeature(wgpu::FeatureName::TimestampQuery);
+    if (!m_Supported)
+    {
+        Log::Info(Log::Category::Render) << "Timestamp queries aren't supported by this device, GPU profiling is disabled.";
+        return;
+    }
+
+    wgpu::QuerySetDescriptor querySetDescriptor{
+        .label = "GPU profiler query set",
+        .type = wgpu::QueryType::Timestamp,
+        .count = sQueryCount
+    };
+    m_QuerySet = device.CreateQuerySet(&querySetDescriptor);
+
+    wgpu::BufferDescriptor resolveBufferDescriptor{
+        .label = "GPU profiler resolve buffer",
+        .usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc,
+        .size = sQueryBufferSize
+    };
+    m_ResolveBuffer = device.CreateBuffer(&resolveBufferDescriptor);
+
+    for (ReadbackSlot& slot : m_ReadbackSlots)
+    {
+        wgpu::BufferDescriptor readbackBufferDescriptor{
+            .label = "GPU profiler readback buffer",
+            .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+            .size = sQueryBufferSize
+        };
+        slot.pProfiler = this;
+        slot.buffer = device.CreateBuffer(&readbackBufferDescriptor);
+    }
+
+    for (uint32_t i = 0; i < sMaxPasses; i++)
+    {
+        m_TimestampWrites[i] = wgpu::RenderPassTimestampWrites{
+            .querySet = m_QuerySet,
+            .beginningOfPassWriteIndex = i * 2,
+            .endOfPassWriteIndex = i * 2 + 1
+        };
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    // Destroying the buffers cancels any pending mapping, whose callback must run while the slots still exist.
+    for (ReadbackSlot& slot : m_ReadbackSlots)
+    {
+        if (slot.buffer)
+        {
+            slot.buffer.Destroy();
+        }
+    }
+}
+
+void GpuProfiler::BeginFrame()
+{
+    m_pCurrentSlot = nullptr;
+    if (!m_Supported || !Profiler::IsEnabled())
+    {
+        return;
+    }
+
+    ReadbackSlot& slot = m_ReadbackSlots[m_NextSlot];
+    if (slot.state != ReadbackState::Free)
+    {
+        // The GPU is more than sReadbackSlotCount frames behind: skip timing this frame rather than waiting.
+        return;
+    }
+
+    slot.passNames.clear();
+    m_pCurrentSlot = &slot;
+    m_NextSlot = (m_NextSlot + 1) % sReadbackSlotCount;
+}
+
+const wgpu::RenderPassTimestampWrites* GpuProfiler::BeginPass(const std::string& name)
+{
+    if (m_pCurrentSlot == nullptr || m_pCurrentSlot->passNames.size() >= sMaxPasses)
+    {
+        return nullptr;
+    }
+
+    const size_t index = m_pCurrentSlot->passNames.size();
+    m_pCurrentSlot->passNames.push_back(name);
+    return &m_TimestampWrites[index];
+}
+
+void GpuProfiler::EndFrame(wgpu::CommandEncoder& encoder)
+{
+    if (m_pCurrentSlot == nullptr || m_pCurrentSlot->passNames.empty())
+    {
+        m_pCurrentSlot = nullptr;
+        return;
+    }
+
+    const uint32_t queryCount = static_cast<uint32_t>(m_pCurrentSlot->passNames.size()) * 2;
+    encoder.ResolveQuerySet(m_QuerySet, 0, queryCount, m_ResolveBuffer, 0);
+    encoder.CopyBufferToBuffer(m_ResolveBuffer, 0, m_pCurrentSlot->buffer, 0, queryCount * sizeof(uint64_t));
+    m_pCurrentSlot->state = ReadbackState::Encoded;
+}
+
+void GpuProfiler::OnSubmitted()
+{
+    if (m_pCurrentSlot == nullptr)
+    {
+        return;
+    }
+
+    ReadbackSlot* pSlot = m_pCurrentSlot;
+    m_pCurrentSlot = nullptr;
+    pSlot->state = ReadbackState::Mapping;
+    pSlot->buffer.MapAsync(wgpu::MapMode::Read, 0, pSlot->passNames.size() * 2 * sizeof(uint64_t), &GpuProfiler::OnReadbackMapped, pSlot);
+}
+
+void GpuProfiler::OnReadbackMapped(WGPUBufferMapAsyncStatus status, void* pUserData)
+{
+    ReadbackSlot* pSlot = reinterpret_cast<ReadbackSlot*>(pUserData);
+    if (status == WGPUBufferMapAsyncStatus_Success)
+    {
+        pSlot->pProfiler->ReadTimings(*pSlot);
+        pSlot->buffer.Unmap();
+    }
+    pSlot->state = ReadbackState::Free;
+}
+
+void GpuProfiler::ReadTimings(ReadbackSlot& slot)
+{
+    const size_t passCount = slot.passNames.size();
+    const uint64_t* pTimestamps = static_cast<const uint64_t*>(slot.buffer.GetConstMappedRange(0, passCount * 2 * sizeof(uint64_t)));
+    if (pTimestamps == nullptr)
+    {
+        return;
+    }
+
+    // Passes which didn't use their timestamp writes leave their queries at zero.
+    uint64_t frameStart = UINT64_MAX;
+    for (size_t i = 0; i < passCount; i++)
+    {
+        if (pTimestamps[i * 2] != 0 && pTimestamps[i * 2 + 1] >= pTimestamps[i * 2])
+        {
+            frameStart = std::min(frameStart, pTimestamps[i * 2]);
+        }
+    }
+
+    m_PassTimings.clear();
+    for (size_t i = 0; i < passCount; i++)
+    {
+        const uint64_t start = pTimestamps[i * 2];
+        const uint64_t end = pTimestamps[i * 2 + 1];
+        if (start != 0 && end >= start)
+        {
+            m_PassTimings.push_back(GpuPassTiming{ .name = slot.passNames[i], .start = start - frameStart, .end = end - frameStart });
+        }
+    }
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+struct GpuPassTiming
+{
+    std::string name;
+    uint64_t start{ 0 }; // Nanoseconds, relative to the start of the first timed pass of the frame.
+    uint64_t end{ 0 };
+};
+
+//////////////////////////////////////////////////////////////////////////
+// GpuProfiler
+// Times each render pass on the GPU with timestamp queries, written at the
+// beginning and end of the pass. The queries are resolved into one of a
+// few readback buffers, which is mapped asynchronously once the frame has
+// been submitted: if every buffer is still in flight, the frame is simply
+// not timed, so the CPU never waits on the GPU.
+// Timings are only recorded while the CPU profiler is enabled, and not at
+// all if the device doesn't support the timestamp-query feature.
+//////////////////////////////////////////////////////////////////////////
+
+DECLARE_SMART_PTR(GpuProfiler);
+class GpuProfiler
+{
+public:
+    GpuProfiler();
+    ~GpuProfiler();
+
+    void BeginFrame();
+    // Returns the timestamp writes to set on the pass' descriptor, or nullptr if the pass isn't being timed.
+    const wgpu::RenderPassTimestampWrites* BeginPass(const std::string& name);
+    // Must be called before the encoder is finished.
+    void EndFrame(wgpu::CommandEncoder& encoder);
+    // Must be called once the frame's command buffer has been submitted.
+    void OnSubmitted();
+
+    bool IsSupported() const { return m_Supported; }
+
+    // Timings of the most recent frame whose queries have been read back.
+    const std::vector<GpuPassTiming>& GetPassTimings() const { return m_PassTimings; }
+
+    static constexpr uint32_t sMaxPasses = 16;
+
+private:
+    enum class ReadbackState
+    {
+        Free,
+        Encoded,
+        Mapping
+    };
+
+    struct ReadbackSlot
+    {
+        GpuProfiler* pProfiler{ nullptr };
+        wgpu::Buffer buffer;
+        ReadbackState state{ ReadbackState::Free };
+        std::vector<std::string> passNames;
+    };
+
+    static void OnReadbackMapped(WGPUBufferMapAsyncStatus status, void* pUserData);
+    void ReadTimings(ReadbackSlot& slot);
+
+    static constexpr size_t sReadbackSlotCount = 3;
+
+    bool m_Supported{ false };
+    wgpu::QuerySet m_QuerySet;
+    wgpu::Buffer m_ResolveBuffer;
+    std::array<ReadbackSlot, sReadbackSlotCount> m_ReadbackSlots;
+    std::array<wgpu::RenderPassTimestampWrites, sMaxPasses> m_TimestampWrites;
+    ReadbackSlot* m_pCurrentSlot{ nullptr }; // Slot for the frame being encoded, if it is being timed.
+    size_t m_NextSlot{ 0 };
+    std::vector<GpuPassTiming> m_PassTimings;
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace WingsOfSteel
+{
+
+enum class RenderAdapter
+{
+    Default, // The high performance adapter, if there is one.
+    Fallback, // Dawn's CPU adapter (SwiftShader), which requires Dawn to have been built with SwiftShader support.
+    Null // Dawn's null backend: every GPU command is accepted and discarded.
+};
+
+class HeadlessSettings
+{
+public:
+    HeadlessSettings() {}
+    ~HeadlessSettings() {}
+
+    void SetAdapter(RenderAdapter adapter);
+    RenderAdapter GetAdapter() const;
+
+    // Frames are only rendered if there is a render target, in which case GetWindow() returns an offscreen window.
+    void SetRenderTarget(uint32_t width, uint32_t height);
+    bool HasRenderTarget() const;
+    void GetRenderTargetSize(uint32_t& width, uint32_t& height) const;
+
+    // Copies every rendered frame back to the CPU, see FrameReadback.
+    void SetReadbackEnabled(bool enabled);
+    bool IsReadbackEnabled() const;
+
+private:
+    RenderAdapter m_Adapter{ RenderAdapter::Null };
+    uint32_t m_RenderTargetWidth{ 0 };
+    uint32_t m_RenderTargetHeight{ 0 };
+    bool m_ReadbackEnabled{ false };
+};
+
+inline void HeadlessSettings::SetAdapter(RenderAdapter adapter)
+{
+    m_Adapter = adapter;
+}
+
+inline RenderAdapter HeadlessSettings::GetAdapter() const
+{
+    return m_Adapter;
+}
+
+inline void HeadlessSettings::SetRenderTarget(uint32_t width, uint32_t height)
+{
+    m_RenderTargetWidth = width;
+    m_RenderTargetHeight = height;
+}
+
+inline bool HeadlessSettings::HasRenderTarget() const
+{
+    return m_RenderTargetWidth > 0 && m_RenderTargetHeight > 0;
+}
+
+inline void HeadlessSettings::GetRenderTargetSize(uint32_t& width, uint32_t& height) const
+{
+    width = m_RenderTargetWidth;
+    height = m_RenderTargetHeight;
+}
+
+inline void HeadlessSettings::SetReadbackEnabled(bool enabled)
+{
+    m_ReadbackEnabled = enabled;
+}
+
+inline bool HeadlessSettings::IsReadbackEnabled() const
+{
+    return m_ReadbackEnabled;
+}
+
+} // namespace WingsOfSteel
@@ -17,12 +17,9 @@ BaseRenderPass::BaseRenderPass()
 
 void BaseRenderPass::Render(wgpu::CommandEncoder& encoder)
 {
-    wgpu::SurfaceTexture surfaceTexture;
-    GetWindow()->GetSurface().GetCurrentTexture(&surfaceTexture);
-
     wgpu::RenderPassColorAttachment colorAttachment{
         .view = GetWindow()->GetMsaaColorTexture().GetTextureView(),
-        .resolveTarget = surfaceTexture.texture.CreateView(),
+        .resolveTarget = GetWindow()->GetCurrentTexture().CreateView(),
         .loadOp = wgpu::LoadOp::Clear,
         .storeOp = wgpu::StoreOp::Store,
         .clearValue = wgpu::Color{ 0.0, 0.0, 0.0, 1.0 }
@@ -38,7 +35,8 @@ void BaseRenderPass::Render(wgpu::CommandEncoder& encoder)
     wgpu::RenderPassDescriptor renderpass{
         .colorAttachmentCount = 1,
         .colorAttachments = &colorAttachment,
-        .depthStencilAttachment = &depthAttachment
+        .depthStencilAttachment = &depthAttachment,
+        .timestampWrites = GetTimestampWrites()
     };
 
     wgpu::RenderPassEncoder renderPass = encoder.BeginRenderPass(&renderpass);
@@ -22,8 +22,14 @@ public:
 
     const std::string& GetName() const { return m_Name; }
 
+    // Set by the RenderSystem before Render() is called. Passes should put it in their RenderPassDescriptor so they
+    // can be timed by the GPU profiler. Null if the pass isn't being timed.
+    void SetTimestampWrites(const wgpu::RenderPassTimestampWrites* pTimestampWrites) { m_pTimestampWrites = pTimestampWrites; }
+    const wgpu::RenderPassTimestampWrites* GetTimestampWrites() const { return m_pTimestampWrites; }
+
 private:
     std::string m_Name;
+    const wgpu::RenderPassTimestampWrites* m_pTimestampWrites{ nullptr };
 };
 
 } // namespace WingsOfSteel
\ No newline at end of file
@@ -17,25 +17,31 @@ UIRenderPass::UIRenderPass()
 
 void UIRenderPass::Render(wgpu::CommandEncoder& encoder)
 {
-    wgpu::SurfaceTexture surfaceTexture;
-    GetWindow()->GetSurface().GetCurrentTexture(&surfaceTexture);
-
     wgpu::RenderPassColorAttachment colorAttachment{
-        .view = surfaceTexture.texture.CreateView(),
+        .view = GetWindow()->GetCurrentTexture().CreateView(),
         .loadOp = wgpu::LoadOp::Load,
         .storeOp = wgpu::StoreOp::Store
     };
 
     wgpu::RenderPassDescriptor renderpass{
         .colorAttachmentCount = 1,
-        .colorAttachments = &colorAttachment
+        .colorAttachments = &colorAttachment,
+        .timestampWrites = GetTimestampWrites()
     };
 
     wgpu::RenderPassEncoder renderPass = encoder.BeginRenderPass(&renderpass);
     GetRenderSystem()->UpdateGlobalUniforms(renderPass);
 
-    GetDebugRender()->Render(renderPass);
-    GetImGuiSystem()->Render(renderPass);
+    // Headless engines render offscreen without debug rendering or UI.
+    if (GetDebugRender())
+    {
+        GetDebugRender()->Render(renderPass);
+    }
+
+    if (GetImGuiSystem())
+    {
+        GetImGuiSystem()->Render(renderPass);
+    }
 
     renderPass.End();
 }
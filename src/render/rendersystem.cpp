@@ -1,13 +1,17 @@
 #include "render/rendersystem.hpp"
 
 #include <cassert>
+#include <vector>
 
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <magic_enum.hpp>
 
 #include "core/log.hpp"
+#include "core/profiler.hpp"
 #include "pandora.hpp"
+#include "render/frame_readback.hpp"
+#include "render/gpu_profiler.hpp"
 #include "render/lighting/lighting_system.hpp"
 #include "render/render_pass/base_render_pass.hpp"
 #include "render/render_pass/ui_render_pass.hpp"
@@ -42,28 +46,30 @@ RenderSystem::~RenderSystem()
     glfwTerminate();
 }
 
-void RenderSystem::Initialize(OnRenderSystemInitializedCallback onInitializedCallback)
+void RenderSystem::Initialize(OnRenderSystemInitializedCallback onInitializedCallback, RenderAdapter adapter, bool headless)
 {
     g_OnRenderSystemInitializedCallback = onInitializedCallback;
+    m_Adapter = adapter;
+    m_Headless = headless;
 
     g_Instance = wgpu::CreateInstance();
     if (g_Instance)
     {
-        Log::Info() << "Initialized WebGPU.";
+        Log::Info(Log::Category::Render) << "Initialized WebGPU.";
     }
     else
     {
-        Log::Error() << "Failed to initialize WebGPU.";
+        Log::Error(Log::Category::Render) << "Failed to initialize WebGPU.";
         exit(-1);
     }
 
     AcquireDevice([](wgpu::Device device) {
         g_Device = device;
-        Log::Info() << "WebGPU device acquired.";
+        Log::Info(Log::Category::Render) << "WebGPU device acquired.";
 
-        if (!glfwInit())
+        if (!GetRenderSystem()->IsHeadless() && !glfwInit())
         {
-            Log::Error() << "Failed to initialize GLFW.";
+            Log::Error(Log::Category::Render) << "Failed to initialize GLFW.";
             exit(-1);
             return;
         }
@@ -82,6 +88,7 @@ void RenderSystem::InitializeInternal()
     m_pShaderCompiler = std::make_unique<ShaderCompiler>();
     m_pShaderEditor = std::make_unique<ShaderEditor>();
     m_pLightingSystem = std::make_unique<LightingSystem>();
+    m_pGpuProfiler = std::make_unique<GpuProfiler>();
 
     AddRenderPass(std::make_shared<BaseRenderPass>());
     AddRenderPass(std::make_shared<UIRenderPass>());
@@ -102,16 +109,35 @@ void RenderSystem::Update()
     };
     wgpu::CommandEncoder encoder = GetDevice().CreateCommandEncoder(&commandEncoderDescriptor);
 
-    for (auto& pRenderPass : m_RenderPasses)
     {
-        pRenderPass->Render(encoder);
+        PROFILE_SCOPE("Encode render passes");
+        m_pGpuProfiler->BeginFrame();
+        for (auto& pRenderPass : m_RenderPasses)
+        {
+            pRenderPass->SetTimestampWrites(m_pGpuProfiler->BeginPass(pRenderPass->GetName()));
+            pRenderPass->Render(encoder);
+        }
+        m_pGpuProfiler->EndFrame(encoder);
+    }
+
+    FrameReadback* pFrameReadback = GetWindow()->GetFrameReadback();
+    if (pFrameReadback)
+    {
+        pFrameReadback->Encode(encoder, GetWindow()->GetCurrentTexture());
     }
 
     wgpu::CommandBufferDescriptor commandBufferDescriptor{
         .label = "Pandora default command buffer"
     };
     wgpu::CommandBuffer commands = encoder.Finish(&commandBufferDescriptor);
+
+    PROFILE_SCOPE("Submit");
     GetDevice().GetQueue().Submit(1, &commands);
+    m_pGpuProfiler->OnSubmitted();
+    if (pFrameReadback)
+    {
+        pFrameReadback->OnSubmitted();
+    }
 }
 
 void RenderSystem::AddRenderPass(RenderPassSharedPtr pRenderPass)
@@ -164,6 +190,15 @@ void RenderSystem::AcquireDevice(void (*callback)(wgpu::Device))
         .powerPreference = wgpu::PowerPreference::HighPerformance
     };
 
+    if (m_Adapter == RenderAdapter::Fallback)
+    {
+        adapterOptions.forceFallbackAdapter = true;
+    }
+    else if (m_Adapter == RenderAdapter::Null)
+    {
+        adapterOptions.backendType = wgpu::BackendType::Null;
+    }
+
     g_Instance.RequestAdapter(
         &adapterOptions,
         // TODO(https://bugs.chromium.org/p/dawn/issues/detail?id=1892): Use
@@ -171,42 +206,59 @@ void RenderSystem::AcquireDevice(void (*callback)(wgpu::Device))
         [](WGPURequestAdapterStatus status, WGPUAdapter adapter, const char* message, void* userdata) {
             if (status != WGPURequestAdapterStatus_Success)
             {
-                Log::Error() << "Failed to request adapter, error code " << status;
+                Log::Error(Log::Category::Render) << "Failed to request adapter, error code " << status;
                 exit(-1);
             }
 
             g_Adapter = wgpu::Adapter::Acquire(adapter);
-            Log::Info() << "Adapter successfully requested.";
+            Log::Info(Log::Category::Render) << "Adapter successfully requested.";
 
             wgpu::AdapterProperties properties{};
             g_Adapter.GetProperties(&properties);
 
-            Log::Info() << "Adapter properties:";
+            Log::Info(Log::Category::Render) << "Adapter properties:";
             if (properties.vendorName)
             {
-                Log::Info() << " - Vendor name: " << properties.vendorName;
+                Log::Info(Log::Category::Render) << " - Vendor name: " << properties.vendorName;
             }
             if (properties.architecture)
             {
-                Log::Info() << " - Architecture: " << properties.architecture;
+                Log::Info(Log::Category::Render) << " - Architecture: " << properties.architecture;
             }
             if (properties.name)
             {
-                Log::Info() << " - Name: " << properties.name;
+                Log::Info(Log::Category::Render) << " - Name: " << properties.name;
             }
             if (properties.driverDescription)
             {
-                Log::Info() << " - Driver: " << properties.driverDescription;
+                Log::Info(Log::Category::Render) << " - Driver: " << properties.driverDescription;
+            }
+            Log::Info(Log::Category::Render) << " - Backend type: " << magic_enum::enum_name(properties.backendType);
+
+            // Timestamp queries are only used by the GPU profiler, which is disabled if they aren't available.
+            static const wgpu::FeatureName sOptionalFeatures[] = { wgpu::FeatureName::TimestampQuery };
+            static std::vector<wgpu::FeatureName> sRequiredFeatures;
+            sRequiredFeatures.clear();
+            for (wgpu::FeatureName feature : sOptionalFeatures)
+            {
+                if (g_Adapter.HasFeature(feature))
+                {
+                    sRequiredFeatures.push_back(feature);
+                }
             }
-            Log::Info() << " - Backend type: " << magic_enum::enum_name(properties.backendType);
+
+            wgpu::DeviceDescriptor deviceDescriptor{
+                .requiredFeatureCount = sRequiredFeatures.size(),
+                .requiredFeatures = sRequiredFeatures.data()
+            };
 
             g_Adapter.RequestDevice(
-                nullptr,
+                &deviceDescriptor,
                 [](WGPURequestDeviceStatus status, WGPUDevice cDevice, const char* message, void* userdata) {
                     wgpu::Device device = wgpu::Device::Acquire(cDevice);
                     device.SetUncapturedErrorCallback(
                         [](WGPUErrorType type, const char* message, void* userdata) {
-                            Log::Error() << "Uncaptured device error: " << type << " - message: " << message;
+                            Log::Error(Log::Category::Render) << "Uncaptured device error: " << type << " - message: " << message;
                             exit(-1);
                         },
                         nullptr);
@@ -289,7 +341,7 @@ void RenderSystem::UpdateGlobalUniforms(wgpu::RenderPassEncoder& renderPass)
         m_GlobalUniforms.cameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
     }
 
-    m_GlobalUniforms.time = static_cast<float>(glfwGetTime());
+    m_GlobalUniforms.time = GetTime();
     m_GlobalUniforms.windowWidth = static_cast<float>(GetWindow()->GetWidth());
     m_GlobalUniforms.windowHeight = static_cast<float>(GetWindow()->GetHeight());
 
@@ -321,6 +373,11 @@ const wgpu::VertexBufferLayout* RenderSystem::GetVertexBufferLayout(VertexFormat
     }
 }
 
+GpuProfiler* RenderSystem::GetGpuProfiler() const
+{
+    return m_pGpuProfiler.get();
+}
+
 LightingSystem* RenderSystem::GetLightingSystem() const
 {
     return m_pLightingSystem.get();
@@ -9,12 +9,14 @@
 #include <webgpu/webgpu_cpp.h>
 
 #include "core/smart_ptr.hpp"
+#include "render/headless_settings.hpp"
 #include "render/vertex_types.hpp"
 
 namespace WingsOfSteel
 {
 
 DECLARE_SMART_PTR(DebugRender);
+DECLARE_SMART_PTR(GpuProfiler);
 DECLARE_SMART_PTR(LightingSystem);
 DECLARE_SMART_PTR(MipLevelGenerator);
 DECLARE_SMART_PTR(RenderPass);
@@ -30,9 +32,12 @@ public:
     RenderSystem();
     ~RenderSystem();
 
-    void Initialize(OnRenderSystemInitializedCallback onInitializedCallback);
+    // Headless render systems don't initialize GLFW, so they can run on machines without a display.
+    void Initialize(OnRenderSystemInitializedCallback onInitializedCallback, RenderAdapter adapter = RenderAdapter::Default, bool headless = false);
     void Update();
 
+    bool IsHeadless() const { return m_Headless; }
+
     void AddRenderPass(RenderPassSharedPtr pRenderPass);
     const std::list<RenderPassSharedPtr>& GetRenderPasses() const;
     RenderPassSharedPtr GetRenderPass(const std::string& name) const;
@@ -45,6 +50,7 @@ public:
     wgpu::BindGroupLayout& GetGlobalUniformsLayout();
     const wgpu::VertexBufferLayout* GetVertexBufferLayout(VertexFormat vertexFormat) const;
 
+    GpuProfiler* GetGpuProfiler() const;
     LightingSystem* GetLightingSystem() const;
     MipLevelGenerator* GetMipLevelGenerator() const;
     ShaderCompiler* GetShaderCompiler() const;
@@ -75,6 +81,9 @@ private:
     };
     GlobalUniforms m_GlobalUniforms;
 
+    RenderAdapter m_Adapter{ RenderAdapter::Default };
+    bool m_Headless{ false };
+
     wgpu::Buffer m_GlobalUniformsBuffer;
     wgpu::BindGroup m_GlobalUniformsBindGroup;
     wgpu::BindGroupLayout m_GlobalUniformsBindGroupLayout;
@@ -85,6 +94,7 @@ private:
     std::list<RenderPassSharedPtr> m_RenderPasses;
     VertexBufferSchemasUniquePtr m_pVertexBufferSchemas;
 
+    GpuProfilerUniquePtr m_pGpuProfiler;
     LightingSystemUniquePtr m_pLightingSystem;
     MipLevelGeneratorUniquePtr m_pMipLevelGenerator;
 };
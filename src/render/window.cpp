@@ -80,10 +80,44 @@ Window::Window(const WindowSettings& windowSettings)
     ConfigureSurface();
 }
 
+Window::Window(const HeadlessSettings& headlessSettings)
+    : m_pWindow(nullptr)
+    , m_Offscreen(true)
+{
+    m_Title = "Offscreen";
+    headlessSettings.GetRenderTargetSize(m_Width, m_Height);
+
+    // There is no surface to dictate the format, so pick the one frame readbacks expect.
+    m_Format = wgpu::TextureFormat::RGBA8Unorm;
+
+    Log::Info() << "Configuring offscreen render target: ";
+    Log::Info() << "- Format: " << magic_enum::enum_name(m_Format);
+    Log::Info() << "- Resolution: " << m_Width << "x" << m_Height;
+
+    CreateRenderTargets();
+    SetReadbackEnabled(headlessSettings.IsReadbackEnabled());
+}
+
 Window::~Window()
 {
-    glfwDestroyWindow(m_pWindow);
-    m_pWindow = nullptr;
+    // Offscreen windows never initialized GLFW.
+    if (m_pWindow)
+    {
+        glfwDestroyWindow(m_pWindow);
+        m_pWindow = nullptr;
+    }
+}
+
+wgpu::Texture Window::GetCurrentTexture()
+{
+    if (m_Offscreen)
+    {
+        return m_OffscreenColorTexture.GetTexture();
+    }
+
+    wgpu::SurfaceTexture surfaceTexture;
+    m_Surface.GetCurrentTexture(&surfaceTexture);
+    return surfaceTexture.texture;
 }
 
 void Window::OnWindowResized(uint32_t width, uint32_t height)
@@ -97,6 +131,13 @@ void Window::OnWindowResized(uint32_t width, uint32_t height)
     m_Width = width;
     m_Height = height;
 
+    if (m_Offscreen)
+    {
+        CreateRenderTargets();
+        SetReadbackEnabled(m_pFrameReadback != nullptr);
+        return;
+    }
+
 #if defined(TARGET_PLATFORM_WEB)
     // On Web the underlying canvas has been resized, resize the GLFW window to match.
     glfwSetWindowSize(m_pWindow, m_Width, m_Height);
@@ -159,12 +200,29 @@ void Window::ConfigureSurface()
     };
     m_Surface.Configure(&config);
 
+    CreateRenderTargets();
+}
+
+void Window::CreateRenderTargets()
+{
     m_DepthTexture = DepthTexture(GetRenderSystem()->GetDevice(), m_Width, m_Height, std::string("Window depth buffer"));
     m_MsaaColorTexture = ColorTexture(GetRenderSystem()->GetDevice(), m_Width, m_Height, m_Format, RenderSystem::MsaaSampleCount, std::string("Window MSAA color buffer"));
+
+    if (m_Offscreen)
+    {
+        // Takes the place of the surface's texture: the MSAA color buffer is resolved into it.
+        m_OffscreenColorTexture = ColorTexture(GetRenderSystem()->GetDevice(), m_Width, m_Height, m_Format, 1, std::string("Window offscreen color buffer"), wgpu::TextureUsage::CopySrc);
+    }
 }
 
 void Window::SetVSyncEnabled(bool enabled)
 {
+    if (m_Offscreen)
+    {
+        m_VSyncEnabled = enabled;
+        return;
+    }
+
     if (m_VSyncEnabled != enabled)
     {
         m_VSyncEnabled = enabled;
@@ -177,4 +235,15 @@ bool Window::IsVSyncEnabled() const
     return m_VSyncEnabled;
 }
 
+void Window::SetReadbackEnabled(bool enabled)
+{
+    if (enabled && !m_Offscreen)
+    {
+        Log::Warning(Log::Category::Render) << "Frame readback is only available for offscreen windows.";
+        return;
+    }
+
+    m_pFrameReadback = enabled ? std::make_unique<FrameReadback>(m_Width, m_Height) : nullptr;
+}
+
 } // namespace WingsOfSteel
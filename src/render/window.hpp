@@ -4,6 +4,8 @@
 
 #include "render/color_texture.hpp"
 #include "render/depth_texture.hpp"
+#include "render/frame_readback.hpp"
+#include "render/headless_settings.hpp"
 #include "render/window_settings.hpp"
 
 struct GLFWwindow;
@@ -15,8 +17,13 @@ class Window
 {
 public:
     Window(const WindowSettings& windowSettings);
+    // Offscreen windows render to textures rather than to a surface, so they don't need a display.
+    Window(const HeadlessSettings& headlessSettings);
     ~Window();
 
+    bool IsOffscreen() const;
+    // The texture the current frame is rendered to: the surface's current texture, or the offscreen color texture.
+    wgpu::Texture GetCurrentTexture();
     wgpu::Surface GetSurface() const;
     wgpu::TextureFormat GetTextureFormat() const;
     GLFWwindow* GetRawWindow() const;
@@ -28,22 +35,35 @@ public:
     void SetVSyncEnabled(bool enabled);
     bool IsVSyncEnabled() const;
 
+    // Only offscreen windows can read their frames back.
+    void SetReadbackEnabled(bool enabled);
+    FrameReadback* GetFrameReadback() const;
+
     void OnWindowResized(uint32_t width, uint32_t height);
 
 private:
     void ConfigureSurface();
+    void CreateRenderTargets();
 
     GLFWwindow* m_pWindow{ nullptr };
+    bool m_Offscreen{ false };
     wgpu::Surface m_Surface;
     wgpu::TextureFormat m_Format;
     uint32_t m_Width{ 0 };
     uint32_t m_Height{ 0 };
     DepthTexture m_DepthTexture;
     ColorTexture m_MsaaColorTexture;
+    ColorTexture m_OffscreenColorTexture;
+    FrameReadbackUniquePtr m_pFrameReadback;
     bool m_VSyncEnabled = true;
     std::string m_Title;
 };
 
+inline bool Window::IsOffscreen() const
+{
+    return m_Offscreen;
+}
+
 inline wgpu::Surface Window::GetSurface() const
 {
     return m_Surface;
@@ -81,4 +101,9 @@ inline uint32_t Window::GetHeight() const
 
 inline ColorTexture& Window::GetMsaaColorTexture() { return m_MsaaColorTexture; }
 
+inline FrameReadback* Window::GetFrameReadback() const
+{
+    return m_pFrameReadback.get();
+}
+
 } // namespace WingsOfSteel
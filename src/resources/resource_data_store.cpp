@@ -61,7 +61,7 @@ void ResourceDataStore::Save()
     std::vector<uint8_t> data(dataDump.begin(), dataDump.end());
     if (GetVFS()->FileWrite(GetPath(), data))
     {
-        Log::Info() << "Saved data store '" << GetPath() << "'.";
+        Log::Verbose(Log::Category::Resources) << "Saved data store '" << GetPath() << "'.";
     }
 }
 
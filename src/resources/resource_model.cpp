@@ -635,17 +635,19 @@ void ResourceModel::SetupMeshes()
 
 void ResourceModel::SetupCollisionShape()
 {
+    // Each collision node becomes a convex hull, with its vertices in model space. Concave shapes are
+    // represented by several collision nodes, which are combined into a compound shape.
     std::vector<CollisionShapeConvexHullSharedPtr> collisionShapes;
-    for (auto& node : m_Nodes)
-    {
-        if (node.IsCollision())
-        {
+    std::function<void(const Node&, const glm::mat4&)> findCollisionNodes;
+    findCollisionNodes =
+        [&](const Node& node, const glm::mat4& parentTransform) {
+            const glm::mat4 modelTransform = parentTransform * node.GetTransform();
+
             auto meshId = node.GetMeshId();
-            if (meshId.has_value())
+            if (node.IsCollision() && meshId.has_value())
             {
                 ConvexHullVertices convexHullVertices;
                 auto& mesh = m_pModel->meshes[meshId.value()];
-                const glm::mat4& nodeTransform = node.GetTransform();
 
                 for (auto& primitive : mesh.primitives)
                 {
@@ -653,28 +655,52 @@ void ResourceModel::SetupCollisionShape()
                     const tinygltf::Accessor& accessor = m_pModel->accessors[positionAttribute];
                     const tinygltf::BufferView& bufferView = m_pModel->bufferViews[accessor.bufferView];
                     assert(accessor.type == TINYGLTF_TYPE_VEC3);
-                    const uint64_t arrayStride = 3 * sizeof(float);
+                    assert(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT);
+                    const int arrayStride = accessor.ByteStride(bufferView);
+                    assert(arrayStride > 0);
                     const tinygltf::Buffer& buffer = m_pModel->buffers[bufferView.buffer];
-                    const uint8_t* pPositionData = &buffer.data[bufferView.byteOffset];
+                    const uint8_t* pPositionData = &buffer.data[bufferView.byteOffset + accessor.byteOffset];
+                    convexHullVertices.reserve(convexHullVertices.size() + accessor.count);
                     for (size_t i = 0; i < accessor.count; i++)
                     {
                         const float* pData = reinterpret_cast<const float*>(pPositionData);
                         const glm::vec3 position(pData[0], pData[1], pData[2]);
-                        const glm::vec3 transformedPosition = glm::vec3(nodeTransform * glm::vec4(position, 1.0f));
+                        const glm::vec3 transformedPosition = glm::vec3(modelTransform * glm::vec4(position, 1.0f));
                         convexHullVertices.push_back(transformedPosition);
                         pPositionData += arrayStride;
                     }
                 }
 
-                collisionShapes.push_back(std::make_shared<CollisionShapeConvexHull>(convexHullVertices));
+                if (!convexHullVertices.empty())
+                {
+                    collisionShapes.push_back(std::make_shared<CollisionShapeConvexHull>(convexHullVertices));
+                }
             }
+
+            for (const auto& childIndex : node.GetChildren())
+            {
+                findCollisionNodes(m_Nodes[childIndex], modelTransform);
+            }
+        };
+
+    for (const auto& node : m_Nodes)
+    {
+        if (node.IsRoot())
+        {
+            findCollisionNodes(node, glm::mat4(1.0f));
         }
     }
 
     const size_t numCollisionShapes = collisionShapes.size();
     if (numCollisionShapes > 1)
     {
-        assert(false); // Not implemented yet.
+        // The hulls' vertices are already in model space, so the children don't need their own transforms.
+        CollisionShapeCompoundSharedPtr pCompoundShape = std::make_shared<CollisionShapeCompound>();
+        for (auto& pCollisionShape : collisionShapes)
+        {
+            pCompoundShape->AddChildShape(pCollisionShape, glm::mat4(1.0f));
+        }
+        m_pCollisionShape = pCompoundShape;
     }
     else if (numCollisionShapes == 1)
     {
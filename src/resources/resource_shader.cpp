@@ -101,7 +101,7 @@ void ResourceShader::Save()
     std::vector<uint8_t> data(m_ShaderCode.begin(), m_ShaderCode.end());
     if (GetVFS()->FileWrite(GetPath(), data))
     {
-        Log::Info() << "Saved shader '" << GetPath() << "'.";
+        Log::Verbose(Log::Category::Resources) << "Saved shader '" << GetPath() << "'.";
     }
     else
     {
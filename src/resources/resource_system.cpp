@@ -32,12 +32,12 @@ void ResourceSystem::Update()
     {
         if (pPendingResource.pResource->GetState() == ResourceState::Error)
         {
-            Log::Error() << "Failed to load resource '" << pPendingResource.pResource->GetPath() << "'.";
+            Log::Error(Log::Category::Resources) << "Failed to load resource '" << pPendingResource.pResource->GetPath() << "'.";
             exit(-1);
         }
         else if (pPendingResource.pResource->GetState() == ResourceState::Loaded)
         {
-            Log::Info() << "Loaded resource '" << pPendingResource.pResource->GetPath() << "'.";
+            Log::Verbose(Log::Category::Resources) << "Loaded resource '" << pPendingResource.pResource->GetPath() << "'.";
             pPendingResource.onResourceAvailable(pPendingResource.pResource);
             
             // We mark the pending resource as handled, so we can remove it from the list later.
@@ -76,7 +76,7 @@ void ResourceSystem::RequestResource(const std::string& path, OnResourceAvailabl
         }
         else
         {
-            Log::Error() << "Invalid state for resource.";
+            Log::Error(Log::Category::Resources) << "Invalid state for resource.";
         }
         return;
     }
@@ -84,18 +84,18 @@ void ResourceSystem::RequestResource(const std::string& path, OnResourceAvailabl
     std::optional<std::string> extension = GetExtension(path);
     if (!extension.has_value())
     {
-        Log::Error() << "ResourceSystem: requested path '" << path << "' has no extension.";
+        Log::Error(Log::Category::Resources) << "Requested path '" << path << "' has no extension.";
         return;
     }
 
     auto resourceCreatorIt = m_ResourceCreationFunctions.find(extension.value());
     if (resourceCreatorIt == m_ResourceCreationFunctions.end())
     {
-        Log::Error() << "ResourceSystem: don't know how to create resource for '" << path << "'.";
+        Log::Error(Log::Category::Resources) << "Don't know how to create resource for '" << path << "'.";
         return;
     }
 
-    Log::Info() << "ResourceSystem: requesting load for '" << path << "'.";
+    Log::Verbose(Log::Category::Resources) << "Requesting load for '" << path << "'.";
 
     ResourceSharedPtr pResource = resourceCreatorIt->second();
     m_Resources[path] = pResource;
@@ -3,46 +3,101 @@
 #include "core/serialization.hpp"
 #include "pandora.hpp"
 #include "physics/collision_shape.hpp"
+#include "physics/collision_shape_cache.hpp"
 #include "resources/resource_system.hpp"
+#include "scene/components/compact_transform_component.hpp"
+#include "scene/components/transform_component.hpp"
 
 namespace WingsOfSteel
 {
 
 void CollisionComponent::DeserializeShape(const ResourceDataStore* pContext, const Json::Data& jsonData, BuildCallback buildCallback)
+{
+    if (DeserializeShapeDescription(pContext, jsonData))
+    {
+        CreateShape(buildCallback);
+    }
+}
+
+bool CollisionComponent::DeserializeShapeDescription(const ResourceDataStore* pContext, const Json::Data& jsonData)
 {
     auto shapeDataResult = Json::DeserializeObject(pContext, jsonData, "shape");
     if (!shapeDataResult.has_value())
     {
         Log::Error() << pContext->GetPath() << ": Collision component needs to have a shape.";
-        return;
+        return false;
     }
 
     const Json::Data& shapeData = shapeDataResult.value();
-    CollisionShape::Type shapeType = Json::DeserializeEnum<CollisionShape::Type>(pContext, shapeData, "type", CollisionShape::Type::Sphere);
+    m_ShapeType = Json::DeserializeEnum<CollisionShape::Type>(pContext, shapeData, "type", CollisionShape::Type::Sphere);
 
-    if (shapeType == CollisionShape::Type::Sphere)
+    if (m_ShapeType == CollisionShape::Type::Sphere)
+    {
+        m_ShapeDimensions = glm::vec3(Json::DeserializeFloat(pContext, shapeData, "radius", 1.0f));
+    }
+    else if (m_ShapeType == CollisionShape::Type::Box)
+    {
+        m_ShapeDimensions = Json::DeserializeVec3(pContext, shapeData, "dimensions", glm::vec3(1.0f, 1.0f, 1.0f));
+    }
+    else if (m_ShapeType == CollisionShape::Type::Cylinder)
+    {
+        m_ShapeAxis = Json::DeserializeEnum<CollisionShapeCylinder::Axis>(pContext, shapeData, "axis", CollisionShapeCylinder::Axis::Y);
+        m_ShapeDimensions = Json::DeserializeVec3(pContext, shapeData, "dimensions", glm::vec3(1.0f, 1.0f, 1.0f));
+    }
+    else if (m_ShapeType == CollisionShape::Type::ConvexHull)
     {
-        const float radius = Json::DeserializeFloat(pContext, shapeData, "radius", 1.0f);
-        m_pShape = std::make_shared<CollisionShapeSphere>(radius);
+        m_ResourcePath = Json::DeserializeString(pContext, shapeData, "resource");
+    }
+    else
+    {
+        Log::Error() << pContext->GetPath() << ": Unsupported collision shape.";
+        return false;
+    }
+
+    return true;
+}
+
+void CollisionComponent::SerializeShape(Binary::Writer& writer) const
+{
+    writer.Write<uint8_t>(static_cast<uint8_t>(m_ShapeType));
+    writer.Write<uint8_t>(static_cast<uint8_t>(m_ShapeAxis));
+    writer.Write(m_ShapeDimensions);
+    writer.Write(m_ResourcePath);
+}
+
+void CollisionComponent::DeserializeShape(Binary::Reader& reader, BuildCallback buildCallback)
+{
+    m_ShapeType = static_cast<CollisionShape::Type>(reader.Read<uint8_t>());
+    m_ShapeAxis = static_cast<CollisionShapeCylinder::Axis>(reader.Read<uint8_t>());
+    m_ShapeDimensions = reader.ReadVec3();
+    m_ResourcePath = reader.ReadString();
+
+    if (reader.IsValid())
+    {
+        CreateShape(buildCallback);
+    }
+}
+
+void CollisionComponent::CreateShape(BuildCallback buildCallback)
+{
+    if (m_ShapeType == CollisionShape::Type::Sphere)
+    {
+        m_pShape = GetCollisionShapeCache()->GetSphere(m_ShapeDimensions.x);
         buildCallback();
     }
-    else if (shapeType == CollisionShape::Type::Box)
+    else if (m_ShapeType == CollisionShape::Type::Box)
     {
-        const glm::vec3 dimensions = Json::DeserializeVec3(pContext, shapeData, "dimensions", glm::vec3(1.0f, 1.0f, 1.0f));
-        m_pShape = std::make_shared<CollisionShapeBox>(dimensions.x, dimensions.y, dimensions.z);
+        m_pShape = GetCollisionShapeCache()->GetBox(m_ShapeDimensions);
         buildCallback();
     }
-    else if (shapeType == CollisionShape::Type::Cylinder)
+    else if (m_ShapeType == CollisionShape::Type::Cylinder)
     {
-        const CollisionShapeCylinder::Axis axis = Json::DeserializeEnum<CollisionShapeCylinder::Axis>(pContext, shapeData, "axis", CollisionShapeCylinder::Axis::Y);
-        const glm::vec3 dimensions = Json::DeserializeVec3(pContext, shapeData, "dimensions", glm::vec3(1.0f, 1.0f, 1.0f));
-        m_pShape = std::make_shared<CollisionShapeCylinder>(axis, dimensions.x, dimensions.y, dimensions.z);
+        m_pShape = GetCollisionShapeCache()->GetCylinder(m_ShapeAxis, m_ShapeDimensions);
         buildCallback();
     }
-    else if (shapeType == CollisionShape::Type::ConvexHull)
+    else if (m_ShapeType == CollisionShape::Type::ConvexHull)
     {
-        const std::string& resourcePath = Json::DeserializeString(pContext, shapeData, "resource");
-        GetResourceSystem()->RequestResource(resourcePath, [this, buildCallback](ResourceSharedPtr pResource) {
+        GetResourceSystem()->RequestResource(m_ResourcePath, [this, buildCallback](ResourceSharedPtr pResource) {
             m_pResource = std::dynamic_pointer_cast<ResourceModel>(pResource);
             m_pShape = m_pResource->GetCollisionShape();
             buildCallback();
@@ -50,9 +105,31 @@ void CollisionComponent::DeserializeShape(const ResourceDataStore* pContext, con
     }
     else
     {
-        Log::Error() << pContext->GetPath() << ": Unsupported collision shape.";
-        return;
+        Log::Warning() << "Unsupported collision shape type " << static_cast<int>(m_ShapeType) << ".";
+    }
+}
+
+void CollisionComponent::InstantiateShapeFrom(const CollisionComponent& prototype, const std::optional<glm::mat4>& worldTransform, BuildCallback buildCallback)
+{
+    m_ShapeType = prototype.m_ShapeType;
+    m_ShapeAxis = prototype.m_ShapeAxis;
+    m_ShapeDimensions = prototype.m_ShapeDimensions;
+    m_ResourcePath = prototype.m_ResourcePath;
+    m_WorldTransform = worldTransform;
+    CreateShape(buildCallback);
+}
+
+std::optional<glm::mat4> CollisionComponent::GetSpawnTransform(const entt::registry& registry, EntityHandle entity)
+{
+    if (const TransformComponent* pTransformComponent = registry.try_get<TransformComponent>(entity))
+    {
+        return pTransformComponent->transform;
+    }
+    else if (const CompactTransformComponent* pCompactTransformComponent = registry.try_get<CompactTransformComponent>(entity))
+    {
+        return pCompactTransformComponent->ToMatrix();
     }
+    return std::nullopt;
 }
 
 } // namespace WingsOfSteel
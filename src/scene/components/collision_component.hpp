@@ -5,17 +5,18 @@
 #include <string>
 
 #include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
 
+#include "core/binary_serialization.hpp"
 #include "core/smart_ptr.hpp"
 #include "icomponent.hpp"
+#include "physics/collision_shape.hpp"
 #include "scene/entity.hpp"
 #include "resources/resource_model.hpp"
 
 namespace WingsOfSteel
 {
 
-DECLARE_SMART_PTR(CollisionShape);
-
 // Base class for components that use Bullet collision shapes
 class CollisionComponent : public IComponent
 {
@@ -26,11 +27,27 @@ protected:
     // Common shape deserialization with callback for building the specific collision object
     using BuildCallback = std::function<void()>;
     void DeserializeShape(const ResourceDataStore* pContext, const Json::Data& jsonData, BuildCallback buildCallback);
+    // Only reads the shape's description, without creating the shape or requesting its model. Used for prototypes.
+    bool DeserializeShapeDescription(const ResourceDataStore* pContext, const Json::Data& jsonData);
+    // Creates the shape described by the prototype, through the cache, with the object placed at worldTransform.
+    void InstantiateShapeFrom(const CollisionComponent& prototype, const std::optional<glm::mat4>& worldTransform, BuildCallback buildCallback);
+    // Transform of an entity being spawned, so its collision object can be built in place rather than at the origin.
+    static std::optional<glm::mat4> GetSpawnTransform(const entt::registry& registry, EntityHandle entity);
+    // Binary scenes store the shape's description rather than the shape itself, and rebuild it through the cache.
+    // Written as "shape_type:u8,shape_axis:u8,shape_dimensions:vec3,shape_resource:string" in the derived schemas.
+    void SerializeShape(Binary::Writer& writer) const;
+    void DeserializeShape(Binary::Reader& reader, BuildCallback buildCallback);
+    // Creates the shape from its description, then calls buildCallback once it is available.
+    void CreateShape(BuildCallback buildCallback);
 
     // Common members
     CollisionShapeSharedPtr m_pShape;
     ResourceModelSharedPtr m_pResource;
     std::string m_ResourcePath;
+    // Description of the shape, kept so the shape can be saved. Spheres store their radius in x.
+    CollisionShape::Type m_ShapeType{ CollisionShape::Type::Sphere };
+    CollisionShapeCylinder::Axis m_ShapeAxis{ CollisionShapeCylinder::Axis::Y };
+    glm::vec3 m_ShapeDimensions{ 1.0f };
     std::optional<glm::mat4> m_WorldTransform;
     EntityWeakPtr m_pOwner;
 };
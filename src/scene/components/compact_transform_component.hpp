@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "icomponent.hpp"
+#include "component_factory.hpp"
+
+namespace WingsOfSteel
+{
+
+// Alternative to TransformComponent for entities which don't need a full matrix: 40 bytes of data instead of 64
+// (48 bytes instead of 72 with the vtable pointer on 64-bit platforms), and the direction vectors come straight
+// from the rotation. The matrix is only built where it's needed, such as when gathering render instances.
+// An entity should have either a TransformComponent or a CompactTransformComponent.
+class CompactTransformComponent : public IComponent
+{
+public:
+    CompactTransformComponent() = default;
+
+    glm::vec3 position{ 0.0f };
+    glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 scale{ 1.0f };
+
+    const glm::vec3& GetTranslation() const { return position; }
+    glm::vec3 GetForward() const { return rotation * glm::vec3(0.0f, 0.0f, 1.0f); }
+    glm::vec3 GetRight() const { return rotation * glm::vec3(1.0f, 0.0f, 0.0f); }
+    glm::vec3 GetUp() const { return rotation * glm::vec3(0.0f, 1.0f, 0.0f); }
+
+    glm::mat4 ToMatrix() const
+    {
+        const glm::mat3 rotationMatrix = glm::mat3_cast(rotation);
+        return glm::mat4(
+            glm::vec4(rotationMatrix[0] * scale.x, 0.0f),
+            glm::vec4(rotationMatrix[1] * scale.y, 0.0f),
+            glm::vec4(rotationMatrix[2] * scale.z, 0.0f),
+            glm::vec4(position, 1.0f));
+    }
+
+    // Any shear in the matrix is lost, as it can't be represented.
+    void FromMatrix(const glm::mat4& transform)
+    {
+        position = glm::vec3(transform[3]);
+        scale = glm::vec3(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])));
+        rotation = glm::normalize(glm::quat_cast(glm::mat3(glm::vec3(transform[0]) / scale.x, glm::vec3(transform[1]) / scale.y, glm::vec3(transform[2]) / scale.z)));
+    }
+
+    void Deserialize(const ResourceDataStore* pContext, const Json::Data& json) override
+    {
+        position = Json::DeserializeVec3(pContext, json, "position", glm::vec3(0.0f));
+        // Stored as XYZW, as in glTF.
+        const glm::vec4 rotationXYZW = Json::DeserializeVec4(pContext, json, "rotation", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        rotation = glm::normalize(glm::quat(rotationXYZW.w, rotationXYZW.x, rotationXYZW.y, rotationXYZW.z));
+        scale = Json::DeserializeVec3(pContext, json, "scale", glm::vec3(1.0f));
+    }
+
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash("position:vec3,rotation:quat,scale:vec3");
+
+    void Serialize(Binary::Writer& writer) const
+    {
+        writer.Write(position);
+        writer.Write(rotation);
+        writer.Write(scale);
+    }
+
+    void Deserialize(Binary::Reader& reader)
+    {
+        position = reader.ReadVec3();
+        rotation = reader.ReadQuat();
+        scale = reader.ReadVec3();
+    }
+};
+
+static_assert(sizeof(CompactTransformComponent) == sizeof(IComponent) + 40, "CompactTransformComponent should only add position, rotation and scale");
+
+REGISTER_COMPONENT(CompactTransformComponent, "compact_transform")
+
+} // namespace WingsOfSteel
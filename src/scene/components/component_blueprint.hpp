@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include <entt/entt.hpp>
+
+#include "core/serialization.hpp"
+#include "core/smart_ptr.hpp"
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel
+{
+
+DECLARE_SMART_PTR(ResourceDataStore);
+
+// A component parsed once from its JSON data, which can then be stamped onto any number of entities.
+DECLARE_SMART_PTR(ComponentBlueprint);
+class ComponentBlueprint
+{
+public:
+    virtual ~ComponentBlueprint() = default;
+
+    virtual void Instantiate(entt::registry& registry, std::span<const EntityHandle> entities) const = 0;
+};
+
+// Components which own resources that can't simply be copied (such as Bullet objects) can provide
+// DeserializePrototype(), which only reads their description, and InstantiateFrom(prototype, registry, entity),
+// which is called on each newly added component to build those resources. The prototype itself never owns any.
+template <typename T>
+concept InstantiableFromPrototype = requires(T& component, const T& prototype, const ResourceDataStore* pContext, const Json::Data& jsonData, const entt::registry& registry, EntityHandle entity) {
+    component.DeserializePrototype(pContext, jsonData);
+    component.InstantiateFrom(prototype, registry, entity);
+};
+
+template <typename T>
+class TypedComponentBlueprint : public ComponentBlueprint
+{
+public:
+    TypedComponentBlueprint(const ResourceDataStore* pContext, const Json::Data& jsonData)
+        : m_pContext(pContext)
+    {
+        if constexpr (InstantiableFromPrototype<T>)
+        {
+            m_Prototype.DeserializePrototype(pContext, jsonData);
+        }
+        else if constexpr (std::is_copy_constructible_v<T>)
+        {
+            m_Prototype.Deserialize(pContext, jsonData);
+        }
+        else
+        {
+            m_JsonData = jsonData;
+        }
+    }
+
+    void Instantiate(entt::registry& registry, std::span<const EntityHandle> entities) const override
+    {
+        if constexpr (InstantiableFromPrototype<T>)
+        {
+            for (const EntityHandle entity : entities)
+            {
+                registry.emplace<T>(entity).InstantiateFrom(m_Prototype, registry, entity);
+            }
+        }
+        else if constexpr (std::is_copy_constructible_v<T>)
+        {
+            registry.insert<T>(entities.begin(), entities.end(), m_Prototype);
+        }
+        else
+        {
+            // Components which can't be copied in any way are deserialized for each entity, as before.
+            for (const EntityHandle entity : entities)
+            {
+                registry.emplace<T>(entity).Deserialize(m_pContext, m_JsonData);
+            }
+        }
+    }
+
+private:
+    T m_Prototype;
+    Json::Data m_JsonData;
+    const ResourceDataStore* m_pContext{ nullptr };
+};
+
+} // namespace WingsOfSteel
@@ -1,24 +1,130 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
 #include <unordered_map>
 #include <functional>
 #include <string>
 
 #include <nlohmann/json_fwd.hpp>
 
+#include "core/binary_serialization.hpp"
 #include "core/serialization.hpp"
+#include "component_blueprint.hpp"
 #include "icomponent.hpp"
 #include "scene/entity.hpp"
 
 namespace WingsOfSteel
 {
 
+// Components which can be saved in binary scenes. sBinarySchema must be built with Binary::SchemaHash() from a
+// description of the fields, in the order they are serialized.
+template <typename T>
+concept BinarySerializable = requires(const T& constComponent, T& component, Binary::Writer& writer, Binary::Reader& reader) {
+    { T::sBinarySchema } -> std::convertible_to<uint64_t>;
+    constComponent.Serialize(writer);
+    component.Deserialize(reader);
+};
+
 class ComponentFactory
 {
+public:
+    struct BinaryComponentType
+    {
+        std::string typeName;
+        uint64_t typeId; // Hash of the type name, which unlike entt's type ids is the same in every build.
+        uint64_t schema;
+        // The type's storage, as a set of entities.
+        entt::sparse_set& (*storage)(entt::registry& registry);
+        // Writes the number of components followed by each entity and its component.
+        void (*serialize)(entt::registry& registry, Binary::Writer& writer);
+        // Adds the components written by serialize() to existing entities. Returns false if the data is invalid.
+        bool (*deserialize)(entt::registry& registry, Binary::Reader& reader);
+        // Writes a single entity's component, which the entity must have.
+        void (*serializeComponent)(entt::registry& registry, EntityHandle entity, Binary::Writer& writer);
+        // Adds the component to the entity, or overwrites it if the entity already has one.
+        void (*deserializeComponent)(entt::registry& registry, EntityHandle entity, Binary::Reader& reader);
+        // Same layout as serialize(), but written through entt's snapshot, with the handles as they are.
+        void (*snapshot)(const entt::snapshot& snapshot, Binary::OutputArchive& archive);
+    };
+
 private:
     using EntityAdderFunc = std::function<void(Entity*, const ResourceDataStore*, const Json::Data&)>;
+    using BlueprintCreatorFunc = ComponentBlueprintUniquePtr (*)(const ResourceDataStore*, const Json::Data&);
 
     inline static std::unordered_map<std::string, EntityAdderFunc>* sRegistry = nullptr;
+    inline static std::unordered_map<std::string, BlueprintCreatorFunc>* sBlueprintRegistry = nullptr;
+    inline static std::unordered_map<uint64_t, BinaryComponentType>* sBinaryRegistry = nullptr;
+
+    template <BinarySerializable T>
+    static void RegisterBinary(const std::string& typeName)
+    {
+        if (sBinaryRegistry == nullptr)
+        {
+            sBinaryRegistry = new std::unordered_map<uint64_t, BinaryComponentType>();
+        }
+
+        BinaryComponentType binaryType;
+        binaryType.typeName = typeName;
+        binaryType.typeId = Binary::SchemaHash(typeName);
+        binaryType.schema = T::sBinarySchema;
+        binaryType.storage = [](entt::registry& registry) -> entt::sparse_set& {
+            return registry.storage<T>();
+        };
+        binaryType.serialize = [](entt::registry& registry, Binary::Writer& writer) {
+            auto& storage = registry.storage<T>();
+            writer.Write<uint32_t>(static_cast<uint32_t>(storage.size()));
+            for (auto [entity, component] : storage.each())
+            {
+                writer.Write(entity);
+                component.Serialize(writer);
+            }
+        };
+        binaryType.deserialize = [](entt::registry& registry, Binary::Reader& reader) -> bool {
+            const uint32_t count = reader.Read<uint32_t>();
+            if (!reader.IsValid())
+            {
+                return false;
+            }
+
+            registry.storage<T>().reserve(registry.storage<T>().size() + count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const EntityHandle entity = reader.ReadEntity();
+                if (!reader.IsValid() || !registry.valid(entity) || registry.all_of<T>(entity))
+                {
+                    return false;
+                }
+
+                T& component = registry.emplace<T>(entity);
+                component.Deserialize(reader);
+            }
+            return reader.IsValid();
+        };
+        binaryType.serializeComponent = [](entt::registry& registry, EntityHandle entity, Binary::Writer& writer) {
+            registry.get<T>(entity).Serialize(writer);
+        };
+        binaryType.deserializeComponent = [](entt::registry& registry, EntityHandle entity, Binary::Reader& reader) {
+            if (!registry.all_of<T>(entity))
+            {
+                registry.emplace<T>(entity).Deserialize(reader);
+            }
+            else if constexpr (std::is_copy_assignable_v<T>)
+            {
+                registry.patch<T>(entity, [&reader](T& component) { component.Deserialize(reader); });
+            }
+            else
+            {
+                // Components which own external objects (such as Bullet bodies) are rebuilt rather than overwritten.
+                registry.remove<T>(entity);
+                registry.emplace<T>(entity).Deserialize(reader);
+            }
+        };
+        binaryType.snapshot = [](const entt::snapshot& snapshot, Binary::OutputArchive& archive) {
+            snapshot.get<T>(archive);
+        };
+        (*sBinaryRegistry)[binaryType.typeId] = std::move(binaryType);
+    }
 
 public:
     template<typename T>
@@ -33,6 +139,20 @@ public:
             T& component = pEntity->AddComponent<T>();
             component.Deserialize(pContext, jsonData);
         };
+
+        if (sBlueprintRegistry == nullptr)
+        {
+            sBlueprintRegistry = new std::unordered_map<std::string, BlueprintCreatorFunc>();
+        }
+
+        (*sBlueprintRegistry)[typeName] = [](const ResourceDataStore* pContext, const Json::Data& jsonData) -> ComponentBlueprintUniquePtr {
+            return std::make_unique<TypedComponentBlueprint<T>>(pContext, jsonData);
+        };
+
+        if constexpr (BinarySerializable<T>)
+        {
+            RegisterBinary<T>(typeName);
+        }
     }
 
     static bool Create(Entity* pEntity, const ResourceDataStore* pContext, const std::string& typeName, const Json::Data& jsonData)
@@ -51,6 +171,40 @@ public:
 
         return false;
     }
+
+    // Parses the component once, so it can be instantiated any number of times. Returns nullptr for unknown types.
+    static ComponentBlueprintUniquePtr CreateBlueprint(const ResourceDataStore* pContext, const std::string& typeName, const Json::Data& jsonData)
+    {
+        if (!sBlueprintRegistry)
+        {
+            return nullptr;
+        }
+
+        auto it = sBlueprintRegistry->find(typeName);
+        if (it != sBlueprintRegistry->cend())
+        {
+            return it->second(pContext, jsonData);
+        }
+
+        return nullptr;
+    }
+
+    // Component types which can be saved in binary scenes, keyed by type id.
+    static const std::unordered_map<uint64_t, BinaryComponentType>* GetBinaryComponentTypes()
+    {
+        return sBinaryRegistry;
+    }
+
+    static const BinaryComponentType* FindBinaryComponentType(uint64_t typeId)
+    {
+        if (!sBinaryRegistry)
+        {
+            return nullptr;
+        }
+
+        auto it = sBinaryRegistry->find(typeId);
+        return (it != sBinaryRegistry->cend()) ? &it->second : nullptr;
+    }
 };
 
 template<typename ComponentType>
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 
 #include <glm/gtc/type_ptr.hpp>
@@ -26,6 +27,33 @@ void GhostComponent::Deserialize(const ResourceDataStore* pContext, const Json::
     });
 }
 
+bool GhostComponent::DeserializePrototype(const ResourceDataStore* pContext, const Json::Data& jsonData)
+{
+    return CollisionComponent::DeserializeShapeDescription(pContext, jsonData);
+}
+
+void GhostComponent::InstantiateFrom(const GhostComponent& prototype, const entt::registry& registry, EntityHandle entity)
+{
+    CollisionComponent::InstantiateShapeFrom(prototype, GetSpawnTransform(registry, entity), [this]() {
+        BuildGhostObject();
+    });
+}
+
+void GhostComponent::Serialize(Binary::Writer& writer) const
+{
+    writer.Write(GetWorldTransform());
+    SerializeShape(writer);
+}
+
+void GhostComponent::Deserialize(Binary::Reader& reader)
+{
+    m_WorldTransform = reader.ReadMat4();
+
+    CollisionComponent::DeserializeShape(reader, [this]() {
+        BuildGhostObject();
+    });
+}
+
 void GhostComponent::BuildGhostObject()
 {
     if (!m_pShape)
@@ -43,6 +71,7 @@ void GhostComponent::BuildGhostObject()
     m_pGhostObject->setCollisionShape(m_pShape->GetBulletShape());
     m_pGhostObject->setCollisionFlags(btCollisionObject::CF_NO_CONTACT_RESPONSE);
     m_pGhostObject->setUserPointer(this);
+    MarkTransformDirty();
 }
 
 glm::vec3 GhostComponent::GetPosition() const
@@ -88,6 +117,35 @@ void GhostComponent::SetWorldTransform(const glm::mat4x4& worldTransform)
     {
         m_WorldTransform = worldTransform;
     }
+
+    MarkTransformDirty();
+}
+
+void GhostComponent::Bind(EntityHandle entity, std::vector<EntityHandle>* pMovedGhosts)
+{
+    m_Entity = entity;
+    m_pMovedGhosts = pMovedGhosts;
+    m_TransformDirty = false;
+    MarkTransformDirty();
+}
+
+void GhostComponent::Unbind()
+{
+    if (m_pMovedGhosts && m_TransformDirty)
+    {
+        m_pMovedGhosts->erase(std::remove(m_pMovedGhosts->begin(), m_pMovedGhosts->end(), m_Entity), m_pMovedGhosts->end());
+    }
+    m_Entity = entt::null;
+    m_pMovedGhosts = nullptr;
+}
+
+void GhostComponent::MarkTransformDirty()
+{
+    if (m_pMovedGhosts && !m_TransformDirty)
+    {
+        m_pMovedGhosts->push_back(m_Entity);
+    }
+    m_TransformDirty = true;
 }
 
 const glm::vec3 GhostComponent::GetForwardVector() const
@@ -2,6 +2,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <btBulletCollisionCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
@@ -39,11 +40,26 @@ public:
 
     void SetWorldTransform(const glm::mat4x4& worldTransform);
 
+    // Set whenever the ghost is moved, so its transform component is only updated when needed. Bound ghosts add
+    // their entity to the simulation's list of moved ghosts the first time they are moved after being synced.
+    bool IsTransformDirty() const { return m_TransformDirty; }
+    void ClearTransformDirty() { m_TransformDirty = false; }
+    void Bind(EntityHandle entity, std::vector<EntityHandle>* pMovedGhosts);
+    void Unbind();
+
     const glm::vec3 GetForwardVector() const;
     const glm::vec3 GetUpVector() const;
     const glm::vec3 GetRightVector() const;
 
     void Deserialize(const ResourceDataStore* pContext, const Json::Data& jsonData) override;
+    // Prototypes only hold the shape's description: the ghost object is built by each InstantiateFrom().
+    bool DeserializePrototype(const ResourceDataStore* pContext, const Json::Data& jsonData);
+    void InstantiateFrom(const GhostComponent& prototype, const entt::registry& registry, EntityHandle entity);
+
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash(
+        "world_transform:mat4,shape_type:u8,shape_axis:u8,shape_dimensions:vec3,shape_resource:string");
+    void Serialize(Binary::Writer& writer) const;
+    void Deserialize(Binary::Reader& reader);
 
     void SetOwner(EntitySharedPtr pOwner);
     EntityWeakPtr GetOwner() { return m_pOwner; }
@@ -53,9 +69,13 @@ public:
 
 private:
     void BuildGhostObject();
+    void MarkTransformDirty();
 
     std::unique_ptr<btGhostObject> m_pGhostObject;
     std::unique_ptr<GhostEntityUserData> m_pUserData;
+    EntityHandle m_Entity{ entt::null };
+    std::vector<EntityHandle>* m_pMovedGhosts{ nullptr };
+    bool m_TransformDirty{ true };
 };
 
 } // namespace WingsOfSteel
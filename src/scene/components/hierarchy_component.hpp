@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+#include <glm/mat4x4.hpp>
+
+#include "component_factory.hpp"
+#include "icomponent.hpp"
+#include "scene/entity.hpp"
+
+namespace WingsOfSteel
+{
+
+// Attaches an entity to a parent. The TransformHierarchySystem then keeps the entity's TransformComponent (or
+// CompactTransformComponent) equal to the parent's world transform, followed by the attachment point (if any),
+// followed by the local transform.
+// Changes must be made through entt::registry::patch() (or TransformHierarchySystem::SetLocalTransform()),
+// as the system only recomputes the entities it is told about.
+class HierarchyComponent : public IComponent
+{
+public:
+    HierarchyComponent() = default;
+    HierarchyComponent(EntityHandle _parent, const glm::mat4& _localTransform = glm::mat4(1.0f), const std::string& _attachmentPoint = "")
+        : parent(_parent)
+        , localTransform(_localTransform)
+        , attachmentPoint(_attachmentPoint)
+    {
+    }
+
+    EntityHandle parent{ entt::null };
+    glm::mat4 localTransform{ 1.0f };
+    // Name of an attachment point in the parent's model, e.g. "Turret1". Empty to attach to the parent's origin.
+    std::string attachmentPoint;
+
+    // The parent is the index of an entity in the list being loaded, see Json::EntityTableScope.
+    void Deserialize(const ResourceDataStore* pContext, const Json::Data& json) override
+    {
+        parent = Json::DeserializeEntity(pContext, json, "parent", entt::entity{ entt::null });
+        localTransform = Json::DeserializeMat4(pContext, json, "local_transform", glm::mat4(1.0f));
+        attachmentPoint = Json::DeserializeString(pContext, json, "attachment_point", "");
+    }
+
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash("parent:entity,local_transform:mat4,attachment_point:string");
+
+    void Serialize(Binary::Writer& writer) const
+    {
+        writer.Write(parent);
+        writer.Write(localTransform);
+        writer.Write(attachmentPoint);
+    }
+
+    void Deserialize(Binary::Reader& reader)
+    {
+        parent = reader.ReadEntity();
+        localTransform = reader.ReadMat4();
+        attachmentPoint = reader.ReadString();
+    }
+};
+
+REGISTER_COMPONENT(HierarchyComponent, "hierarchy")
+
+} // namespace WingsOfSteel
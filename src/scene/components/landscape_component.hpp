@@ -22,8 +22,9 @@ public:
     uint32_t Length{ 32 };
     float Height{ 40.0f }; // Maximum height the landscape will be generated to, in meters.
     float WaterLevel{ 10.0f };
-    float CellSize{ 1.0f }; // Cell size, in meters.
+    float CellSize{ 10.0f }; // Cell size, in meters.
     uint32_t Generation{ 0 }; // Current generation iteration; used by the renderer to know when the component is stale.
+    bool GenerationRequested{ false }; // Set to have the LandscapeSystem regenerate the heightmap on its next update.
     uint32_t Octaves{ 4 };
     float Frequency{ 0.002 };
     std::vector<float> Heightmap;
@@ -39,6 +39,62 @@ public:
         SetModel(Json::DeserializeString(pContext, json, "resource"));
     }
 
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash("resource:string,shader_parameters:[string,f32]");
+
+    void Serialize(Binary::Writer& writer) const
+    {
+        writer.Write(m_ResourcePath);
+        writer.Write<uint32_t>(static_cast<uint32_t>(m_ShaderParameters.size()));
+        for (const auto& shaderParameter : m_ShaderParameters)
+        {
+            writer.Write(shaderParameter.first);
+            writer.Write(shaderParameter.second);
+        }
+    }
+
+    // Overwrites the component, as binary deltas are applied to existing components.
+    void Deserialize(Binary::Reader& reader)
+    {
+        const std::string_view resourcePath = reader.ReadString();
+        m_ShaderParameters.clear();
+        const uint32_t shaderParameterCount = reader.Read<uint32_t>();
+        for (uint32_t i = 0; i < shaderParameterCount && reader.IsValid(); i++)
+        {
+            const std::string_view name = reader.ReadString();
+            const float value = reader.Read<float>();
+            if (reader.IsValid())
+            {
+                m_ShaderParameters[std::string(name)] = value;
+            }
+        }
+
+        if (reader.IsValid() && resourcePath != m_ResourcePath)
+        {
+            if (resourcePath.empty())
+            {
+                m_pResource.reset();
+                m_ResourcePath.clear();
+            }
+            else
+            {
+                SetModel(std::string(resourcePath));
+            }
+        }
+    }
+
+    // Prototypes only hold the model's path, which each InstantiateFrom() requests (loaded models are shared).
+    bool DeserializePrototype(const ResourceDataStore* pContext, const Json::Data& json)
+    {
+        m_ResourcePath = Json::DeserializeString(pContext, json, "resource");
+        return !m_ResourcePath.empty();
+    }
+
+    void InstantiateFrom(const ModelComponent& prototype, const entt::registry&, EntityHandle)
+    {
+        SetModel(prototype.m_ResourcePath);
+        m_ShaderParameters = prototype.m_ShaderParameters;
+    }
+
     // Shader parameter API
     void SetShaderParameter(const std::string& name, float value)
     {
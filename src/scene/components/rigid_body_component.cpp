@@ -20,6 +20,16 @@ RigidBodyComponent::~RigidBodyComponent()
 }
 
 void RigidBodyComponent::Deserialize(const ResourceDataStore* pContext, const Json::Data& jsonData)
+{
+    if (DeserializePrototype(pContext, jsonData))
+    {
+        CreateShape([this]() {
+            BuildRigidBody();
+        });
+    }
+}
+
+bool RigidBodyComponent::DeserializePrototype(const ResourceDataStore* pContext, const Json::Data& jsonData)
 {
     m_MotionType = Json::DeserializeEnum<MotionType>(pContext, jsonData, "motion_type", MotionType::Dynamic);
     m_Mass = Json::DeserializeInteger(pContext, jsonData, "mass");
@@ -27,10 +37,53 @@ void RigidBodyComponent::Deserialize(const ResourceDataStore* pContext, const Js
     m_AngularDamping = Json::DeserializeFloat(pContext, jsonData, "angular_damping");
     m_LinearFactor = Json::DeserializeVec3(pContext, jsonData, "linear_factor");
     m_AngularFactor = Json::DeserializeVec3(pContext, jsonData, "angular_factor");
+    m_AllowSleeping = Json::DeserializeBool(pContext, jsonData, "allow_sleeping", false);
 
     assert((m_Mass > 0 && m_MotionType == MotionType::Dynamic) || (m_Mass == 0 && m_MotionType == MotionType::Static));
 
-    CollisionComponent::DeserializeShape(pContext, jsonData, [this]() {
+    return CollisionComponent::DeserializeShapeDescription(pContext, jsonData);
+}
+
+void RigidBodyComponent::InstantiateFrom(const RigidBodyComponent& prototype, const entt::registry& registry, EntityHandle entity)
+{
+    m_MotionType = prototype.m_MotionType;
+    m_Mass = prototype.m_Mass;
+    m_LinearDamping = prototype.m_LinearDamping;
+    m_AngularDamping = prototype.m_AngularDamping;
+    m_LinearFactor = prototype.m_LinearFactor;
+    m_AngularFactor = prototype.m_AngularFactor;
+    m_AllowSleeping = prototype.m_AllowSleeping;
+
+    CollisionComponent::InstantiateShapeFrom(prototype, GetSpawnTransform(registry, entity), [this]() {
+        BuildRigidBody();
+    });
+}
+
+void RigidBodyComponent::Serialize(Binary::Writer& writer) const
+{
+    writer.Write<uint8_t>(static_cast<uint8_t>(m_MotionType));
+    writer.Write(m_Mass);
+    writer.Write(m_LinearDamping);
+    writer.Write(m_AngularDamping);
+    writer.Write(m_LinearFactor);
+    writer.Write(m_AngularFactor);
+    writer.Write(m_AllowSleeping);
+    writer.Write(GetWorldTransform());
+    SerializeShape(writer);
+}
+
+void RigidBodyComponent::Deserialize(Binary::Reader& reader)
+{
+    m_MotionType = static_cast<MotionType>(reader.Read<uint8_t>());
+    m_Mass = reader.Read<int32_t>();
+    m_LinearDamping = reader.Read<float>();
+    m_AngularDamping = reader.Read<float>();
+    m_LinearFactor = reader.ReadVec3();
+    m_AngularFactor = reader.ReadVec3();
+    m_AllowSleeping = reader.ReadBool();
+    m_WorldTransform = reader.ReadMat4();
+
+    CollisionComponent::DeserializeShape(reader, [this]() {
         BuildRigidBody();
     });
 }
@@ -45,7 +98,7 @@ void RigidBodyComponent::BuildRigidBody()
 
     btTransform worldTransform;
     worldTransform.setFromOpenGLMatrix(glm::value_ptr(GetWorldTransform()));
-    m_pMotionState = std::make_unique<btDefaultMotionState>(worldTransform);
+    m_pMotionState = std::make_unique<MotionState>(worldTransform);
 
     btCollisionShape* pCollisionShape = m_pShape->GetBulletShape();
     btVector3 localInertia(0.0f, 0.0f, 0.0f);
@@ -64,7 +117,10 @@ void RigidBodyComponent::BuildRigidBody()
     rbInfo.m_angularDamping = m_AngularDamping;
 
     m_pRigidBody = std::make_unique<btRigidBody>(rbInfo);
-    m_pRigidBody->setActivationState(DISABLE_DEACTIVATION);
+    if (!m_AllowSleeping)
+    {
+        m_pRigidBody->setActivationState(DISABLE_DEACTIVATION);
+    }
     m_pRigidBody->setCollisionFlags(m_pRigidBody->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
     m_pRigidBody->setLinearFactor(btVector3(m_LinearFactor.x, m_LinearFactor.y, m_LinearFactor.z));
     m_pRigidBody->setAngularFactor(btVector3(m_AngularFactor.x, m_AngularFactor.y, m_AngularFactor.z));
@@ -114,6 +170,11 @@ glm::vec3 RigidBodyComponent::GetAngularVelocity() const
     }
 }
 
+bool RigidBodyComponent::IsSleeping() const
+{
+    return m_pRigidBody && !m_pRigidBody->isActive();
+}
+
 void RigidBodyComponent::SetLinearDamping(float value)
 {
     m_LinearDamping = value;
@@ -154,8 +215,9 @@ void RigidBodyComponent::SetWorldTransform(const glm::mat4x4& worldTransform)
         btTransform tr;
         tr.setFromOpenGLMatrix(glm::value_ptr(worldTransform));
         m_pRigidBody->setWorldTransform(tr);
-        m_pMotionState->setWorldTransform(tr);
+        m_pMotionState->Teleport(tr);
         m_pRigidBody->clearForces();
+        m_pRigidBody->activate();
     }
     else
     {
@@ -166,11 +228,13 @@ void RigidBodyComponent::SetWorldTransform(const glm::mat4x4& worldTransform)
 void RigidBodyComponent::SetLinearVelocity(const glm::vec3& linearVelocity)
 {
     m_pRigidBody->setLinearVelocity(btVector3(linearVelocity.x, linearVelocity.y, linearVelocity.z));
+    m_pRigidBody->activate();
 }
 
 void RigidBodyComponent::SetAngularVelocity(const glm::vec3& angularVelocity)
 {
     m_pRigidBody->setAngularVelocity(btVector3(angularVelocity.x, angularVelocity.y, angularVelocity.z));
+    m_pRigidBody->activate();
 }
 
 void RigidBodyComponent::SetMotionType(MotionType motionType)
@@ -203,11 +267,13 @@ void RigidBodyComponent::SetMotionType(MotionType motionType)
 void RigidBodyComponent::ApplyAngularForce(const glm::vec3& force)
 {
     m_pRigidBody->applyTorque(btVector3(force.x, force.y, force.z));
+    m_pRigidBody->activate();
 }
 
 void RigidBodyComponent::ApplyLinearForce(const glm::vec3& force)
 {
     m_pRigidBody->applyCentralForce(btVector3(force.x, force.y, force.z));
+    m_pRigidBody->activate();
 }
 
 void RigidBodyComponent::SetLinearFactor(const glm::vec3& linearFactor)
@@ -12,11 +12,11 @@
 #include "core/smart_ptr.hpp"
 #include "collision_component.hpp"
 #include "component_factory.hpp"
+#include "physics/motion_state.hpp"
 #include "scene/entity.hpp"
 #include "resources/resource_model.hpp"
 
 class btRigidBody;
-class btMotionState;
 
 namespace WingsOfSteel
 {
@@ -45,6 +45,7 @@ public:
 
     btRigidBody* GetBulletRigidBody() { return m_pRigidBody.get(); }
     const btRigidBody* GetBulletRigidBody() const { return m_pRigidBody.get(); }
+    MotionState* GetMotionState() { return m_pMotionState.get(); }
     glm::mat4x4 GetWorldTransform() const;
     glm::vec3 GetPosition() const;
     glm::vec3 GetLinearVelocity() const;
@@ -57,6 +58,10 @@ public:
     float GetLinearDamping() const;
     void SetAngularDamping(float value);
     float GetAngularDamping() const;
+    // Bodies which allow sleeping are deactivated by Bullet once they come to rest, and cost nothing
+    // per frame until something wakes them up.
+    bool IsSleepingAllowed() const { return m_AllowSleeping; }
+    bool IsSleeping() const;
 
     void SetWorldTransform(const glm::mat4x4& worldTransform);
     void SetLinearVelocity(const glm::vec3& linearVelocity);
@@ -76,6 +81,16 @@ public:
     const glm::vec3 GetRightVector() const;
 
     void Deserialize(const ResourceDataStore* pContext, const Json::Data& jsonData) override;
+    // Prototypes only hold the construction parameters: the body is built by each InstantiateFrom().
+    bool DeserializePrototype(const ResourceDataStore* pContext, const Json::Data& jsonData);
+    void InstantiateFrom(const RigidBodyComponent& prototype, const entt::registry& registry, EntityHandle entity);
+
+    // The world transform is saved, but velocities are not: bodies are at rest when a binary scene is loaded.
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash(
+        "motion_type:u8,mass:i32,linear_damping:f32,angular_damping:f32,linear_factor:vec3,angular_factor:vec3,allow_sleeping:bool,"
+        "world_transform:mat4,shape_type:u8,shape_axis:u8,shape_dimensions:vec3,shape_resource:string");
+    void Serialize(Binary::Writer& writer) const;
+    void Deserialize(Binary::Reader& reader);
 
     void SetOwner(EntitySharedPtr pOwner);
     EntityWeakPtr GetOwner() { return m_pOwner; }
@@ -88,11 +103,12 @@ private:
     void CalculateInvInertiaTensorWorld();
 
     std::unique_ptr<btRigidBody> m_pRigidBody;
-    std::unique_ptr<btMotionState> m_pMotionState;
+    std::unique_ptr<MotionState> m_pMotionState;
     MotionType m_MotionType{ MotionType::Dynamic };
     int32_t m_Mass{ 1 };
     float m_LinearDamping{ 0.0f };
     float m_AngularDamping{ 0.0f };
+    bool m_AllowSleeping{ false };
     glm::vec3 m_CentreOfMass{ 0.0f, 0.0f, 0.0f };
     glm::vec3 m_LinearFactor{ 1.0f, 1.0f, 1.0f };
     glm::vec3 m_AngularFactor{ 1.0f, 1.0f, 1.0f };
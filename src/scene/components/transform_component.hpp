@@ -8,6 +8,8 @@
 namespace WingsOfSteel
 {
 
+// Systems which move entities write the transform through entt::registry::patch(), so anything interested
+// in moved entities can observe on_update<TransformComponent>() rather than walking every transform.
 class TransformComponent : public IComponent
 {
 public:
@@ -23,6 +25,10 @@ public:
     {
         transform = Json::DeserializeMat4(pContext, json, "transform");
     }
+
+    static constexpr uint64_t sBinarySchema = Binary::SchemaHash("transform:mat4");
+    void Serialize(Binary::Writer& writer) const { writer.Write(transform); }
+    void Deserialize(Binary::Reader& reader) { transform = reader.ReadMat4(); }
 };
 
 REGISTER_COMPONENT(TransformComponent, "transform")
@@ -2,6 +2,8 @@
 
 #include "scene/entity.hpp"
 
+#include "scene/components/hierarchy_component.hpp"
+
 namespace WingsOfSteel
 {
 
@@ -15,6 +17,33 @@ Entity::~Entity()
 {
 }
 
+EntityWeakPtr Entity::GetParent()
+{
+    const HierarchyComponent* pHierarchyComponent = m_pScene->m_Registry.try_get<HierarchyComponent>(m_EntityHandle);
+    return pHierarchyComponent ? m_pScene->GetEntity(pHierarchyComponent->parent) : nullptr;
+}
+
+void Entity::SetParent(EntityWeakPtr pParent)
+{
+    entt::registry& registry = m_pScene->m_Registry;
+    EntitySharedPtr pParentEntity = pParent.lock();
+    if (pParentEntity == nullptr)
+    {
+        registry.remove<HierarchyComponent>(m_EntityHandle);
+    }
+    else if (registry.all_of<HierarchyComponent>(m_EntityHandle))
+    {
+        const EntityHandle parent = pParentEntity->GetHandle();
+        registry.patch<HierarchyComponent>(m_EntityHandle, [parent](HierarchyComponent& hierarchyComponent) {
+            hierarchyComponent.parent = parent;
+        });
+    }
+    else
+    {
+        registry.emplace<HierarchyComponent>(m_EntityHandle, pParentEntity->GetHandle());
+    }
+}
+
 void Entity::OnAddedToScene()
 {
 }
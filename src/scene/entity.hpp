@@ -3,6 +3,7 @@
 #include <entt/entt.hpp>
 
 #include "core/smart_ptr.hpp"
+#include "scene/entity_ref.hpp"
 #include "scene/scene.hpp"
 
 namespace WingsOfSteel
@@ -49,8 +50,12 @@ public:
         return m_pScene->m_Registry.get<T>(m_EntityHandle);
     }
     
-    EntityWeakPtr GetParent() { return m_pParentEntity; }
-    void SetParent(EntityWeakPtr pParent) { m_pParentEntity = pParent; }
+    EntityHandle GetHandle() const { return m_EntityHandle; }
+    EntityRef GetRef() const { return EntityRef(m_pScene, m_EntityHandle); }
+
+    // Parents are kept in the entity's HierarchyComponent, which is added or removed as needed.
+    EntityWeakPtr GetParent();
+    void SetParent(EntityWeakPtr pParent);
 
     virtual void OnAddedToScene();
     virtual void OnRemovedFromScene();
@@ -60,7 +65,6 @@ public:
 private:
     Scene* m_pScene{ nullptr };
     EntityHandle m_EntityHandle{ entt::null };
-    EntityWeakPtr m_pParentEntity;
     bool m_MarkedForRemoval{ false };
 };
 
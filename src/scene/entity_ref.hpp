@@ -0,0 +1,66 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel
+{
+
+// Lightweight reference to an entity: a scene and an EnTT handle, copied by value.
+// EnTT handles carry a version which is incremented whenever an entity is destroyed, so a reference
+// to a destroyed entity never becomes valid again, even if its slot is reused by a new entity.
+class EntityRef
+{
+public:
+    EntityRef() = default;
+    EntityRef(Scene* pScene, EntityHandle handle)
+        : m_pScene(pScene)
+        , m_Handle(handle)
+    {
+    }
+
+    bool IsValid() const { return m_pScene != nullptr && m_pScene->GetRegistry().valid(m_Handle); }
+    explicit operator bool() const { return IsValid(); }
+
+    Scene* GetScene() const { return m_pScene; }
+    EntityHandle GetHandle() const { return m_Handle; }
+
+    template <typename T, typename... Args>
+    T& AddComponent(Args&&... args) const
+    {
+        return m_pScene->GetRegistry().emplace<T>(m_Handle, std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    bool HasComponent() const
+    {
+        return m_pScene->GetRegistry().all_of<T>(m_Handle);
+    }
+
+    template <typename T>
+    void RemoveComponent() const
+    {
+        m_pScene->GetRegistry().remove<T>(m_Handle);
+    }
+
+    template <typename T>
+    T& GetComponent() const
+    {
+        return m_pScene->GetRegistry().get<T>(m_Handle);
+    }
+
+    template <typename T>
+    T* TryGetComponent() const
+    {
+        return m_pScene->GetRegistry().try_get<T>(m_Handle);
+    }
+
+    bool operator==(const EntityRef& other) const = default;
+
+private:
+    Scene* m_pScene{ nullptr };
+    EntityHandle m_Handle{ entt::null };
+};
+
+} // namespace WingsOfSteel
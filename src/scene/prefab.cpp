@@ -0,0 +1,80 @@
+#include "scene/prefab.hpp"
+
+#include <algorithm>
+
+#include "core/log.hpp"
+#include "resources/resource_data_store.hpp"
+#include "scene/components/component_factory.hpp"
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr const char* sTransformTypeNames[] = { "transform", "compact_transform" };
+
+Prefab::Prefab(ResourceDataStoreSharedPtr pDataStore, const Json::Data& entityData)
+    : m_pDataStore(pDataStore)
+{
+    if (!entityData.is_object())
+    {
+        Log::Warning() << m_pDataStore->GetPath() << ": prefab definition must be an object.";
+        return;
+    }
+
+    for (const char* pTransformTypeName : sTransformTypeNames)
+    {
+        auto it = entityData.find(pTransformTypeName);
+        if (it != entityData.end())
+        {
+            AddBlueprint(pTransformTypeName, *it);
+        }
+    }
+
+    for (const auto& [typeName, componentData] : entityData.items())
+    {
+        if (std::find(std::begin(sTransformTypeNames), std::end(sTransformTypeNames), typeName) == std::end(sTransformTypeNames))
+        {
+            AddBlueprint(typeName, componentData);
+        }
+    }
+}
+
+void Prefab::AddBlueprint(const std::string& typeName, const Json::Data& componentData)
+{
+    ComponentBlueprintUniquePtr pBlueprint = ComponentFactory::CreateBlueprint(m_pDataStore.get(), typeName, componentData);
+    if (pBlueprint)
+    {
+        m_Blueprints.push_back(std::move(pBlueprint));
+    }
+    else
+    {
+        Log::Warning() << m_pDataStore->GetPath() << ": unknown component type '" << typeName << "' in prefab.";
+    }
+}
+
+EntityRef Prefab::Spawn(Scene* pScene) const
+{
+    EntityHandle entity;
+    SpawnN(pScene, std::span<EntityHandle>(&entity, 1));
+    return EntityRef(pScene, entity);
+}
+
+void Prefab::SpawnN(Scene* pScene, std::span<EntityHandle> entities) const
+{
+    entt::registry& registry = pScene->GetRegistry();
+    registry.create(entities.begin(), entities.end());
+
+    for (const ComponentBlueprintUniquePtr& pBlueprint : m_Blueprints)
+    {
+        pBlueprint->Instantiate(registry, entities);
+    }
+}
+
+std::vector<EntityHandle> Prefab::SpawnN(Scene* pScene, size_t count) const
+{
+    std::vector<EntityHandle> entities(count);
+    SpawnN(pScene, entities);
+    return entities;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/serialization.hpp"
+#include "core/smart_ptr.hpp"
+#include "scene/components/component_blueprint.hpp"
+#include "scene/entity_ref.hpp"
+
+namespace WingsOfSteel
+{
+
+DECLARE_SMART_PTR(ResourceDataStore);
+DECLARE_SMART_PTR(Scene);
+
+// An entity definition from a data store, parsed once into component blueprints. Spawning a prefab doesn't
+// touch any JSON: copyable components are copied from their prototype, and the others are built from it.
+// Transforms are added before any other component, so physics objects are created at the spawned entity's transform.
+// The definition is an object with one entry per component, keyed by the name the component is registered with:
+//   { "transform": { ... }, "model": { "resource": "/models/fighter.glb" }, "rigid_body": { ... } }
+// Spawned entities are handle-based entities (see Scene::CreateEntityRef()).
+DECLARE_SMART_PTR(Prefab);
+class Prefab
+{
+public:
+    Prefab(ResourceDataStoreSharedPtr pDataStore, const Json::Data& entityData);
+    ~Prefab() = default;
+
+    EntityRef Spawn(Scene* pScene) const;
+
+    // Creates one entity per element of entities, with each component added to all of them in a single batch.
+    void SpawnN(Scene* pScene, std::span<EntityHandle> entities) const;
+    std::vector<EntityHandle> SpawnN(Scene* pScene, size_t count) const;
+
+private:
+    void AddBlueprint(const std::string& typeName, const Json::Data& componentData);
+
+    ResourceDataStoreSharedPtr m_pDataStore;
+    std::vector<ComponentBlueprintUniquePtr> m_Blueprints;
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,390 @@
+#include "scene/registry_snapshot.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <xxhash.h>
+
+#include "core/log.hpp"
+#include "pandora.hpp"
+#include "scene/components/component_factory.hpp"
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel
+{
+
+static constexpr uint32_t sRegistrySnapshotMagic = 0x50414E53; // "SNAP"
+static constexpr uint32_t sRegistryDeltaMagic = 0x544C4450; // "PDLT"
+static constexpr uint32_t sRegistrySnapshotVersion = 1;
+
+// Block header: type id, schema and size of the data which follows.
+static size_t BeginBlock(Binary::Writer& writer, const ComponentFactory::BinaryComponentType& binaryType)
+{
+    writer.Write<uint64_t>(binaryType.typeId);
+    writer.Write<uint64_t>(binaryType.schema);
+    const size_t sizeOffset = writer.GetOffset();
+    writer.Write<uint64_t>(0);
+    return sizeOffset;
+}
+
+static void EndBlock(Binary::Writer& writer, size_t sizeOffset)
+{
+    writer.WriteAt<uint64_t>(sizeOffset, writer.GetOffset() - sizeOffset - sizeof(uint64_t));
+}
+
+// Reads a block header and returns the block's type, or nullptr if the block must be skipped. The reader is left at
+// the start of the block's data, which is returned in blockData.
+static const ComponentFactory::BinaryComponentType* ReadBlock(Binary::Reader& reader, std::span<const uint8_t> data, std::span<const uint8_t>& blockData)
+{
+    const uint64_t typeId = reader.Read<uint64_t>();
+    const uint64_t schema = reader.Read<uint64_t>();
+    const uint64_t blockSize = reader.Read<uint64_t>();
+    if (!reader.IsValid() || blockSize > reader.GetRemaining())
+    {
+        // Skipping past the end puts the reader in its failed state.
+        reader.Skip(reader.GetRemaining() + 1);
+        return nullptr;
+    }
+
+    blockData = data.subspan(reader.GetOffset(), static_cast<size_t>(blockSize));
+    const ComponentFactory::BinaryComponentType* pBinaryType = ComponentFactory::FindBinaryComponentType(typeId);
+    if (pBinaryType == nullptr)
+    {
+        Log::Warning() << "Snapshot contains an unknown component type (" << typeId << "), skipping.";
+    }
+    else if (pBinaryType->schema != schema)
+    {
+        Log::Warning() << "Snapshot component '" << pBinaryType->typeName << "' was saved with a different schema, skipping.";
+        pBinaryType = nullptr;
+    }
+    return pBinaryType;
+}
+
+static std::vector<EntityHandle> CollectEntities(entt::registry& registry)
+{
+    std::vector<EntityHandle> entities;
+    auto& entityStorage = registry.storage<entt::entity>();
+    entities.reserve(entityStorage.size());
+    for (auto [entity] : entityStorage.each())
+    {
+        entities.push_back(entity);
+    }
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+/////////////////////////////////////////////////////////////////////
+// RegistrySnapshot
+/////////////////////////////////////////////////////////////////////
+
+void RegistrySnapshot::Write(Scene* pScene, Binary::Writer& writer)
+{
+    entt::registry& registry = pScene->GetRegistry();
+    const auto* pBinaryTypes = ComponentFactory::GetBinaryComponentTypes();
+
+    writer.SetEntityIndices(nullptr);
+    writer.Write<uint32_t>(sRegistrySnapshotMagic);
+    writer.Write<uint32_t>(sRegistrySnapshotVersion);
+    writer.Write<uint32_t>(pBinaryTypes ? static_cast<uint32_t>(pBinaryTypes->size()) : 0);
+
+    Binary::OutputArchive archive(writer);
+    const entt::snapshot snapshot{ registry };
+    snapshot.get<entt::entity>(archive);
+
+    if (pBinaryTypes)
+    {
+        for (const auto& [typeId, binaryType] : *pBinaryTypes)
+        {
+            const size_t sizeOffset = BeginBlock(writer, binaryType);
+            binaryType.snapshot(snapshot, archive);
+            EndBlock(writer, sizeOffset);
+        }
+    }
+}
+
+bool RegistrySnapshot::Read(Scene* pScene, std::span<const uint8_t> data)
+{
+    if (pScene->HasEntityObjects())
+    {
+        Log::Warning() << "Registry snapshots can't be restored into scenes with Entity objects.";
+        return false;
+    }
+
+    Binary::Reader reader(data);
+    const uint32_t magic = reader.Read<uint32_t>();
+    const uint32_t version = reader.Read<uint32_t>();
+    const uint32_t blockCount = reader.Read<uint32_t>();
+    if (!reader.IsValid() || magic != sRegistrySnapshotMagic || version != sRegistrySnapshotVersion)
+    {
+        Log::Warning() << "Registry snapshot data is invalid or was written by a different version.";
+        return false;
+    }
+
+    // The loader requires an empty registry. Components are deserialized in place rather than through the loader,
+    // as the loader moves components into the registry after reading them, and some components hand out pointers to
+    // themselves while deserializing (e.g. collision components waiting for a model to load).
+    entt::registry& registry = pScene->GetRegistry();
+    registry.clear();
+
+    Binary::InputArchive archive(reader);
+    entt::snapshot_loader loader{ registry };
+    loader.get<entt::entity>(archive);
+
+    bool valid = reader.IsValid();
+    for (uint32_t block = 0; block < blockCount && valid; block++)
+    {
+        std::span<const uint8_t> blockData;
+        const ComponentFactory::BinaryComponentType* pBinaryType = ReadBlock(reader, data, blockData);
+        if (!reader.IsValid())
+        {
+            valid = false;
+        }
+        else if (pBinaryType)
+        {
+            Binary::Reader blockReader(blockData);
+            valid = pBinaryType->deserialize(registry, blockReader) && blockReader.GetRemaining() == 0;
+        }
+        reader.Skip(blockData.size());
+    }
+
+    if (!valid)
+    {
+        Log::Warning() << "Registry snapshot data is invalid.";
+        registry.clear();
+        return false;
+    }
+    return true;
+}
+
+void RegistrySnapshot::WriteToFileAsync(Scene* pScene, const std::string& path, FileWriteCallback onFileWriteCompleted)
+{
+    Binary::Writer writer;
+    Write(pScene, writer);
+    GetVFS()->FileWriteAsync(path, std::move(writer.GetData()), onFileWriteCompleted);
+}
+
+/////////////////////////////////////////////////////////////////////
+// RegistryDeltaEncoder
+/////////////////////////////////////////////////////////////////////
+
+void RegistryDeltaEncoder::SetBaseline(Scene* pScene)
+{
+    entt::registry& registry = pScene->GetRegistry();
+    m_Entities = CollectEntities(registry);
+    m_ComponentHashes.clear();
+
+    const auto* pBinaryTypes = ComponentFactory::GetBinaryComponentTypes();
+    if (pBinaryTypes == nullptr)
+    {
+        return;
+    }
+
+    Binary::Writer componentWriter;
+    for (const auto& [typeId, binaryType] : *pBinaryTypes)
+    {
+        auto& hashes = m_ComponentHashes[typeId];
+        for (EntityHandle entity : binaryType.storage(registry))
+        {
+            componentWriter.GetData().clear();
+            binaryType.serializeComponent(registry, entity, componentWriter);
+            hashes[entity] = XXH3_64bits(componentWriter.GetData().data(), componentWriter.GetData().size());
+        }
+    }
+}
+
+void RegistryDeltaEncoder::WriteDelta(Scene* pScene, Binary::Writer& writer)
+{
+    entt::registry& registry = pScene->GetRegistry();
+    std::vector<EntityHandle> entities = CollectEntities(registry);
+
+    // Destroyed entities implicitly lose their components, so only their handles are written.
+    std::vector<EntityHandle> createdEntities;
+    std::vector<EntityHandle> destroyedEntities;
+    std::set_difference(entities.begin(), entities.end(), m_Entities.begin(), m_Entities.end(), std::back_inserter(createdEntities));
+    std::set_difference(m_Entities.begin(), m_Entities.end(), entities.begin(), entities.end(), std::back_inserter(destroyedEntities));
+
+    writer.SetEntityIndices(nullptr);
+    writer.Write<uint32_t>(sRegistryDeltaMagic);
+    writer.Write<uint32_t>(sRegistrySnapshotVersion);
+    writer.Write<uint32_t>(static_cast<uint32_t>(createdEntities.size()));
+    writer.Write<uint32_t>(static_cast<uint32_t>(destroyedEntities.size()));
+    const size_t blockCountOffset = writer.GetOffset();
+    writer.Write<uint32_t>(0);
+    for (EntityHandle entity : createdEntities)
+    {
+        writer.Write(entity);
+    }
+    for (EntityHandle entity : destroyedEntities)
+    {
+        writer.Write(entity);
+    }
+
+    std::unordered_map<uint64_t, std::unordered_map<EntityHandle, uint64_t>> componentHashes;
+    uint32_t blockCount = 0;
+    const auto* pBinaryTypes = ComponentFactory::GetBinaryComponentTypes();
+    if (pBinaryTypes)
+    {
+        Binary::Writer componentWriter;
+        for (const auto& [typeId, binaryType] : *pBinaryTypes)
+        {
+            auto& hashes = componentHashes[typeId];
+            auto baselineIt = m_ComponentHashes.find(typeId);
+            const std::unordered_map<EntityHandle, uint64_t>* pBaselineHashes = (baselineIt != m_ComponentHashes.cend()) ? &baselineIt->second : nullptr;
+
+            const size_t blockStart = writer.GetOffset();
+            const size_t sizeOffset = BeginBlock(writer, binaryType);
+
+            uint32_t changedCount = 0;
+            const size_t changedCountOffset = writer.GetOffset();
+            writer.Write<uint32_t>(0);
+            entt::sparse_set& storage = binaryType.storage(registry);
+            hashes.reserve(storage.size());
+            for (EntityHandle entity : storage)
+            {
+                componentWriter.GetData().clear();
+                binaryType.serializeComponent(registry, entity, componentWriter);
+                const std::vector<uint8_t>& componentData = componentWriter.GetData();
+                const uint64_t hash = XXH3_64bits(componentData.data(), componentData.size());
+                hashes[entity] = hash;
+
+                if (pBaselineHashes)
+                {
+                    auto it = pBaselineHashes->find(entity);
+                    if (it != pBaselineHashes->cend() && it->second == hash)
+                    {
+                        continue;
+                    }
+                }
+
+                writer.Write(entity);
+                writer.WriteBytes(componentData.data(), componentData.size());
+                changedCount++;
+            }
+            writer.WriteAt<uint32_t>(changedCountOffset, changedCount);
+
+            uint32_t removedCount = 0;
+            const size_t removedCountOffset = writer.GetOffset();
+            writer.Write<uint32_t>(0);
+            if (pBaselineHashes)
+            {
+                for (const auto& [entity, hash] : *pBaselineHashes)
+                {
+                    if (registry.valid(entity) && !hashes.contains(entity))
+                    {
+                        writer.Write(entity);
+                        removedCount++;
+                    }
+                }
+            }
+            writer.WriteAt<uint32_t>(removedCountOffset, removedCount);
+
+            if (changedCount == 0 && removedCount == 0)
+            {
+                writer.GetData().resize(blockStart);
+            }
+            else
+            {
+                EndBlock(writer, sizeOffset);
+                blockCount++;
+            }
+        }
+    }
+    writer.WriteAt<uint32_t>(blockCountOffset, blockCount);
+
+    m_Entities = std::move(entities);
+    m_ComponentHashes = std::move(componentHashes);
+}
+
+bool RegistryDeltaEncoder::ApplyDelta(Scene* pScene, std::span<const uint8_t> data)
+{
+    Binary::Reader reader(data);
+    const uint32_t magic = reader.Read<uint32_t>();
+    const uint32_t version = reader.Read<uint32_t>();
+    const uint32_t createdCount = reader.Read<uint32_t>();
+    const uint32_t destroyedCount = reader.Read<uint32_t>();
+    const uint32_t blockCount = reader.Read<uint32_t>();
+    if (!reader.IsValid() || magic != sRegistryDeltaMagic || version != sRegistrySnapshotVersion ||
+        (static_cast<uint64_t>(createdCount) + destroyedCount) * sizeof(uint32_t) > reader.GetRemaining())
+    {
+        Log::Warning() << "Registry delta data is invalid or was written by a different version.";
+        return false;
+    }
+
+    std::vector<EntityHandle> createdEntities(createdCount);
+    for (EntityHandle& entity : createdEntities)
+    {
+        entity = reader.ReadEntity();
+    }
+
+    // Entities are destroyed first, as a created entity can reuse the slot of a destroyed one.
+    // Any mismatch means the registry doesn't match the delta's baseline, in which case it is left partially
+    // updated and should be restored from a full snapshot.
+    entt::registry& registry = pScene->GetRegistry();
+    for (uint32_t i = 0; i < destroyedCount; i++)
+    {
+        const EntityHandle entity = reader.ReadEntity();
+        if (!registry.valid(entity))
+        {
+            Log::Warning() << "Registry delta doesn't match the registry: destroyed entity doesn't exist.";
+            return false;
+        }
+        registry.destroy(entity);
+    }
+
+    for (EntityHandle entity : createdEntities)
+    {
+        if (registry.create(entity) != entity)
+        {
+            Log::Warning() << "Registry delta doesn't match the registry: created entity is already in use.";
+            return false;
+        }
+    }
+
+    bool valid = true;
+    for (uint32_t block = 0; block < blockCount && valid; block++)
+    {
+        std::span<const uint8_t> blockData;
+        const ComponentFactory::BinaryComponentType* pBinaryType = ReadBlock(reader, data, blockData);
+        if (!reader.IsValid())
+        {
+            valid = false;
+        }
+        else if (pBinaryType)
+        {
+            Binary::Reader blockReader(blockData);
+            const uint32_t changedCount = blockReader.Read<uint32_t>();
+            for (uint32_t i = 0; i < changedCount && valid; i++)
+            {
+                const EntityHandle entity = blockReader.ReadEntity();
+                valid = blockReader.IsValid() && registry.valid(entity);
+                if (valid)
+                {
+                    pBinaryType->deserializeComponent(registry, entity, blockReader);
+                }
+            }
+
+            const uint32_t removedCount = blockReader.Read<uint32_t>();
+            entt::sparse_set& storage = pBinaryType->storage(registry);
+            for (uint32_t i = 0; i < removedCount && valid; i++)
+            {
+                const EntityHandle entity = blockReader.ReadEntity();
+                valid = blockReader.IsValid();
+                if (valid && storage.contains(entity))
+                {
+                    storage.remove(entity);
+                }
+            }
+
+            valid = valid && blockReader.IsValid() && blockReader.GetRemaining() == 0;
+        }
+        reader.Skip(blockData.size());
+    }
+
+    if (!valid)
+    {
+        Log::Warning() << "Registry delta data is invalid.";
+    }
+    return valid;
+}
+
+} // namespace WingsOfSteel
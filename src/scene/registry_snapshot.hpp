@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+#include "core/binary_serialization.hpp"
+#include "vfs/vfs.hpp"
+
+namespace WingsOfSteel
+{
+
+class Scene;
+using EntityHandle = entt::entity;
+
+// Save-game snapshots of a scene's whole registry, written through entt's snapshot machinery. Unlike binary scenes
+// (see SceneSerialization), snapshots keep the entity handles as they are, including their versions and the
+// registry's free list, so restoring a snapshot gives back exactly the same registry. Only components which satisfy
+// BinarySerializable are saved.
+// Entities created as Entity objects can't be restored, as the objects aren't part of the registry: scenes which
+// are snapshotted should only use handle-based entities.
+namespace RegistrySnapshot
+{
+
+void Write(Scene* pScene, Binary::Writer& writer);
+
+// Replaces the content of the scene's registry. Fails if the data is invalid or if the scene has Entity objects.
+bool Read(Scene* pScene, std::span<const uint8_t> data);
+
+// Writes the snapshot on the main thread, then hands the data to the VFS to be written to disk in the background.
+void WriteToFileAsync(Scene* pScene, const std::string& path, FileWriteCallback onFileWriteCompleted = nullptr);
+
+} // namespace RegistrySnapshot
+
+// Encodes the changes made to a scene since a baseline, for autosaves and networking. Components are compared by a
+// hash of their binary form, so a delta only contains the components which actually changed, as well as the entities
+// which were created or destroyed and the components which were removed.
+// A delta can only be applied to a registry which matches its baseline, such as one restored from the snapshot the
+// baseline was taken with, followed by every delta written since.
+class RegistryDeltaEncoder
+{
+public:
+    RegistryDeltaEncoder() = default;
+    ~RegistryDeltaEncoder() = default;
+
+    // Makes the scene's current state the baseline for the next delta. Usually called right after writing a snapshot.
+    void SetBaseline(Scene* pScene);
+
+    // Writes the changes since the baseline, then makes the scene's current state the new baseline.
+    void WriteDelta(Scene* pScene, Binary::Writer& writer);
+
+    static bool ApplyDelta(Scene* pScene, std::span<const uint8_t> data);
+
+private:
+    // Sorted handles of the entities in the baseline.
+    std::vector<EntityHandle> m_Entities;
+    // Hash of each component in the baseline, by component type id.
+    std::unordered_map<uint64_t, std::unordered_map<EntityHandle, uint64_t>> m_ComponentHashes;
+};
+
+} // namespace WingsOfSteel
@@ -1,17 +1,23 @@
 #include "scene/scene.hpp"
 
+#include <algorithm>
+
 #include "core/log.hpp"
+#include "core/profiler.hpp"
 #include "scene/components/camera_component.hpp"
 #include "scene/components/entity_reference_component.hpp"
 #include "scene/components/transform_component.hpp"
 #include "scene/entity.hpp"
+#include "scene/entity_ref.hpp"
 #include "scene/systems/system.hpp"
+#include "scene/systems/transform_hierarchy_system.hpp"
 
 namespace WingsOfSteel
 {
 
 Scene::Scene()
 {
+    AddSystem<TransformHierarchySystem>();
 }
 
 Scene::~Scene()
@@ -24,14 +30,27 @@ void Scene::Initialize()
 
 void Scene::Update(float delta)
 {
-    ProcessEntitiesToAdd();
+    {
+        PROFILE_SCOPE("Add entities");
+        ProcessEntitiesToAdd();
+    }
 
-    for (auto& pSystem : m_Systems)
+    if (m_SystemScheduleDirty)
     {
-        pSystem->Update(delta);
+        // Hierarchies are propagated once every other system has moved their parents.
+        const System* pTransformHierarchySystem = GetSystem<TransformHierarchySystem>();
+        std::stable_partition(m_Systems.begin(), m_Systems.end(), [pTransformHierarchySystem](const SystemUniquePtr& pSystem) {
+            return pSystem.get() != pTransformHierarchySystem;
+        });
+        m_SystemScheduler.Build(m_Registry, m_Systems);
+        m_SystemScheduleDirty = false;
     }
+    m_SystemScheduler.Update(delta);
 
-    ProcessEntitiesToRemove();
+    {
+        PROFILE_SCOPE("Remove entities");
+        ProcessEntitiesToRemove();
+    }
 }
 
 EntitySharedPtr Scene::CreateEntity()
@@ -48,7 +67,11 @@ EntitySharedPtr Scene::CreateEntity()
 
 void Scene::RemoveEntity(EntitySharedPtr pEntity)
 {
-    pEntity->m_MarkedForRemoval = true;
+    if (!pEntity->m_MarkedForRemoval)
+    {
+        pEntity->m_MarkedForRemoval = true;
+        m_EntitiesPendingRemoval.push_back(pEntity);
+    }
 }
 
 EntitySharedPtr Scene::GetEntity(EntityHandle handle)
@@ -64,6 +87,36 @@ EntitySharedPtr Scene::GetEntity(EntityHandle handle)
     }
 }
 
+EntityRef Scene::CreateEntityRef()
+{
+    return EntityRef(this, m_Registry.create());
+}
+
+void Scene::RemoveEntity(EntityRef entity)
+{
+    if (!entity.IsValid())
+    {
+        return;
+    }
+
+    // Entities which were created as Entity objects are removed through them, so OnRemovedFromScene() is called.
+    EntityReferenceComponent* pEntityReferenceComponent = entity.TryGetComponent<EntityReferenceComponent>();
+    EntitySharedPtr pEntity = pEntityReferenceComponent ? pEntityReferenceComponent->GetOwner() : nullptr;
+    if (pEntity)
+    {
+        RemoveEntity(pEntity);
+    }
+    else
+    {
+        m_HandlesPendingRemoval.push_back(entity.GetHandle());
+    }
+}
+
+EntityRef Scene::GetEntityRef(EntityHandle handle)
+{
+    return m_Registry.valid(handle) ? EntityRef(this, handle) : EntityRef();
+}
+
 void Scene::SetCamera(EntitySharedPtr pCamera)
 {
     if (!pCamera->HasComponent<CameraComponent>())
@@ -94,19 +147,37 @@ void Scene::ProcessEntitiesToAdd()
 
 void Scene::ProcessEntitiesToRemove()
 {
-    for (auto it = m_Entities.begin(); it != m_Entities.end();)
+    // Only the entities queued for removal are visited, so the cost doesn't depend on how many entities are alive.
+    if (m_EntitiesPendingRemoval.empty() && m_HandlesPendingRemoval.empty())
     {
-        if (it->second->m_MarkedForRemoval)
-        {
-            it->second->OnRemovedFromScene();
-            m_Registry.destroy(it->first);
-            it = m_Entities.erase(it);
-        }
-        else
+        return;
+    }
+
+    // OnRemovedFromScene() and the components' destroy callbacks may queue more removals, so the queues are swapped out
+    // before being walked. Anything queued while they are processed is removed on the next update.
+    m_EntitiesBeingRemoved.swap(m_EntitiesPendingRemoval);
+    for (EntitySharedPtr& pEntity : m_EntitiesBeingRemoved)
+    {
+        // Entities created during this update haven't been added yet. They are kept until the next update,
+        // so they are still added and removed in order.
+        if (m_Entities.erase(pEntity->m_EntityHandle) == 0)
         {
-            ++it;
+            m_EntitiesPendingRemoval.push_back(std::move(pEntity));
+            continue;
         }
+
+        m_HandlesPendingRemoval.push_back(pEntity->m_EntityHandle);
+        pEntity->OnRemovedFromScene();
     }
+    m_EntitiesBeingRemoved.clear();
+
+    // The same entity may have been queued more than once.
+    m_HandlesBeingRemoved.swap(m_HandlesPendingRemoval);
+    std::sort(m_HandlesBeingRemoved.begin(), m_HandlesBeingRemoved.end());
+    auto last = std::unique(m_HandlesBeingRemoved.begin(), m_HandlesBeingRemoved.end());
+    last = std::remove_if(m_HandlesBeingRemoved.begin(), last, [this](EntityHandle handle) { return !m_Registry.valid(handle); });
+    m_Registry.destroy(m_HandlesBeingRemoved.begin(), last);
+    m_HandlesBeingRemoved.clear();
 }
 
 entt::registry& Scene::GetRegistry()
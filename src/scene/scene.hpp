@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -7,7 +9,9 @@
 #include <entt/entt.hpp>
 #include <webgpu/webgpu_cpp.h>
 
+#include "core/log.hpp"
 #include "core/smart_ptr.hpp"
+#include "scene/systems/system_scheduler.hpp"
 
 namespace WingsOfSteel
 {
@@ -15,6 +19,7 @@ namespace WingsOfSteel
 DECLARE_SMART_PTR(Entity);
 DECLARE_SMART_PTR(Scene);
 DECLARE_SMART_PTR(System);
+class EntityRef;
 
 using EntityHandle = entt::entity;
 
@@ -36,31 +41,81 @@ public:
     void RemoveEntity(EntitySharedPtr pEntity);
     EntitySharedPtr GetEntity(EntityHandle handle);
 
+    // Handle-based entities only exist in the registry: creating one doesn't allocate an Entity object.
+    // This is the preferred way of creating entities in bulk. Removal is deferred to the end of the update,
+    // as with Entity objects. GetEntity() returns nullptr for these entities.
+    EntityRef CreateEntityRef();
+    void RemoveEntity(EntityRef entity);
+    EntityRef GetEntityRef(EntityHandle handle);
+    // Whether any entities were created as Entity objects, as opposed to handle-based entities.
+    bool HasEntityObjects() const { return !m_Entities.empty() || !m_EntitiesPendingAdd.empty(); }
+
+    // Systems are looked up by their exact type, so a system must be retrieved with the same type it was added with.
     template <typename T>
     T* GetSystem() const
     {
         static_assert(std::is_base_of<System, T>::value, "T must inherit from System");
-        for (const auto& pSystem : m_Systems)
-        {
-            if (auto* pTypedSystem = dynamic_cast<T*>(pSystem.get()))
-            {
-                return pTypedSystem;
-            }
-        }
-        return nullptr;
+        const size_t index = entt::type_index<T>::value();
+        return index < m_SystemsByType.size() ? static_cast<T*>(m_SystemsByType[index]) : nullptr;
     }
 
+    // Systems are updated in the order they are added, unless reordered with SetSystemUpdateOrder(). Systems which
+    // declare their component access may be updated in parallel with the systems they don't conflict with.
     template <typename T, typename... Args>
     T* AddSystem(Args&&... args)
     {
         static_assert(std::is_base_of<System, T>::value, "T must inherit from System");
+        const size_t index = entt::type_index<T>::value();
+        if (index < m_SystemsByType.size() && m_SystemsByType[index] != nullptr)
+        {
+            Log::Error() << "System " << entt::type_name<T>::value() << " has already been added to this scene.";
+            return nullptr;
+        }
+
         auto pSystem = std::make_unique<T>(std::forward<Args>(args)...);
         T* pTypedSystem = pSystem.get();
+        pSystem->m_Name = entt::type_name<T>::value();
         pSystem->Initialize(this);
         m_Systems.push_back(std::move(pSystem));
+        m_SystemScheduleDirty = true;
+
+        if (index >= m_SystemsByType.size())
+        {
+            m_SystemsByType.resize(index + 1, nullptr);
+        }
+        m_SystemsByType[index] = pTypedSystem;
         return pTypedSystem;
     }
 
+    // Makes the given systems update first, in the order they are listed. Any other systems update after them,
+    // keeping their relative order.
+    template <typename... Ts>
+    void SetSystemUpdateOrder()
+    {
+        static_assert(sizeof...(Ts) > 0, "At least one system must be given");
+        const System* order[] = { GetSystem<Ts>()... };
+        for (size_t i = 0; i < sizeof...(Ts); i++)
+        {
+            if (order[i] == nullptr)
+            {
+                Log::Error() << "SetSystemUpdateOrder: all systems must have been added to the scene.";
+                return;
+            }
+        }
+
+        std::stable_partition(m_Systems.begin(), m_Systems.end(), [&order](const SystemUniquePtr& pSystem) {
+            return std::find(std::begin(order), std::end(order), pSystem.get()) != std::end(order);
+        });
+        std::stable_sort(m_Systems.begin(), m_Systems.begin() + sizeof...(Ts), [&order](const SystemUniquePtr& pA, const SystemUniquePtr& pB) {
+            return std::find(std::begin(order), std::end(order), pA.get()) < std::find(std::begin(order), std::end(order), pB.get());
+        });
+        m_SystemScheduleDirty = true;
+    }
+
+    // Per-system timings from the last update.
+    const std::vector<SystemTiming>& GetSystemTimings() const { return m_SystemScheduler.GetTimings(); }
+    SystemScheduler& GetSystemScheduler() { return m_SystemScheduler; }
+
     void SetCamera(EntitySharedPtr pCamera);
     EntitySharedPtr GetCamera() const;
 
@@ -75,9 +130,17 @@ private:
 
     std::unordered_map<entt::entity, EntitySharedPtr> m_Entities;
     std::vector<EntitySharedPtr> m_EntitiesPendingAdd;
+    std::vector<EntitySharedPtr> m_EntitiesPendingRemoval;
+    std::vector<EntityHandle> m_HandlesPendingRemoval;
+    // The queues being processed by ProcessEntitiesToRemove(), kept so their storage is reused.
+    std::vector<EntitySharedPtr> m_EntitiesBeingRemoved;
+    std::vector<EntityHandle> m_HandlesBeingRemoved;
     EntityWeakPtr m_pCamera;
     entt::registry m_Registry;
     std::vector<SystemUniquePtr> m_Systems;
+    std::vector<System*> m_SystemsByType; // Indexed by entt::type_index.
+    SystemScheduler m_SystemScheduler;
+    bool m_SystemScheduleDirty{ false };
 };
 
 } // namespace WingsOfSteel
\ No newline at end of file
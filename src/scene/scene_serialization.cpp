@@ -0,0 +1,133 @@
+#include "scene/scene_serialization.hpp"
+
+#include <unordered_map>
+
+#include "core/log.hpp"
+#include "scene/components/component_factory.hpp"
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel::SceneSerialization
+{
+
+static constexpr uint32_t sBinarySceneMagic = 0x4E435350; // "PSCN"
+
+void SaveBinary(Scene* pScene, Binary::Writer& writer)
+{
+    entt::registry& registry = pScene->GetRegistry();
+    const auto* pBinaryTypes = ComponentFactory::GetBinaryComponentTypes();
+
+    // Entities are numbered in the order they are found. Components refer to entities by these numbers, which
+    // the loader maps to the handles it creates.
+    std::vector<const ComponentFactory::BinaryComponentType*> blockTypes;
+    std::unordered_map<EntityHandle, uint32_t> entityIndices;
+    if (pBinaryTypes)
+    {
+        for (const auto& [typeId, binaryType] : *pBinaryTypes)
+        {
+            const entt::sparse_set& storage = binaryType.storage(registry);
+            if (storage.empty())
+            {
+                continue;
+            }
+
+            blockTypes.push_back(&binaryType);
+            for (EntityHandle entity : storage)
+            {
+                entityIndices.try_emplace(entity, static_cast<uint32_t>(entityIndices.size()));
+            }
+        }
+    }
+
+    writer.Write<uint32_t>(sBinarySceneMagic);
+    writer.Write<uint32_t>(sBinarySceneVersion);
+    writer.Write<uint32_t>(static_cast<uint32_t>(entityIndices.size()));
+    writer.Write<uint32_t>(static_cast<uint32_t>(blockTypes.size()));
+
+    writer.SetEntityIndices(&entityIndices);
+    for (const ComponentFactory::BinaryComponentType* pBinaryType : blockTypes)
+    {
+        writer.Write<uint64_t>(pBinaryType->typeId);
+        writer.Write<uint64_t>(pBinaryType->schema);
+        const size_t sizeOffset = writer.GetOffset();
+        writer.Write<uint64_t>(0);
+        pBinaryType->serialize(registry, writer);
+        writer.WriteAt<uint64_t>(sizeOffset, writer.GetOffset() - sizeOffset - sizeof(uint64_t));
+    }
+    writer.SetEntityIndices(nullptr);
+}
+
+bool LoadBinary(Scene* pScene, std::span<const uint8_t> data, std::vector<EntityHandle>* pLoadedEntities)
+{
+    Binary::Reader reader(data);
+    const uint32_t magic = reader.Read<uint32_t>();
+    const uint32_t version = reader.Read<uint32_t>();
+    const uint32_t entityCount = reader.Read<uint32_t>();
+    const uint32_t blockCount = reader.Read<uint32_t>();
+    if (!reader.IsValid() || magic != sBinarySceneMagic)
+    {
+        Log::Warning() << "Binary scene data is invalid.";
+        return false;
+    }
+    else if (version != sBinarySceneVersion)
+    {
+        Log::Warning() << "Binary scene has version " << version << ", expected " << sBinarySceneVersion << ".";
+        return false;
+    }
+
+    // Every entity needs at least a component index, which keeps a corrupt count from creating millions of entities.
+    if (entityCount > reader.GetRemaining() / sizeof(uint32_t))
+    {
+        Log::Warning() << "Binary scene data is invalid.";
+        return false;
+    }
+
+    entt::registry& registry = pScene->GetRegistry();
+    std::vector<EntityHandle> entities(entityCount);
+    registry.create(entities.begin(), entities.end());
+
+    bool valid = true;
+    for (uint32_t block = 0; block < blockCount && valid; block++)
+    {
+        const uint64_t typeId = reader.Read<uint64_t>();
+        const uint64_t schema = reader.Read<uint64_t>();
+        const uint64_t blockSize = reader.Read<uint64_t>();
+        if (!reader.IsValid() || blockSize > reader.GetRemaining())
+        {
+            valid = false;
+            break;
+        }
+
+        const ComponentFactory::BinaryComponentType* pBinaryType = ComponentFactory::FindBinaryComponentType(typeId);
+        if (pBinaryType == nullptr)
+        {
+            Log::Warning() << "Binary scene contains an unknown component type (" << typeId << "), skipping.";
+        }
+        else if (pBinaryType->schema != schema)
+        {
+            Log::Warning() << "Binary scene component '" << pBinaryType->typeName << "' was saved with a different schema, skipping.";
+        }
+        else
+        {
+            Binary::Reader blockReader(data.subspan(reader.GetOffset(), static_cast<size_t>(blockSize)));
+            blockReader.SetEntities(entities);
+            valid = pBinaryType->deserialize(registry, blockReader) && blockReader.GetRemaining() == 0;
+        }
+
+        reader.Skip(static_cast<size_t>(blockSize));
+    }
+
+    if (!valid)
+    {
+        Log::Warning() << "Binary scene data is invalid.";
+        registry.destroy(entities.begin(), entities.end());
+        return false;
+    }
+
+    if (pLoadedEntities)
+    {
+        *pLoadedEntities = std::move(entities);
+    }
+    return true;
+}
+
+} // namespace WingsOfSteel::SceneSerialization
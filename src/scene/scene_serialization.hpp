@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+#include "core/binary_serialization.hpp"
+
+namespace WingsOfSteel
+{
+
+class Scene;
+using EntityHandle = entt::entity;
+
+// Binary scenes, used for saves and cooked levels. The data is made of a header, followed by one block per component
+// type holding every component of that type. Each block is tagged with the type's name hash and schema hash, so
+// blocks for unknown types or outdated schemas are skipped (with a warning) rather than misread.
+// Only components which satisfy BinarySerializable are saved, and entities are loaded as handle-based entities.
+namespace SceneSerialization
+{
+
+static constexpr uint32_t sBinarySceneVersion = 1;
+
+// Writes every entity which has at least one binary serializable component.
+void SaveBinary(Scene* pScene, Binary::Writer& writer);
+
+// The data isn't copied and can come straight from a memory-mapped file. If the data is invalid, nothing is added to
+// the scene and false is returned. The created entities are optionally returned in pLoadedEntities.
+bool LoadBinary(Scene* pScene, std::span<const uint8_t> data, std::vector<EntityHandle>* pLoadedEntities = nullptr);
+
+} // namespace SceneSerialization
+} // namespace WingsOfSteel
@@ -20,6 +20,12 @@ public:
 
     void Initialize(Scene* pScene) override{};
     void Update(float delta) override;
+    bool DeclareAccess(SystemAccess& access) const override
+    {
+        // Creates GPU buffers when the landscape changes.
+        access.Read<LandscapeComponent>().MainThreadOnly();
+        return true;
+    }
 
     void Render(wgpu::RenderPassEncoder& renderPass);
 
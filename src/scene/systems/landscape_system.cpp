@@ -19,6 +19,17 @@ LandscapeSystem::~LandscapeSystem()
 {
 }
 
+void LandscapeSystem::Update(float delta)
+{
+    auto landscapesView = m_pScene->GetRegistry().view<LandscapeComponent>();
+    landscapesView.each([this](LandscapeComponent& landscapeComponent) {
+        if (landscapeComponent.GenerationRequested)
+        {
+            GenerateInternal(landscapeComponent);
+        }
+    });
+}
+
 void LandscapeSystem::Generate(EntitySharedPtr pLandscapeEntity)
 {
     if (!pLandscapeEntity->HasComponent<LandscapeComponent>())
@@ -61,8 +72,7 @@ void LandscapeSystem::GenerateInternal(LandscapeComponent& landscapeComponent)
     }
 
     landscapeComponent.Generation++;
-
-    GenerateDebugHeightmapTexture(landscapeComponent);
+    landscapeComponent.GenerationRequested = false;
 }
 
 void LandscapeSystem::GenerateDebugHeightmapTexture(LandscapeComponent& landscapeComponent)
@@ -96,6 +106,11 @@ void LandscapeSystem::DrawDebugUI()
     }
 
     LandscapeComponent& landscapeComponent = pLandscapeEntity->GetComponent<LandscapeComponent>();
+    if (landscapeComponent.Generation != m_DebugHeightmapGeneration)
+    {
+        GenerateDebugHeightmapTexture(landscapeComponent);
+        m_DebugHeightmapGeneration = landscapeComponent.Generation;
+    }
 
     ImGui::Begin("Landscape generator", &m_ShowDebugUI, ImGuiWindowFlags_AlwaysAutoResize);
 
@@ -128,7 +143,7 @@ void LandscapeSystem::DrawDebugUI()
 
     if (ImGui::Button("Generate"))
     {
-        GenerateInternal(landscapeComponent);
+        landscapeComponent.GenerationRequested = true;
     }
     ImGui::PopItemWidth();
     ImGui::EndGroup();
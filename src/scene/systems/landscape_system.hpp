@@ -16,9 +16,17 @@ public:
     LandscapeSystem();
     ~LandscapeSystem();
 
-    void Initialize(Scene* pScene) override{};
-    void Update(float delta) override{};
-
+    void Initialize(Scene* pScene) override { m_pScene = pScene; }
+    void Update(float delta) override;
+    bool DeclareAccess(SystemAccess& access) const override
+    {
+        // Only generates heightmaps: the debug texture is created by the debug UI, on the main thread.
+        access.Write<LandscapeComponent>();
+        return true;
+    }
+
+    // Generates the heightmap immediately. Landscapes can also be regenerated during the system's update by
+    // setting their LandscapeComponent::GenerationRequested.
     void Generate(EntitySharedPtr pLandscapeEntity);
 
     void DrawDebugUI() override;
@@ -26,7 +34,10 @@ public:
 private:
     void GenerateInternal(LandscapeComponent& landscapeComponent);
     void GenerateDebugHeightmapTexture(LandscapeComponent& landscapeComponent);
+
+    Scene* m_pScene{ nullptr };
     EntityWeakPtr m_pLandscapeEntity;
+    uint32_t m_DebugHeightmapGeneration{ 0 };
 };
 
 } // namespace WingsOfSteel
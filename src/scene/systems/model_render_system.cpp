@@ -3,6 +3,7 @@
 #include "debug_visualization/model_visualization.hpp"
 #include "pandora.hpp"
 #include "resources/resource_model.hpp"
+#include "scene/components/compact_transform_component.hpp"
 #include "scene/components/model_component.hpp"
 #include "scene/components/transform_component.hpp"
 #include "scene/scene.hpp"
@@ -36,7 +37,7 @@ void ModelRenderSystem::Render(wgpu::RenderPassEncoder& renderPass)
         instanceData.shaderParameters.clear();
     }
 
-    view.each([this](const auto entity, ModelComponent& modelComponent, TransformComponent& transformComponent) {
+    auto addInstance = [this](const ModelComponent& modelComponent, const glm::mat4& transform) {
         ResourceModelSharedPtr pResourceModel = modelComponent.GetModel();
         if (pResourceModel)
         {
@@ -48,9 +49,19 @@ void ModelRenderSystem::Render(wgpu::RenderPassEncoder& renderPass)
             }
 
             m_InstanceData[idx].pModel = pResourceModel;
-            m_InstanceData[idx].transforms.push_back(transformComponent.transform);
+            m_InstanceData[idx].transforms.push_back(transform);
             m_InstanceData[idx].shaderParameters.push_back(modelComponent.GetShaderParameters());
         }
+    };
+
+    view.each([&addInstance](const auto entity, ModelComponent& modelComponent, TransformComponent& transformComponent) {
+        addInstance(modelComponent, transformComponent.transform);
+    });
+
+    // Compact transforms are only turned into matrices here, straight into the instance arrays.
+    auto compactView = registry.view<ModelComponent, CompactTransformComponent>(entt::exclude<TransformComponent>);
+    compactView.each([&addInstance](const auto entity, ModelComponent& modelComponent, CompactTransformComponent& transformComponent) {
+        addInstance(modelComponent, transformComponent.ToMatrix());
     });
 
     for (auto& instanceData : m_InstanceData)
@@ -22,6 +22,12 @@ public:
 
     void Initialize(Scene* pScene) override{};
     void Update(float delta) override{};
+    bool DeclareAccess(SystemAccess& access) const override
+    {
+        // The update doesn't access any components: instances are gathered by Render(), on the main thread,
+        // once the scene has finished updating.
+        return true;
+    }
 
     void Render(wgpu::RenderPassEncoder& renderPass);
 
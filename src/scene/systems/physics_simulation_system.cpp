@@ -1,31 +1,147 @@
 #include "scene/systems/physics_simulation_system.hpp"
 
+#include "core/task_scheduler.hpp"
 #include "pandora.hpp"
+#include "physics/collision_shape.hpp"
+#include "physics/motion_state.hpp"
 #include "physics/physics_visualization.hpp"
+#include "scene/components/compact_transform_component.hpp"
 #include "scene/components/ghost_component.hpp"
+#include "scene/components/landscape_component.hpp"
 #include "scene/components/rigid_body_component.hpp"
 #include "scene/components/transform_component.hpp"
 #include "scene/scene.hpp"
 
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
+#include <glm/common.hpp>
 #include <glm/gtc/matrix_access.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#if defined(TARGET_PLATFORM_NATIVE)
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#endif
+
 namespace WingsOfSteel
 {
 
-PhysicsSimulationSystem::PhysicsSimulationSystem()
+// Number of queries each thread takes at a time when running batched queries.
+static constexpr size_t sQueryGrainSize = 64;
+
+static int EntityToUserIndex(EntityHandle entity)
+{
+    return entity == entt::null ? -1 : static_cast<int>(entt::to_integral(entity));
+}
+
+static EntityHandle CollisionObjectToHandle(const btCollisionObject* pCollisionObject)
+{
+    // Every collision object added to the world stores its entity's handle as the user index.
+    const int userIndex = pCollisionObject->getUserIndex();
+    return userIndex == -1 ? EntityHandle{ entt::null } : static_cast<EntityHandle>(userIndex);
+}
+
+static bool IsIgnored(const btBroadphaseProxy* pProxy, int ignoredUserIndex)
+{
+    const btCollisionObject* pCollisionObject = static_cast<const btCollisionObject*>(pProxy->m_clientObject);
+    return ignoredUserIndex != -1 && pCollisionObject->getUserIndex() == ignoredUserIndex;
+}
+
+class ClosestRayCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+public:
+    ClosestRayCallback(const btVector3& from, const btVector3& to, int ignoredUserIndex)
+        : btCollisionWorld::ClosestRayResultCallback(from, to)
+        , m_IgnoredUserIndex(ignoredUserIndex)
+    {
+    }
+
+    bool needsCollision(btBroadphaseProxy* pProxy) const override
+    {
+        return !IsIgnored(pProxy, m_IgnoredUserIndex) && btCollisionWorld::ClosestRayResultCallback::needsCollision(pProxy);
+    }
+
+private:
+    int m_IgnoredUserIndex;
+};
+
+class ClosestConvexCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+public:
+    ClosestConvexCallback(const btVector3& from, const btVector3& to, int ignoredUserIndex)
+        : btCollisionWorld::ClosestConvexResultCallback(from, to)
+        , m_IgnoredUserIndex(ignoredUserIndex)
+    {
+    }
+
+    bool needsCollision(btBroadphaseProxy* pProxy) const override
+    {
+        return !IsIgnored(pProxy, m_IgnoredUserIndex) && btCollisionWorld::ClosestConvexResultCallback::needsCollision(pProxy);
+    }
+
+private:
+    int m_IgnoredUserIndex;
+};
+
+static void WriteHit(const btCollisionObject* pCollisionObject, const btVector3& position, const btVector3& normal, float fraction, QueryHit& hit)
+{
+    hit.hit = true;
+    hit.entity = CollisionObjectToHandle(pCollisionObject);
+    hit.position = glm::vec3(position.x(), position.y(), position.z());
+    hit.normal = glm::vec3(normal.x(), normal.y(), normal.z());
+    hit.fraction = fraction;
+}
+
+PhysicsSimulationSystem::PhysicsSimulationSystem(Mode mode)
+    : m_Mode(mode)
 {
-    m_pCollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
-    m_pDispatcher = std::make_unique<btCollisionDispatcher>(m_pCollisionConfiguration.get());
+#if defined(TARGET_PLATFORM_WEB)
+    if (m_Mode == Mode::Multithreaded)
+    {
+        Log::Warning() << "PhysicsSimulationSystem::Mode::Multithreaded is unsupported for TARGET_PLATFORM_WEB, falling back to single threaded.";
+        m_Mode = Mode::SingleThreaded;
+    }
+#endif
+
     m_pBroadphase = std::make_unique<btDbvtBroadphase>();
-    m_pSolver = std::make_unique<btSequentialImpulseConstraintSolver>();
-    m_pWorld = std::make_unique<btDiscreteDynamicsWorld>(m_pDispatcher.get(), m_pBroadphase.get(), m_pSolver.get(), m_pCollisionConfiguration.get());
+
+    if (m_Mode == Mode::SingleThreaded)
+    {
+        m_pCollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
+        m_pDispatcher = std::make_unique<btCollisionDispatcher>(m_pCollisionConfiguration.get());
+        m_pSolver = std::make_unique<btSequentialImpulseConstraintSolver>();
+        m_pWorld = std::make_unique<btDiscreteDynamicsWorld>(m_pDispatcher.get(), m_pBroadphase.get(), m_pSolver.get(), m_pCollisionConfiguration.get());
+    }
+#if defined(TARGET_PLATFORM_NATIVE)
+    else
+    {
+        // Bullet's global task scheduler is owned by the engine, which points it at the TaskScheduler.
+        // The pools are shared between threads, so they need to be large enough to avoid falling back to the heap.
+        btDefaultCollisionConstructionInfo constructionInfo;
+        constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+        constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+        m_pCollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>(constructionInfo);
+        m_pDispatcher = std::make_unique<btCollisionDispatcherMt>(m_pCollisionConfiguration.get());
+
+        // Each thread solving an island needs its own solver.
+        auto pSolverPool = std::make_unique<btConstraintSolverPoolMt>(static_cast<int>(GetTaskScheduler()->GetMaxThreadCount()));
+        m_pWorld = std::make_unique<btDiscreteDynamicsWorldMt>(m_pDispatcher.get(), m_pBroadphase.get(), pSolverPool.get(), nullptr, m_pCollisionConfiguration.get());
+        m_pSolver = std::move(pSolverPool);
+    }
+#endif
+
     m_pWorld->setGravity(btVector3(0, 0, 0));
 
+    // Contact pairs are gathered after every tick, so contacts lasting less than an update still generate events.
+    m_pWorld->setInternalTickCallback([](btDynamicsWorld* pWorld, btScalar timeStep) {
+        PhysicsSimulationSystem* pSystem = static_cast<PhysicsSimulationSystem*>(pWorld->getWorldUserInfo());
+        pSystem->m_ContactEvents.OnStep(pSystem->m_pDispatcher.get());
+    }, this);
+
     m_pPhysicsVisualization = std::make_unique<PhysicsVisualization>(m_pWorld.get());
 }
 
@@ -35,6 +151,7 @@ PhysicsSimulationSystem::~PhysicsSimulationSystem()
     m_pScene->GetRegistry().on_destroy<RigidBodyComponent>().disconnect<&PhysicsSimulationSystem::OnRigidBodyDestroyed>(this);
     m_pScene->GetRegistry().on_construct<GhostComponent>().disconnect<&PhysicsSimulationSystem::OnGhostComponentCreated>(this);
     m_pScene->GetRegistry().on_destroy<GhostComponent>().disconnect<&PhysicsSimulationSystem::OnGhostComponentDestroyed>(this);
+    m_pScene->GetRegistry().on_destroy<LandscapeComponent>().disconnect<&PhysicsSimulationSystem::OnLandscapeComponentDestroyed>(this);
 }
 
 void PhysicsSimulationSystem::Initialize(Scene* pScene)
@@ -44,6 +161,7 @@ void PhysicsSimulationSystem::Initialize(Scene* pScene)
     m_pScene->GetRegistry().on_destroy<RigidBodyComponent>().connect<&PhysicsSimulationSystem::OnRigidBodyDestroyed>(this);
     m_pScene->GetRegistry().on_construct<GhostComponent>().connect<&PhysicsSimulationSystem::OnGhostComponentCreated>(this);
     m_pScene->GetRegistry().on_destroy<GhostComponent>().connect<&PhysicsSimulationSystem::OnGhostComponentDestroyed>(this);
+    m_pScene->GetRegistry().on_destroy<LandscapeComponent>().connect<&PhysicsSimulationSystem::OnLandscapeComponentDestroyed>(this);
 }
 
 void PhysicsSimulationSystem::Update(float delta)
@@ -55,7 +173,7 @@ void PhysicsSimulationSystem::Update(float delta)
             RigidBodyComponent& rigidBodyComponent = m_pScene->GetRegistry().get<RigidBodyComponent>(entityToAdd.entity);
             if (rigidBodyComponent.GetBulletRigidBody())
             {
-                m_pWorld->addRigidBody(rigidBodyComponent.GetBulletRigidBody());
+                AddRigidBody(entityToAdd.entity, rigidBodyComponent);
                 entityToAdd.added = true;
             }
         }
@@ -72,7 +190,7 @@ void PhysicsSimulationSystem::Update(float delta)
             GhostComponent& ghostComponent = m_pScene->GetRegistry().get<GhostComponent>(entityToAdd.entity);
             if (ghostComponent.GetBulletGhostObject())
             {
-                m_pWorld->addCollisionObject(ghostComponent.GetBulletGhostObject());
+                AddGhostObject(entityToAdd.entity, ghostComponent);
                 entityToAdd.added = true;
             }
         }
@@ -82,20 +200,257 @@ void PhysicsSimulationSystem::Update(float delta)
             m_GhostEntitiesToAdd.end());
     }
 
-    m_pWorld->stepSimulation(delta, 5);
+    UpdateLandscapeCollisions();
+
+    m_Accumulator += delta;
+    uint32_t ticks = static_cast<uint32_t>(m_Accumulator / m_FixedTimeStep);
+    m_Accumulator -= ticks * m_FixedTimeStep;
+    if (ticks > m_MaxTicksPerUpdate)
+    {
+        ticks = m_MaxTicksPerUpdate;
+    }
+
+    m_ContactEvents.BeginUpdate();
+    Tick(ticks);
+    m_ContactEvents.EndUpdate(m_pScene->GetRegistry());
     m_pPhysicsVisualization->Update();
 
-    entt::registry& registry = GetActiveScene()->GetRegistry();
+    UpdateInterpolatedMotionStates(ticks > 0);
+    InterpolateTransforms();
+    SyncGhostTransforms();
+}
 
-    auto rigidBodiesView = registry.view<const RigidBodyComponent, TransformComponent>();
-    rigidBodiesView.each([](const auto entity, const RigidBodyComponent& rigidBodyComponent, TransformComponent& transformComponent) {
-        transformComponent.transform = rigidBodyComponent.GetWorldTransform();
-    });
+bool PhysicsSimulationSystem::DeclareAccess(SystemAccess& access) const
+{
+    // The simulation runs its own parallel loops, which would run serially if started from one of the task scheduler's
+    // threads, and transform updates are signalled to observers, which may do anything.
+    access.Read<LandscapeComponent>().Write<RigidBodyComponent, GhostComponent, TransformComponent, CompactTransformComponent>().MainThreadOnly();
+    return true;
+}
 
-    auto ghostsView = registry.view<const GhostComponent, TransformComponent>();
-    ghostsView.each([](const auto entity, const GhostComponent& ghostComponent, TransformComponent& transformComponent) {
-        transformComponent.transform = ghostComponent.GetWorldTransform();
-    });
+void PhysicsSimulationSystem::SetTickRate(uint32_t ticksPerSecond)
+{
+    assert(ticksPerSecond > 0);
+    m_TickRate = ticksPerSecond;
+    m_FixedTimeStep = 1.0f / static_cast<float>(ticksPerSecond);
+}
+
+float PhysicsSimulationSystem::GetInterpolationAlpha() const
+{
+    return glm::clamp(m_Accumulator / m_FixedTimeStep, 0.0f, 1.0f);
+}
+
+void PhysicsSimulationSystem::Tick(uint32_t ticks)
+{
+    if (ticks > 1)
+    {
+        CaptureAppliedForces();
+    }
+
+    for (uint32_t tick = 0; tick < ticks; tick++)
+    {
+        if (tick > 0)
+        {
+            RestoreAppliedForces();
+        }
+
+        // With no substeps, Bullet runs exactly one step of the given length and writes the result to the
+        // motion states of the active bodies.
+        m_pWorld->stepSimulation(m_FixedTimeStep, 0, m_FixedTimeStep);
+    }
+
+    m_AppliedForces.clear();
+}
+
+void PhysicsSimulationSystem::CaptureAppliedForces()
+{
+    // The forces Bullet accumulates have already been multiplied by the body's linear and angular factors,
+    // which applyCentralForce() and applyTorque() will apply again, so they need to be removed first.
+    auto removeFactor = [](const btVector3& value, const btVector3& factor) -> glm::vec3 {
+        return glm::vec3(
+            factor.x() != 0.0f ? value.x() / factor.x() : 0.0f,
+            factor.y() != 0.0f ? value.y() / factor.y() : 0.0f,
+            factor.z() != 0.0f ? value.z() / factor.z() : 0.0f);
+    };
+
+    btAlignedObjectArray<btRigidBody*>& rigidBodies = m_pWorld->getNonStaticRigidBodies();
+    const int numRigidBodies = rigidBodies.size();
+    for (int i = 0; i < numRigidBodies; i++)
+    {
+        btRigidBody* pRigidBody = rigidBodies[i];
+        const btVector3& totalForce = pRigidBody->getTotalForce();
+        const btVector3& totalTorque = pRigidBody->getTotalTorque();
+        if (pRigidBody->isActive() && (!totalForce.fuzzyZero() || !totalTorque.fuzzyZero()))
+        {
+            m_AppliedForces.push_back({ pRigidBody, removeFactor(totalForce, pRigidBody->getLinearFactor()), removeFactor(totalTorque, pRigidBody->getAngularFactor()) });
+        }
+    }
+}
+
+void PhysicsSimulationSystem::RestoreAppliedForces()
+{
+    for (const AppliedForce& appliedForce : m_AppliedForces)
+    {
+        appliedForce.pRigidBody->applyCentralForce(btVector3(appliedForce.force.x, appliedForce.force.y, appliedForce.force.z));
+        appliedForce.pRigidBody->applyTorque(btVector3(appliedForce.torque.x, appliedForce.torque.y, appliedForce.torque.z));
+    }
+}
+
+void PhysicsSimulationSystem::UpdateInterpolatedMotionStates(bool ticked)
+{
+    if (ticked)
+    {
+        // A new tick means the set of moving bodies is rebuilt from what Bullet reported.
+        // Bodies which were moving but didn't move during this tick have settled.
+        for (MotionState* pMotionState : m_InterpolatedMotionStates)
+        {
+            pMotionState->SetInterpolated(false);
+            if (!pMotionState->IsMoved())
+            {
+                m_SettledMotionStates.push_back(pMotionState);
+            }
+        }
+        m_InterpolatedMotionStates.clear();
+        m_InterpolationDataDirty = true;
+    }
+
+    if (!m_MovedMotionStates.empty())
+    {
+        for (MotionState* pMotionState : m_MovedMotionStates)
+        {
+            pMotionState->ClearMoved();
+            if (!pMotionState->IsInterpolated())
+            {
+                pMotionState->SetInterpolated(true);
+                m_InterpolatedMotionStates.push_back(pMotionState);
+            }
+        }
+        m_MovedMotionStates.clear();
+        m_InterpolationDataDirty = true;
+    }
+
+    if (!m_InterpolationDataDirty)
+    {
+        return;
+    }
+
+    const size_t count = m_InterpolatedMotionStates.size();
+    InterpolationData& data = m_InterpolationData;
+    data.entities.resize(count);
+    data.previousPositions.resize(count);
+    data.currentPositions.resize(count);
+    data.previousRotations.resize(count);
+    data.currentRotations.resize(count);
+    data.positions.resize(count);
+    data.rotations.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const MotionState* pMotionState = m_InterpolatedMotionStates[i];
+        data.entities[i] = pMotionState->GetEntity();
+        data.previousPositions[i] = pMotionState->GetPreviousPosition();
+        data.currentPositions[i] = pMotionState->GetCurrentPosition();
+        data.previousRotations[i] = pMotionState->GetPreviousRotation();
+        data.currentRotations[i] = pMotionState->GetCurrentRotation();
+    }
+
+    m_InterpolationDataDirty = false;
+}
+
+void PhysicsSimulationSystem::InterpolateTransforms()
+{
+    InterpolationData& data = m_InterpolationData;
+    const size_t count = data.entities.size();
+    const float alpha = GetInterpolationAlpha();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data.positions[i] = glm::mix(data.previousPositions[i], data.currentPositions[i], alpha);
+        data.rotations[i] = glm::slerp(data.previousRotations[i], data.currentRotations[i], alpha);
+    }
+
+    // Transforms are written through patch(), so on_update<TransformComponent>() observers only see the bodies which moved.
+    // Entities using compact transforms get the position and rotation as they are, without building a matrix.
+    entt::registry& registry = m_pScene->GetRegistry();
+    auto& transformStorage = registry.storage<TransformComponent>();
+    auto& compactTransformStorage = registry.storage<CompactTransformComponent>();
+    auto writeTransform = [&transformStorage, &compactTransformStorage](EntityHandle entity, const glm::vec3& position, const glm::quat& rotation) {
+        if (transformStorage.contains(entity))
+        {
+            transformStorage.patch(entity, [&position, &rotation](TransformComponent& transformComponent) {
+                transformComponent.transform = glm::mat4_cast(rotation);
+                transformComponent.transform[3] = glm::vec4(position, 1.0f);
+            });
+        }
+        else if (compactTransformStorage.contains(entity))
+        {
+            compactTransformStorage.patch(entity, [&position, &rotation](CompactTransformComponent& transformComponent) {
+                transformComponent.position = position;
+                transformComponent.rotation = rotation;
+            });
+        }
+    };
+
+    for (size_t i = 0; i < count; i++)
+    {
+        writeTransform(data.entities[i], data.positions[i], data.rotations[i]);
+    }
+
+    for (const MotionState* pMotionState : m_SettledMotionStates)
+    {
+        writeTransform(pMotionState->GetEntity(), pMotionState->GetCurrentPosition(), pMotionState->GetCurrentRotation());
+    }
+    m_SettledMotionStates.clear();
+}
+
+void PhysicsSimulationSystem::SyncGhostTransforms()
+{
+    // Ghosts are never moved by the simulation itself, so only the ones moved explicitly are in the list.
+    entt::registry& registry = m_pScene->GetRegistry();
+    auto& transformStorage = registry.storage<TransformComponent>();
+    auto& compactTransformStorage = registry.storage<CompactTransformComponent>();
+    for (const EntityHandle entity : m_MovedGhosts)
+    {
+        GhostComponent& ghostComponent = registry.get<GhostComponent>(entity);
+        if (!ghostComponent.IsTransformDirty())
+        {
+            continue;
+        }
+
+        const glm::mat4 transform = ghostComponent.GetWorldTransform();
+        if (transformStorage.contains(entity))
+        {
+            transformStorage.patch(entity, [&transform](TransformComponent& transformComponent) {
+                transformComponent.transform = transform;
+            });
+        }
+        else if (compactTransformStorage.contains(entity))
+        {
+            // Ghost transforms have no scale, so compact transforms keep theirs.
+            compactTransformStorage.patch(entity, [&transform](CompactTransformComponent& transformComponent) {
+                transformComponent.position = glm::vec3(transform[3]);
+                transformComponent.rotation = glm::quat_cast(glm::mat3(transform));
+            });
+        }
+        ghostComponent.ClearTransformDirty();
+    }
+    m_MovedGhosts.clear();
+}
+
+void PhysicsSimulationSystem::AddRigidBody(EntityHandle entity, RigidBodyComponent& rigidBodyComponent)
+{
+    btRigidBody* pRigidBody = rigidBodyComponent.GetBulletRigidBody();
+    pRigidBody->setUserIndex(static_cast<int>(entt::to_integral(entity)));
+    rigidBodyComponent.GetMotionState()->Bind(entity, &m_MovedMotionStates);
+    m_pWorld->addRigidBody(pRigidBody);
+}
+
+void PhysicsSimulationSystem::AddGhostObject(EntityHandle entity, GhostComponent& ghostComponent)
+{
+    btGhostObject* pGhostObject = ghostComponent.GetBulletGhostObject();
+    pGhostObject->setUserIndex(static_cast<int>(entt::to_integral(entity)));
+    ghostComponent.Bind(entity, &m_MovedGhosts);
+    m_pWorld->addCollisionObject(pGhostObject);
 }
 
 void PhysicsSimulationSystem::OnRigidBodyCreated(entt::registry& registry, entt::entity entity)
@@ -103,7 +458,7 @@ void PhysicsSimulationSystem::OnRigidBodyCreated(entt::registry& registry, entt:
     RigidBodyComponent& rigidBodyComponent = m_pScene->GetRegistry().get<RigidBodyComponent>(entity);
     if (rigidBodyComponent.GetBulletRigidBody())
     {
-        m_pWorld->addRigidBody(rigidBodyComponent.GetBulletRigidBody());
+        AddRigidBody(entity, rigidBodyComponent);
     }
     else
     {
@@ -117,6 +472,16 @@ void PhysicsSimulationSystem::OnRigidBodyDestroyed(entt::registry& registry, ent
     if (rigidBodyComponent.GetBulletRigidBody())
     {
         m_pWorld->removeRigidBody(rigidBodyComponent.GetBulletRigidBody());
+
+        MotionState* pMotionState = rigidBodyComponent.GetMotionState();
+        if (pMotionState->IsInterpolated())
+        {
+            m_InterpolatedMotionStates.erase(std::remove(m_InterpolatedMotionStates.begin(), m_InterpolatedMotionStates.end(), pMotionState), m_InterpolatedMotionStates.end());
+            pMotionState->SetInterpolated(false);
+            m_InterpolationDataDirty = true;
+        }
+        m_SettledMotionStates.erase(std::remove(m_SettledMotionStates.begin(), m_SettledMotionStates.end(), pMotionState), m_SettledMotionStates.end());
+        pMotionState->Unbind();
     }
 }
 
@@ -125,7 +490,7 @@ void PhysicsSimulationSystem::OnGhostComponentCreated(entt::registry& registry,
     GhostComponent& ghostComponent = m_pScene->GetRegistry().get<GhostComponent>(entity);
     if (ghostComponent.GetBulletGhostObject())
     {
-        m_pWorld->addCollisionObject(ghostComponent.GetBulletGhostObject());
+        AddGhostObject(entity, ghostComponent);
     }
     else
     {
@@ -139,9 +504,28 @@ void PhysicsSimulationSystem::OnGhostComponentDestroyed(entt::registry& registry
     if (ghostComponent.GetBulletGhostObject())
     {
         m_pWorld->removeCollisionObject(ghostComponent.GetBulletGhostObject());
+        ghostComponent.Unbind();
     }
 }
 
+void PhysicsSimulationSystem::OnLandscapeComponentDestroyed(entt::registry& registry, entt::entity entity)
+{
+    m_LandscapeCollisions.erase(entity);
+}
+
+void PhysicsSimulationSystem::UpdateLandscapeCollisions()
+{
+    auto landscapesView = m_pScene->GetRegistry().view<const LandscapeComponent>();
+    landscapesView.each([this](const auto entity, const LandscapeComponent& landscapeComponent) {
+        auto it = m_LandscapeCollisions.find(entity);
+        if (it == m_LandscapeCollisions.end())
+        {
+            it = m_LandscapeCollisions.emplace(entity, std::make_unique<LandscapeCollision>(m_pWorld.get(), entity)).first;
+        }
+        it->second->Update(landscapeComponent);
+    });
+}
+
 std::optional<PhysicsSimulationSystem::RaycastResult> PhysicsSimulationSystem::Raycast(const glm::vec3& from, const glm::vec3& to)
 {
     const btVector3 btFrom(from.x, from.y, from.z);
@@ -155,7 +539,8 @@ std::optional<PhysicsSimulationSystem::RaycastResult> PhysicsSimulationSystem::R
         RaycastResult result;
         result.position = glm::vec3(rayCallback.m_hitPointWorld.x(), rayCallback.m_hitPointWorld.y(), rayCallback.m_hitPointWorld.z());
         result.fraction = rayCallback.m_closestHitFraction;
-        result.pEntity = CollisionObjectToEntity(rayCallback.m_collisionObject);
+        result.entity = CollisionObjectToHandle(rayCallback.m_collisionObject);
+        result.pEntity = m_pScene->GetEntity(result.entity);
         return result;
     }
 
@@ -183,7 +568,8 @@ std::vector<PhysicsSimulationSystem::RaycastResult> PhysicsSimulationSystem::Ray
             RaycastResult result;
             result.position = glm::vec3(hitPointWorld.x(), hitPointWorld.y(), hitPointWorld.z());
             result.fraction = hitFraction;
-            result.pEntity = CollisionObjectToEntity(rayCallback.m_collisionObjects[i]);
+            result.entity = CollisionObjectToHandle(rayCallback.m_collisionObjects[i]);
+            result.pEntity = m_pScene->GetEntity(result.entity);
             results.push_back(std::move(result));
         }
     }
@@ -191,6 +577,230 @@ std::vector<PhysicsSimulationSystem::RaycastResult> PhysicsSimulationSystem::Ray
     return results;
 }
 
+void PhysicsSimulationSystem::RaycastBatch(std::span<const RayQuery> queries, std::span<QueryHit> hits)
+{
+    assert(hits.size() >= queries.size());
+    const btCollisionWorld* pWorld = m_pWorld.get();
+    GetTaskScheduler()->ParallelFor(0, queries.size(), sQueryGrainSize, [pWorld, queries, hits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            const RayQuery& query = queries[i];
+            const btVector3 from(query.from.x, query.from.y, query.from.z);
+            const btVector3 to(query.to.x, query.to.y, query.to.z);
+
+            ClosestRayCallback callback(from, to, EntityToUserIndex(query.ignoredEntity));
+            pWorld->rayTest(from, to, callback);
+
+            hits[i] = QueryHit();
+            if (callback.hasHit())
+            {
+                WriteHit(callback.m_collisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction, hits[i]);
+            }
+        }
+    });
+}
+
+void PhysicsSimulationSystem::SphereCastBatch(std::span<const SphereCastQuery> queries, std::span<QueryHit> hits)
+{
+    assert(hits.size() >= queries.size());
+    const btCollisionWorld* pWorld = m_pWorld.get();
+    GetTaskScheduler()->ParallelFor(0, queries.size(), sQueryGrainSize, [pWorld, queries, hits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            const SphereCastQuery& query = queries[i];
+            const btVector3 from(query.from.x, query.from.y, query.from.z);
+            const btVector3 to(query.to.x, query.to.y, query.to.z);
+            const btTransform fromTransform(btQuaternion::getIdentity(), from);
+            const btTransform toTransform(btQuaternion::getIdentity(), to);
+
+            // The sphere lives on the stack, so casting doesn't allocate.
+            btSphereShape sphereShape(query.radius);
+            ClosestConvexCallback callback(from, to, EntityToUserIndex(query.ignoredEntity));
+            pWorld->convexSweepTest(&sphereShape, fromTransform, toTransform, callback);
+
+            hits[i] = QueryHit();
+            if (callback.hasHit())
+            {
+                WriteHit(callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction, hits[i]);
+            }
+        }
+    });
+}
+
+void PhysicsSimulationSystem::ConvexSweepBatch(std::span<const ConvexSweepQuery> queries, std::span<QueryHit> hits)
+{
+    assert(hits.size() >= queries.size());
+    const btCollisionWorld* pWorld = m_pWorld.get();
+    std::atomic<size_t> invalidQueries{ 0 };
+    GetTaskScheduler()->ParallelFor(0, queries.size(), sQueryGrainSize, [pWorld, queries, hits, &invalidQueries](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            const ConvexSweepQuery& query = queries[i];
+            hits[i] = QueryHit();
+
+            const btCollisionShape* pShape = query.pShape ? query.pShape->GetBulletShape() : nullptr;
+            if (pShape == nullptr || !pShape->isConvex())
+            {
+                hits[i].status = QueryStatus::InvalidShape;
+                invalidQueries.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            btTransform fromTransform;
+            btTransform toTransform;
+            fromTransform.setFromOpenGLMatrix(glm::value_ptr(query.from));
+            toTransform.setFromOpenGLMatrix(glm::value_ptr(query.to));
+
+            ClosestConvexCallback callback(fromTransform.getOrigin(), toTransform.getOrigin(), EntityToUserIndex(query.ignoredEntity));
+            pWorld->convexSweepTest(static_cast<const btConvexShape*>(pShape), fromTransform, toTransform, callback);
+
+            if (callback.hasHit())
+            {
+                WriteHit(callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction, hits[i]);
+            }
+        }
+    });
+
+    // Failures are counted rather than logged by the task scheduler's threads, and reported once from the calling thread.
+    if (invalidQueries > 0)
+    {
+        Log::Warning() << "ConvexSweepBatch: " << invalidQueries.load() << " of " << queries.size() << " queries don't have a convex shape.";
+    }
+}
+
+void PhysicsSimulationSystem::CaptureSnapshot(PhysicsSnapshot& snapshot)
+{
+    ResetCollisionState();
+
+    const btAlignedObjectArray<btRigidBody*>& rigidBodies = m_pWorld->getNonStaticRigidBodies();
+    const int numRigidBodies = rigidBodies.size();
+    std::vector<PhysicsBodyState>& bodies = snapshot.GetBodies();
+    bodies.resize(static_cast<size_t>(numRigidBodies));
+
+    size_t count = 0;
+    for (int i = 0; i < numRigidBodies; i++)
+    {
+        const btRigidBody* pRigidBody = rigidBodies[i];
+        if (pRigidBody->getUserIndex() == -1)
+        {
+            continue;
+        }
+
+        const btTransform& worldTransform = pRigidBody->getWorldTransform();
+        const btVector3& origin = worldTransform.getOrigin();
+        const btQuaternion rotation = worldTransform.getRotation();
+        const btVector3& linearVelocity = pRigidBody->getLinearVelocity();
+        const btVector3& angularVelocity = pRigidBody->getAngularVelocity();
+
+        PhysicsBodyState& state = bodies[count++];
+        state.entity = static_cast<EntityHandle>(pRigidBody->getUserIndex());
+        state.activationState = pRigidBody->getActivationState();
+        state.deactivationTime = pRigidBody->getDeactivationTime();
+        state.position = glm::vec3(origin.x(), origin.y(), origin.z());
+        state.rotation = glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z());
+        state.linearVelocity = glm::vec3(linearVelocity.x(), linearVelocity.y(), linearVelocity.z());
+        state.angularVelocity = glm::vec3(angularVelocity.x(), angularVelocity.y(), angularVelocity.z());
+    }
+
+    bodies.resize(count);
+    snapshot.GetContactPairs() = m_ContactEvents.GetTouchingPairs();
+    snapshot.SetAccumulator(m_Accumulator);
+
+    if (m_Mode == Mode::SingleThreaded)
+    {
+        snapshot.SetSolverSeed(static_cast<const btSequentialImpulseConstraintSolver*>(m_pSolver.get())->getRandSeed());
+    }
+}
+
+void PhysicsSimulationSystem::RestoreSnapshot(const PhysicsSnapshot& snapshot)
+{
+    entt::registry& registry = m_pScene->GetRegistry();
+    auto& rigidBodyStorage = registry.storage<RigidBodyComponent>();
+
+    for (const PhysicsBodyState& state : snapshot.GetBodies())
+    {
+        if (!rigidBodyStorage.contains(state.entity))
+        {
+            continue;
+        }
+
+        RigidBodyComponent& rigidBodyComponent = rigidBodyStorage.get(state.entity);
+        btRigidBody* pRigidBody = rigidBodyComponent.GetBulletRigidBody();
+        if (pRigidBody == nullptr || !pRigidBody->isInWorld())
+        {
+            continue;
+        }
+
+        const btTransform worldTransform(
+            btQuaternion(state.rotation.x, state.rotation.y, state.rotation.z, state.rotation.w),
+            btVector3(state.position.x, state.position.y, state.position.z));
+        const btVector3 linearVelocity(state.linearVelocity.x, state.linearVelocity.y, state.linearVelocity.z);
+        const btVector3 angularVelocity(state.angularVelocity.x, state.angularVelocity.y, state.angularVelocity.z);
+
+        pRigidBody->setWorldTransform(worldTransform);
+        pRigidBody->setInterpolationWorldTransform(worldTransform);
+        pRigidBody->setLinearVelocity(linearVelocity);
+        pRigidBody->setAngularVelocity(angularVelocity);
+        pRigidBody->setInterpolationLinearVelocity(linearVelocity);
+        pRigidBody->setInterpolationAngularVelocity(angularVelocity);
+        pRigidBody->clearForces();
+        pRigidBody->forceActivationState(state.activationState);
+        pRigidBody->setDeactivationTime(state.deactivationTime);
+        pRigidBody->updateInertiaTensor();
+        rigidBodyComponent.GetMotionState()->Teleport(worldTransform);
+    }
+
+    ResetCollisionState();
+    if (m_Mode == Mode::SingleThreaded)
+    {
+        static_cast<btSequentialImpulseConstraintSolver*>(m_pSolver.get())->setRandSeed(static_cast<unsigned long>(snapshot.GetSolverSeed()));
+    }
+
+    m_ContactEvents.RestoreTouchingPairs(snapshot.GetContactPairs());
+    m_Accumulator = snapshot.GetAccumulator();
+}
+
+// The collision state carried from one tick to the next is the broadphase's trees and pairs, and the contact manifolds
+// which warm start the solver. All of it depends on the bodies' history rather than just their current state, so it is
+// thrown away and rebuilt from the current state alone: the proxies are recreated in the world's order, which gives the
+// same trees, pair order and proxy ids every time, and the manifolds are recreated from scratch by the next tick.
+void PhysicsSimulationSystem::ResetCollisionState()
+{
+    btCollisionObjectArray& collisionObjects = m_pWorld->getCollisionObjectArray();
+    const int numCollisionObjects = collisionObjects.size();
+
+    struct ProxyFilter
+    {
+        int group;
+        int mask;
+    };
+    std::vector<ProxyFilter> filters(static_cast<size_t>(numCollisionObjects));
+    for (int i = 0; i < numCollisionObjects; i++)
+    {
+        btCollisionObject* pCollisionObject = collisionObjects[i];
+        btBroadphaseProxy* pProxy = pCollisionObject->getBroadphaseHandle();
+        filters[i] = { pProxy->m_collisionFilterGroup, pProxy->m_collisionFilterMask };
+
+        // Destroying a proxy removes its pairs, along with their collision algorithms and manifolds.
+        m_pBroadphase->destroyProxy(pProxy, m_pDispatcher.get());
+        pCollisionObject->setBroadphaseHandle(nullptr);
+    }
+
+    // With no proxies left, this also resets the broadphase's counters and proxy ids.
+    m_pBroadphase->resetPool(m_pDispatcher.get());
+
+    for (int i = 0; i < numCollisionObjects; i++)
+    {
+        btCollisionObject* pCollisionObject = collisionObjects[i];
+        btVector3 aabbMin;
+        btVector3 aabbMax;
+        pCollisionObject->getCollisionShape()->getAabb(pCollisionObject->getWorldTransform(), aabbMin, aabbMax);
+        const int shapeType = pCollisionObject->getCollisionShape()->getShapeType();
+        pCollisionObject->setBroadphaseHandle(m_pBroadphase->createProxy(aabbMin, aabbMax, shapeType, pCollisionObject, filters[i].group, filters[i].mask, m_pDispatcher.get()));
+        m_pWorld->updateSingleAabb(pCollisionObject);
+    }
+}
+
 void PhysicsSimulationSystem::SetCollisionBetween(EntitySharedPtr pEntity1, EntitySharedPtr pEntity2, bool enable)
 {
 #if defined(TARGET_PLATFORM_WEB)
@@ -220,23 +830,4 @@ void PhysicsSimulationSystem::SetCollisionBetween(EntitySharedPtr pEntity1, Enti
 #endif
 }
 
-EntitySharedPtr PhysicsSimulationSystem::CollisionObjectToEntity(const btCollisionObject* pCollisionObject)
-{
-    // Try to cast to rigid body first
-    const btRigidBody* pRigidBody = btRigidBody::upcast(pCollisionObject);
-    if (pRigidBody)
-    {
-        return RigidBodyComponent::GetEntityFromRigidBody(pRigidBody);
-    }
-
-    // If not a rigid body, try ghost object
-    const btGhostObject* pGhostObject = btGhostObject::upcast(pCollisionObject);
-    if (pGhostObject)
-    {
-        return GhostComponent::GetEntityFromGhostObject(pGhostObject);
-    }
-
-    return nullptr;
-}
-
 } // namespace WingsOfSteel
@@ -2,35 +2,54 @@
 
 #include <memory>
 #include <optional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 #include "scene/systems/system.hpp"
 
+#include "physics/contact_events.hpp"
+#include "physics/landscape_collision.hpp"
+#include "physics/physics_query.hpp"
+#include "physics/physics_snapshot.hpp"
 #include "physics/physics_visualization.hpp"
 
 class btCollisionDispatcher;
 class btCollisionObject;
+class btConstraintSolver;
+class btRigidBody;
 class btDefaultCollisionConfiguration;
 struct btDbvtBroadphase;
-class btSequentialImpulseConstraintSolver;
 class btDiscreteDynamicsWorld;
 
 namespace WingsOfSteel
 {
 
 DECLARE_SMART_PTR(Entity);
+class GhostComponent;
+class MotionState;
+class RigidBodyComponent;
 
 DECLARE_SMART_PTR(PhysicsSimulationSystem);
 class PhysicsSimulationSystem : public System
 {
 public:
-    PhysicsSimulationSystem();
+    enum class Mode
+    {
+        SingleThreaded,
+        Multithreaded // Runs Bullet's parallel world on the engine's task scheduler. Native only.
+    };
+
+    PhysicsSimulationSystem(Mode mode = Mode::SingleThreaded);
     ~PhysicsSimulationSystem();
 
     void Initialize(Scene* pScene) override;
     void Update(float delta) override;
+    bool DeclareAccess(SystemAccess& access) const override;
 
     void OnRigidBodyCreated(entt::registry& registry, entt::entity entity);
     void OnRigidBodyDestroyed(entt::registry& registry, entt::entity entity);
@@ -38,29 +57,79 @@ public:
     void OnGhostComponentCreated(entt::registry& registry, entt::entity entity);
     void OnGhostComponentDestroyed(entt::registry& registry, entt::entity entity);
 
+    void OnLandscapeComponentDestroyed(entt::registry& registry, entt::entity entity);
+
     PhysicsVisualization* GetVisualization() { return m_pPhysicsVisualization.get(); }
+    Mode GetMode() const { return m_Mode; }
+
+    // The simulation advances in fixed ticks. Any time left over is carried to the next update, and the
+    // rendered transforms are interpolated between the last two ticks.
+    void SetTickRate(uint32_t ticksPerSecond);
+    uint32_t GetTickRate() const { return m_TickRate; }
+    // Maximum number of ticks per update. Any time beyond that is dropped, so a frame spike slows down
+    // the simulation instead of making the following frames even slower.
+    void SetMaxTicksPerUpdate(uint32_t maxTicks) { m_MaxTicksPerUpdate = maxTicks; }
+    uint32_t GetMaxTicksPerUpdate() const { return m_MaxTicksPerUpdate; }
+    float GetInterpolationAlpha() const;
 
     struct RaycastResult
     {
-        EntitySharedPtr pEntity;
+        EntitySharedPtr pEntity; // Only set for entities created as Entity objects.
+        EntityHandle entity{ entt::null };
         glm::vec3 position{0.0f};
         float fraction{0.0f}; // Fraction along the raycast's path at which the raycast collided. 
     };
 
     std::optional<RaycastResult> Raycast(const glm::vec3& from, const glm::vec3& to);
     std::vector<RaycastResult> RaycastAll(const glm::vec3& from, const glm::vec3& to);
+
+    // Batched queries, run in parallel on the task scheduler. Results are written to the hit with the same index as
+    // the query, so hits must be at least as large as queries. These must not be called while the simulation is updating.
+    // Queries which can't be run are marked with a failure status in their hit, and reported in a single warning.
+    void RaycastBatch(std::span<const RayQuery> queries, std::span<QueryHit> hits);
+    void SphereCastBatch(std::span<const SphereCastQuery> queries, std::span<QueryHit> hits);
+    void ConvexSweepBatch(std::span<const ConvexSweepQuery> queries, std::span<QueryHit> hits);
     
+    // Contact events generated by the ticks which ran during the last update, gathered after each tick. Each pair of
+    // entities is reported once per change, regardless of how many collision objects or contact points are involved.
+    // End events involving an entity destroyed since the previous update are flagged as such, see ContactEvent.
+    ContactEventView GetContactEvents(ContactEventType type) const { return m_ContactEvents.GetEvents(type); }
+    // Persist events are disabled by default, as they scale with the number of touching pairs rather than with the changes.
+    void SetPersistContactEventsEnabled(bool enabled) { m_ContactEvents.SetPersistEventsEnabled(enabled); }
+
+    // Captures the state of every dynamic and kinematic body, for rollback or replays. Restoring puts those bodies back
+    // exactly where they were, along with the solver's seed and the touching pairs contact events are relative to.
+    // Both capturing and restoring rebuild the broadphase from scratch and discard the cached contacts, so the ticks
+    // following a restore start from the same collision state as the ticks which followed the capture. In single threaded
+    // mode, re-simulating from a snapshot is then bit-identical to the original run, as long as no collision objects have
+    // been added to or removed from the world in between. Multithreaded mode solves islands in whichever order the threads
+    // pick them up, so it is only close to the original run.
+    // Rebuilding the broadphase costs about as much as adding every collision object to the world again.
+    // Bodies whose entities have been destroyed since the capture are skipped, and bodies created since are left untouched.
+    void CaptureSnapshot(PhysicsSnapshot& snapshot);
+    void RestoreSnapshot(const PhysicsSnapshot& snapshot);
+
     // Enable or disable collision between two specific entities
     void SetCollisionBetween(EntitySharedPtr pEntity1, EntitySharedPtr pEntity2, bool enable);
 
 private:
-    EntitySharedPtr CollisionObjectToEntity(const btCollisionObject* pCollisionObject);
+    void AddRigidBody(EntityHandle entity, RigidBodyComponent& rigidBodyComponent);
+    void AddGhostObject(EntityHandle entity, GhostComponent& ghostComponent);
+    void UpdateLandscapeCollisions();
+    void Tick(uint32_t ticks);
+    void CaptureAppliedForces();
+    void RestoreAppliedForces();
+    void UpdateInterpolatedMotionStates(bool ticked);
+    void InterpolateTransforms();
+    void SyncGhostTransforms();
+    void ResetCollisionState();
     
     Scene* m_pScene{ nullptr };
+    Mode m_Mode{ Mode::SingleThreaded };
     std::unique_ptr<btDefaultCollisionConfiguration> m_pCollisionConfiguration;
     std::unique_ptr<btCollisionDispatcher> m_pDispatcher;
     std::unique_ptr<btDbvtBroadphase> m_pBroadphase;
-    std::unique_ptr<btSequentialImpulseConstraintSolver> m_pSolver;
+    std::unique_ptr<btConstraintSolver> m_pSolver;
     std::unique_ptr<btDiscreteDynamicsWorld> m_pWorld;
     PhysicsVisualizationUniquePtr m_pPhysicsVisualization;
 
@@ -74,6 +143,47 @@ private:
 
     std::vector<EntityToAdd> m_EntitiesToAdd;
     std::vector<EntityToAdd> m_GhostEntitiesToAdd;
+
+    std::unordered_map<EntityHandle, LandscapeCollisionUniquePtr> m_LandscapeCollisions;
+
+    uint32_t m_TickRate{ 60 };
+    uint32_t m_MaxTicksPerUpdate{ 3 };
+    float m_FixedTimeStep{ 1.0f / 60.0f };
+    float m_Accumulator{ 0.0f };
+
+    // Bullet clears forces after every call to stepSimulation(), so when several ticks run in a single
+    // update the forces applied during the frame are captured and reapplied before each extra tick.
+    struct AppliedForce
+    {
+        btRigidBody* pRigidBody;
+        glm::vec3 force;
+        glm::vec3 torque;
+    };
+    std::vector<AppliedForce> m_AppliedForces;
+
+    // Motion states which moved since the last update, as reported by Bullet.
+    std::vector<MotionState*> m_MovedMotionStates;
+    // Entities whose ghost was moved since the last update.
+    std::vector<EntityHandle> m_MovedGhosts;
+    // Motion states being interpolated, with their transforms laid out contiguously.
+    std::vector<MotionState*> m_InterpolatedMotionStates;
+    // Motion states which stopped moving during the last tick (usually because their body fell asleep).
+    // Their final transform is written once, as the interpolation never quite reaches it.
+    std::vector<MotionState*> m_SettledMotionStates;
+    struct InterpolationData
+    {
+        std::vector<EntityHandle> entities;
+        std::vector<glm::vec3> previousPositions;
+        std::vector<glm::vec3> currentPositions;
+        std::vector<glm::quat> previousRotations;
+        std::vector<glm::quat> currentRotations;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+    };
+    InterpolationData m_InterpolationData;
+    bool m_InterpolationDataDirty{ false };
+
+    ContactEventStream m_ContactEvents;
 };
 
 } // namespace WingsOfSteel
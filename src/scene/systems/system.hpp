@@ -1,8 +1,11 @@
 #pragma once
 
+#include <string_view>
+
 #include <entt/entt.hpp>
 
 #include "core/smart_ptr.hpp"
+#include "scene/systems/system_access.hpp"
 
 namespace WingsOfSteel
 {
@@ -18,6 +21,17 @@ public:
 
     virtual void Initialize(Scene* pScene) = 0;
     virtual void Update(float delta) = 0;
+
+    // Systems which declare the components they access can be updated in parallel with any systems they don't
+    // conflict with. Returns false if the system doesn't declare its access, in which case it is updated on its own,
+    // on the main thread.
+    virtual bool DeclareAccess(SystemAccess& access) const { return false; }
+
+    std::string_view GetName() const { return m_Name; }
+
+private:
+    friend class Scene;
+    std::string_view m_Name;
 };
 
-} // namespace WingsOfSteel
\ No newline at end of file
+} // namespace WingsOfSteel
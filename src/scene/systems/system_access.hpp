@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace WingsOfSteel
+{
+
+// Components a system reads and writes during its update. The scheduler uses these to decide which
+// systems can be updated at the same time: two systems conflict if either writes a component the other accesses.
+// Systems updated in parallel must not create or destroy entities, add or remove components, or use anything
+// else which isn't thread safe (such as the GPU or ImGui); those should be declared as main thread only.
+class SystemAccess
+{
+public:
+    template <typename... Ts>
+    SystemAccess& Read()
+    {
+        (Add<std::remove_const_t<Ts>>(m_Reads), ...);
+        return *this;
+    }
+
+    template <typename... Ts>
+    SystemAccess& Write()
+    {
+        (Add<std::remove_const_t<Ts>>(m_Writes), ...);
+        return *this;
+    }
+
+    SystemAccess& MainThreadOnly()
+    {
+        m_MainThreadOnly = true;
+        return *this;
+    }
+
+    bool IsMainThreadOnly() const { return m_MainThreadOnly; }
+
+    bool ConflictsWith(const SystemAccess& other) const
+    {
+        auto intersects = [](const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b) {
+            return std::find_first_of(a.begin(), a.end(), b.begin(), b.end()) != a.end();
+        };
+
+        return intersects(m_Writes, other.m_Writes) || intersects(m_Writes, other.m_Reads) || intersects(m_Reads, other.m_Writes);
+    }
+
+    // Creating a component's storage modifies the registry, so this is done before any system runs in parallel.
+    void AssureStorages(entt::registry& registry) const
+    {
+        for (const auto& assureStorage : m_AssureStorageFunctions)
+        {
+            assureStorage(registry);
+        }
+    }
+
+private:
+    template <typename T>
+    void Add(std::vector<entt::id_type>& ids)
+    {
+        ids.push_back(entt::type_hash<T>::value());
+        m_AssureStorageFunctions.push_back([](entt::registry& registry) { registry.storage<T>(); });
+    }
+
+    std::vector<entt::id_type> m_Reads;
+    std::vector<entt::id_type> m_Writes;
+    std::vector<std::function<void(entt::registry&)>> m_AssureStorageFunctions;
+    bool m_MainThreadOnly{ false };
+};
+
+} // namespace WingsOfSteel
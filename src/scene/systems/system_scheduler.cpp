@@ -0,0 +1,105 @@
+#include "scene/systems/system_scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "core/profiler.hpp"
+#include "core/task_scheduler.hpp"
+#include "pandora.hpp"
+#include "scene/systems/system.hpp"
+#include "scene/systems/system_access.hpp"
+
+namespace WingsOfSteel
+{
+
+void SystemScheduler::Build(entt::registry& registry, const std::vector<SystemUniquePtr>& systems)
+{
+    const size_t count = systems.size();
+    m_Systems.resize(count);
+    m_Levels.clear();
+    m_Timings.assign(count, SystemTiming());
+
+    std::vector<SystemAccess> accesses(count);
+    std::vector<bool> declared(count);
+    std::vector<uint32_t> levels(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Systems[i] = systems[i].get();
+        declared[i] = m_Systems[i]->DeclareAccess(accesses[i]);
+        if (declared[i])
+        {
+            accesses[i].AssureStorages(registry);
+        }
+
+        // Systems which don't declare their access conflict with every other system.
+        uint32_t level = 0;
+        for (size_t j = 0; j < i; j++)
+        {
+            if (!declared[i] || !declared[j] || accesses[i].ConflictsWith(accesses[j]))
+            {
+                level = std::max(level, levels[j] + 1);
+            }
+        }
+        levels[i] = level;
+
+        if (level >= m_Levels.size())
+        {
+            m_Levels.resize(level + 1);
+        }
+
+        const bool mainThread = !declared[i] || accesses[i].IsMainThreadOnly();
+        if (mainThread)
+        {
+            m_Levels[level].mainThreadSystems.push_back(i);
+        }
+        else
+        {
+            m_Levels[level].parallelSystems.push_back(i);
+        }
+
+        m_Timings[i].name = m_Systems[i]->GetName();
+        m_Timings[i].level = level;
+        m_Timings[i].mainThread = mainThread;
+    }
+}
+
+void SystemScheduler::Update(float delta)
+{
+    for (const Level& level : m_Levels)
+    {
+        const std::vector<size_t>& parallelSystems = level.parallelSystems;
+        if (m_ParallelUpdatesEnabled && parallelSystems.size() > 1)
+        {
+            GetTaskScheduler()->ParallelFor(0, parallelSystems.size(), 1, [this, &parallelSystems, delta](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    UpdateSystem(parallelSystems[i], delta);
+                }
+            });
+        }
+        else
+        {
+            for (size_t index : parallelSystems)
+            {
+                UpdateSystem(index, delta);
+            }
+        }
+
+        for (size_t index : level.mainThreadSystems)
+        {
+            UpdateSystem(index, delta);
+        }
+    }
+}
+
+void SystemScheduler::UpdateSystem(size_t index, float delta)
+{
+    PROFILE_SCOPE(m_Systems[index]->GetName());
+    const auto start = std::chrono::steady_clock::now();
+    m_Systems[index]->Update(delta);
+    const std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - start;
+    m_Timings[index].milliseconds = duration.count();
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "core/smart_ptr.hpp"
+
+namespace WingsOfSteel
+{
+
+DECLARE_SMART_PTR(System);
+
+struct SystemTiming
+{
+    std::string_view name;
+    uint32_t level{ 0 }; // Systems on the same level are updated in parallel.
+    bool mainThread{ false };
+    float milliseconds{ 0.0f };
+};
+
+//////////////////////////////////////////////////////////////////////////
+// SystemScheduler
+// Splits the scene's systems into levels, based on the component access
+// they declare. Each system is placed on the level after the last earlier
+// system it conflicts with, so conflicting systems always run in the order
+// they were added in, and the systems sharing a level can run in any order
+// without changing the results. Each level is updated in parallel on the
+// task scheduler, followed by its main thread only systems.
+//////////////////////////////////////////////////////////////////////////
+
+class SystemScheduler
+{
+public:
+    SystemScheduler() = default;
+    ~SystemScheduler() = default;
+
+    void Build(entt::registry& registry, const std::vector<SystemUniquePtr>& systems);
+    void Update(float delta);
+
+    // Timings from the last update, in the same order as the systems.
+    const std::vector<SystemTiming>& GetTimings() const { return m_Timings; }
+
+    void SetParallelUpdatesEnabled(bool enabled) { m_ParallelUpdatesEnabled = enabled; }
+    bool GetParallelUpdatesEnabled() const { return m_ParallelUpdatesEnabled; }
+
+private:
+    void UpdateSystem(size_t index, float delta);
+
+    struct Level
+    {
+        std::vector<size_t> parallelSystems;
+        std::vector<size_t> mainThreadSystems;
+    };
+
+    std::vector<System*> m_Systems;
+    std::vector<Level> m_Levels;
+    std::vector<SystemTiming> m_Timings;
+    bool m_ParallelUpdatesEnabled{ true };
+};
+
+} // namespace WingsOfSteel
@@ -0,0 +1,379 @@
+#include "scene/systems/transform_hierarchy_system.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "core/log.hpp"
+#include "scene/components/compact_transform_component.hpp"
+#include "scene/components/hierarchy_component.hpp"
+#include "scene/components/model_component.hpp"
+#include "scene/components/transform_component.hpp"
+#include "scene/scene.hpp"
+
+namespace WingsOfSteel
+{
+
+// Deeper hierarchies are assumed to be cycles.
+static constexpr uint32_t sMaxHierarchyDepth = 256;
+
+TransformHierarchySystem::~TransformHierarchySystem()
+{
+    if (m_pScene)
+    {
+        entt::registry& registry = m_pScene->GetRegistry();
+        registry.on_update<TransformComponent>().disconnect<&TransformHierarchySystem::OnTransformUpdated>(this);
+        registry.on_destroy<TransformComponent>().disconnect<&TransformHierarchySystem::OnTransformDestroyed>(this);
+        registry.on_update<CompactTransformComponent>().disconnect<&TransformHierarchySystem::OnTransformUpdated>(this);
+        registry.on_destroy<CompactTransformComponent>().disconnect<&TransformHierarchySystem::OnTransformDestroyed>(this);
+        registry.on_update<HierarchyComponent>().disconnect<&TransformHierarchySystem::OnHierarchyUpdated>(this);
+        registry.on_construct<HierarchyComponent>().disconnect<&TransformHierarchySystem::OnHierarchyChanged>(this);
+        registry.on_destroy<HierarchyComponent>().disconnect<&TransformHierarchySystem::OnHierarchyChanged>(this);
+    }
+}
+
+void TransformHierarchySystem::Initialize(Scene* pScene)
+{
+    m_pScene = pScene;
+    entt::registry& registry = m_pScene->GetRegistry();
+    registry.on_update<TransformComponent>().connect<&TransformHierarchySystem::OnTransformUpdated>(this);
+    registry.on_destroy<TransformComponent>().connect<&TransformHierarchySystem::OnTransformDestroyed>(this);
+    registry.on_update<CompactTransformComponent>().connect<&TransformHierarchySystem::OnTransformUpdated>(this);
+    registry.on_destroy<CompactTransformComponent>().connect<&TransformHierarchySystem::OnTransformDestroyed>(this);
+    registry.on_update<HierarchyComponent>().connect<&TransformHierarchySystem::OnHierarchyUpdated>(this);
+    registry.on_construct<HierarchyComponent>().connect<&TransformHierarchySystem::OnHierarchyChanged>(this);
+    registry.on_destroy<HierarchyComponent>().connect<&TransformHierarchySystem::OnHierarchyChanged>(this);
+}
+
+bool TransformHierarchySystem::DeclareAccess(SystemAccess& access) const
+{
+    // Transform updates are signalled to observers.
+    access.Read<HierarchyComponent, ModelComponent>().Write<TransformComponent, CompactTransformComponent>().MainThreadOnly();
+    return true;
+}
+
+void TransformHierarchySystem::SetLocalTransform(EntityHandle entity, const glm::mat4& localTransform)
+{
+    m_pScene->GetRegistry().patch<HierarchyComponent>(entity, [&localTransform](HierarchyComponent& hierarchyComponent) {
+        hierarchyComponent.localTransform = localTransform;
+    });
+}
+
+void TransformHierarchySystem::Update(float delta)
+{
+    if (m_NodesDirty)
+    {
+        RebuildNodes();
+    }
+
+    const uint32_t nodeCount = static_cast<uint32_t>(m_Nodes.entities.size());
+    if (m_AttachmentsPending)
+    {
+        m_AttachmentsPending = false;
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            if (m_Nodes.attachmentPending[i])
+            {
+                if (ResolveAttachment(i))
+                {
+                    MarkDirty(i);
+                }
+                else
+                {
+                    m_AttachmentsPending = true;
+                }
+            }
+        }
+    }
+
+    if (m_FirstDirtyNode == sInvalidIndex)
+    {
+        return;
+    }
+
+    // Nodes are in depth order, so every parent comes before its children: a single pass starting at the first dirty
+    // node inherits the parents' dirty flags and recomputes their world transforms, without touching the registry.
+    for (uint32_t i = m_FirstDirtyNode; i < nodeCount; i++)
+    {
+        const uint32_t parent = m_Nodes.parents[i];
+        if (parent != sInvalidIndex)
+        {
+            m_Nodes.dirty[i] |= m_Nodes.dirty[parent];
+            if (m_Nodes.dirty[i])
+            {
+                m_Nodes.worldTransforms[i] = m_Nodes.worldTransforms[parent] * m_Nodes.attachmentTransforms[i] * m_Nodes.localTransforms[i];
+            }
+        }
+    }
+
+    // The results are written back separately, as patching the components signals their observers.
+    auto& transformStorage = m_pScene->GetRegistry().storage<TransformComponent>();
+    auto& compactTransformStorage = m_pScene->GetRegistry().storage<CompactTransformComponent>();
+    m_WritingTransforms = true;
+    for (uint32_t i = m_FirstDirtyNode; i < nodeCount; i++)
+    {
+        if (!m_Nodes.dirty[i])
+        {
+            continue;
+        }
+
+        m_Nodes.dirty[i] = 0;
+        if (m_Nodes.parents[i] == sInvalidIndex)
+        {
+            continue;
+        }
+
+        const EntityHandle entity = m_Nodes.entities[i];
+        const glm::mat4& worldTransform = m_Nodes.worldTransforms[i];
+        if (transformStorage.contains(entity))
+        {
+            transformStorage.patch(entity, [&worldTransform](TransformComponent& transformComponent) {
+                transformComponent.transform = worldTransform;
+            });
+        }
+        else if (compactTransformStorage.contains(entity))
+        {
+            compactTransformStorage.patch(entity, [&worldTransform](CompactTransformComponent& transformComponent) {
+                transformComponent.FromMatrix(worldTransform);
+            });
+        }
+    }
+    m_WritingTransforms = false;
+    m_FirstDirtyNode = sInvalidIndex;
+}
+
+void TransformHierarchySystem::MarkDirty(uint32_t nodeIndex)
+{
+    m_Nodes.dirty[nodeIndex] = 1;
+    m_FirstDirtyNode = std::min(m_FirstDirtyNode, nodeIndex);
+}
+
+void TransformHierarchySystem::ReadRootTransform(uint32_t nodeIndex)
+{
+    entt::registry& registry = m_pScene->GetRegistry();
+    const EntityHandle entity = m_Nodes.entities[nodeIndex];
+    if (const TransformComponent* pTransformComponent = registry.try_get<TransformComponent>(entity))
+    {
+        m_Nodes.worldTransforms[nodeIndex] = pTransformComponent->transform;
+    }
+    else if (const CompactTransformComponent* pCompactTransformComponent = registry.try_get<CompactTransformComponent>(entity))
+    {
+        m_Nodes.worldTransforms[nodeIndex] = pCompactTransformComponent->ToMatrix();
+    }
+    else
+    {
+        m_Nodes.worldTransforms[nodeIndex] = glm::mat4(1.0f);
+    }
+}
+
+void TransformHierarchySystem::OnTransformUpdated(entt::registry& registry, entt::entity entity)
+{
+    // A pending rebuild recomputes every node anyway.
+    if (m_WritingTransforms || m_NodesDirty)
+    {
+        return;
+    }
+
+    // Roots' world transforms are read as they change. Children are recomputed, undoing the change.
+    const uint32_t nodeIndex = GetNodeIndex(entity);
+    if (nodeIndex != sInvalidIndex)
+    {
+        if (m_Nodes.parents[nodeIndex] == sInvalidIndex)
+        {
+            ReadRootTransform(nodeIndex);
+        }
+        MarkDirty(nodeIndex);
+    }
+}
+
+void TransformHierarchySystem::OnHierarchyUpdated(entt::registry& registry, entt::entity entity)
+{
+    if (m_NodesDirty)
+    {
+        return;
+    }
+
+    const uint32_t nodeIndex = GetNodeIndex(entity);
+    const HierarchyComponent& hierarchyComponent = registry.get<HierarchyComponent>(entity);
+    const bool parentChanged = nodeIndex == sInvalidIndex || m_Nodes.parents[nodeIndex] == sInvalidIndex || m_Nodes.entities[m_Nodes.parents[nodeIndex]] != hierarchyComponent.parent;
+    if (parentChanged || m_Nodes.attachmentPoints[nodeIndex] != hierarchyComponent.attachmentPoint)
+    {
+        m_NodesDirty = true;
+    }
+    else
+    {
+        m_Nodes.localTransforms[nodeIndex] = hierarchyComponent.localTransform;
+        MarkDirty(nodeIndex);
+    }
+}
+
+void TransformHierarchySystem::OnHierarchyChanged(entt::registry& registry, entt::entity entity)
+{
+    m_NodesDirty = true;
+}
+
+void TransformHierarchySystem::OnTransformDestroyed(entt::registry& registry, entt::entity entity)
+{
+    if (GetNodeIndex(entity) != sInvalidIndex)
+    {
+        m_NodesDirty = true;
+    }
+}
+
+void TransformHierarchySystem::RebuildNodes()
+{
+    entt::registry& registry = m_pScene->GetRegistry();
+    auto& hierarchyStorage = registry.storage<HierarchyComponent>();
+
+    // Depth of each entity in its hierarchy, or sInvalidIndex for entities whose chain of parents is broken.
+    std::unordered_map<EntityHandle, uint32_t> depths;
+    std::vector<EntityHandle> chain;
+    auto getDepth = [&](EntityHandle entity) -> uint32_t {
+        chain.clear();
+        uint32_t depth = sInvalidIndex;
+        while (true)
+        {
+            auto it = depths.find(entity);
+            if (it != depths.end())
+            {
+                depth = it->second;
+                break;
+            }
+            else if (entity == entt::null || !registry.valid(entity) || chain.size() > sMaxHierarchyDepth)
+            {
+                if (chain.size() > sMaxHierarchyDepth)
+                {
+                    Log::Warning() << "TransformHierarchySystem: hierarchy is too deep or contains a cycle.";
+                }
+                break;
+            }
+            else if (!hierarchyStorage.contains(entity))
+            {
+                // Entities without a HierarchyComponent are roots.
+                depths[entity] = 0;
+                depth = 0;
+                break;
+            }
+
+            chain.push_back(entity);
+            entity = hierarchyStorage.get(entity).parent;
+        }
+
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            depth = depth == sInvalidIndex ? sInvalidIndex : depth + 1;
+            depths[*it] = depth;
+        }
+        return depth;
+    };
+
+    for (const EntityHandle entity : registry.view<HierarchyComponent>())
+    {
+        getDepth(entity);
+    }
+
+    struct Entry
+    {
+        uint32_t depth;
+        EntityHandle entity;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(depths.size());
+    for (const auto& [entity, depth] : depths)
+    {
+        if (depth != sInvalidIndex)
+        {
+            entries.push_back({ depth, entity });
+        }
+    }
+
+    // Sorting by entity as well keeps the order deterministic.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.depth != b.depth ? a.depth < b.depth : a.entity < b.entity;
+    });
+
+    const size_t nodeCount = entries.size();
+    m_Nodes.entities.resize(nodeCount);
+    m_Nodes.parents.resize(nodeCount);
+    m_Nodes.localTransforms.resize(nodeCount);
+    m_Nodes.worldTransforms.resize(nodeCount);
+    m_Nodes.attachmentTransforms.assign(nodeCount, glm::mat4(1.0f));
+    // Every node is recomputed after a rebuild.
+    m_Nodes.dirty.assign(nodeCount, 1);
+    m_Nodes.attachmentPending.assign(nodeCount, 0);
+    m_Nodes.attachmentPoints.resize(nodeCount);
+    std::fill(m_NodeIndices.begin(), m_NodeIndices.end(), sInvalidIndex);
+    m_FirstDirtyNode = nodeCount > 0 ? 0 : sInvalidIndex;
+    m_NodesDirty = false;
+    m_AttachmentsPending = false;
+
+    for (uint32_t i = 0; i < nodeCount; i++)
+    {
+        const EntityHandle entity = entries[i].entity;
+        const size_t id = static_cast<size_t>(entt::to_entity(entity));
+        if (id >= m_NodeIndices.size())
+        {
+            m_NodeIndices.resize(id + 1, sInvalidIndex);
+        }
+        m_NodeIndices[id] = i;
+        m_Nodes.entities[i] = entity;
+
+        const HierarchyComponent* pHierarchyComponent = hierarchyStorage.contains(entity) ? &hierarchyStorage.get(entity) : nullptr;
+        m_Nodes.parents[i] = pHierarchyComponent ? GetNodeIndex(pHierarchyComponent->parent) : sInvalidIndex;
+        m_Nodes.localTransforms[i] = pHierarchyComponent ? pHierarchyComponent->localTransform : glm::mat4(1.0f);
+        m_Nodes.attachmentPoints[i] = pHierarchyComponent ? pHierarchyComponent->attachmentPoint : std::string();
+        if (m_Nodes.parents[i] == sInvalidIndex)
+        {
+            ReadRootTransform(i);
+        }
+
+        if (!m_Nodes.attachmentPoints[i].empty() && !ResolveAttachment(i))
+        {
+            m_Nodes.attachmentPending[i] = 1;
+            m_AttachmentsPending = true;
+        }
+    }
+}
+
+uint32_t TransformHierarchySystem::GetNodeIndex(EntityHandle entity) const
+{
+    if (entity == entt::null)
+    {
+        return sInvalidIndex;
+    }
+
+    const size_t id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= m_NodeIndices.size())
+    {
+        return sInvalidIndex;
+    }
+
+    const uint32_t nodeIndex = m_NodeIndices[id];
+    return (nodeIndex != sInvalidIndex && m_Nodes.entities[nodeIndex] == entity) ? nodeIndex : sInvalidIndex;
+}
+
+bool TransformHierarchySystem::ResolveAttachment(uint32_t nodeIndex)
+{
+    // Attachment points come from the parent's model, which may still be loading.
+    const EntityHandle parentEntity = m_Nodes.entities[m_Nodes.parents[nodeIndex]];
+    const ModelComponent* pModelComponent = m_pScene->GetRegistry().try_get<ModelComponent>(parentEntity);
+    if (pModelComponent == nullptr || pModelComponent->GetModel() == nullptr)
+    {
+        return false;
+    }
+
+    m_Nodes.attachmentPending[nodeIndex] = 0;
+    const std::string& name = m_Nodes.attachmentPoints[nodeIndex];
+    auto attachmentPoint = pModelComponent->GetModel()->GetAttachmentPoint(name);
+    if (attachmentPoint.has_value())
+    {
+        m_Nodes.attachmentTransforms[nodeIndex] = attachmentPoint->m_ModelTransform;
+    }
+    else
+    {
+        Log::Warning() << "TransformHierarchySystem: attachment point '" << name << "' not found in " << pModelComponent->GetModel()->GetPath() << ".";
+        m_Nodes.attachmentTransforms[nodeIndex] = glm::mat4(1.0f);
+    }
+    return true;
+}
+
+} // namespace WingsOfSteel
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+
+#include "scene/entity.hpp"
+#include "scene/systems/system.hpp"
+
+namespace WingsOfSteel
+{
+
+// Propagates transforms down the hierarchies built with HierarchyComponents.
+// Every entity in a hierarchy, as well as each hierarchy's root, is stored in arrays sorted by depth, along with its
+// local transform. Changes are picked up from on_update<TransformComponent>(), on_update<CompactTransformComponent>()
+// and on_update<HierarchyComponent>(). Each update then runs a single pass over the arrays from the first changed node,
+// and writes back only the transforms which changed: idle hierarchies cost nothing.
+// Roots and children may use either kind of transform; compact children lose any shear.
+// Every scene has one, which the scene updates after all its other systems so parents have finished moving.
+class TransformHierarchySystem : public System
+{
+public:
+    TransformHierarchySystem() = default;
+    ~TransformHierarchySystem();
+
+    void Initialize(Scene* pScene) override;
+    void Update(float delta) override;
+    bool DeclareAccess(SystemAccess& access) const override;
+
+    void SetLocalTransform(EntityHandle entity, const glm::mat4& localTransform);
+
+private:
+    void OnTransformUpdated(entt::registry& registry, entt::entity entity);
+    void OnHierarchyUpdated(entt::registry& registry, entt::entity entity);
+    void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
+    void OnTransformDestroyed(entt::registry& registry, entt::entity entity);
+
+    void RebuildNodes();
+    void MarkDirty(uint32_t nodeIndex);
+    void ReadRootTransform(uint32_t nodeIndex);
+    uint32_t GetNodeIndex(EntityHandle entity) const;
+    bool ResolveAttachment(uint32_t nodeIndex);
+
+    static constexpr uint32_t sInvalidIndex = ~0u;
+
+    Scene* m_pScene{ nullptr };
+
+    // Nodes in depth order, so parents always come before their children. Roots have sInvalidIndex as their parent,
+    // and their world transform is read from their transform whenever it changes.
+    struct Nodes
+    {
+        std::vector<EntityHandle> entities;
+        std::vector<uint32_t> parents;
+        std::vector<glm::mat4> localTransforms; // Copied from the HierarchyComponents whenever they change.
+        std::vector<glm::mat4> worldTransforms;
+        std::vector<glm::mat4> attachmentTransforms;
+        std::vector<uint8_t> dirty;
+        std::vector<uint8_t> attachmentPending;
+        std::vector<std::string> attachmentPoints;
+    };
+    Nodes m_Nodes;
+    std::vector<uint32_t> m_NodeIndices; // Indexed by entity id, without its version.
+    uint32_t m_FirstDirtyNode{ sInvalidIndex }; // Lowest dirty node, or sInvalidIndex if there are none.
+    bool m_NodesDirty{ true };
+    bool m_AttachmentsPending{ false };
+    bool m_WritingTransforms{ false };
+};
+
+} // namespace WingsOfSteel
@@ -18,11 +18,21 @@ namespace WingsOfSteel::Private
 VFSNative::VFSNative()
 {
     BuildVFS();
-    Log::Info() << "Native VFS initialized.";
+    Log::Info(Log::Category::VFS) << "Native VFS initialized.";
 }
 
 VFSNative::~VFSNative()
 {
+    // Any queued writes are finished before the thread exits, but their callbacks are no longer called.
+    if (m_WriteThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_WriteMutex);
+            m_StopWriteThread = true;
+        }
+        m_WriteCondition.notify_one();
+        m_WriteThread.join();
+    }
 }
 
 void VFSNative::Initialize()
@@ -31,6 +41,28 @@ void VFSNative::Initialize()
 
 void VFSNative::Update()
 {
+    std::vector<AsyncWrite> completedWrites;
+    {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        completedWrites.swap(m_CompletedWrites);
+    }
+
+    for (AsyncWrite& completedWrite : completedWrites)
+    {
+        if (completedWrite.succeeded)
+        {
+            m_VFS[completedWrite.path] = completedWrite.nativePath;
+        }
+        else
+        {
+            Log::Warning(Log::Category::VFS) << "Failed to write '" << completedWrite.path << "' to '" << completedWrite.nativePath << "'.";
+        }
+
+        if (completedWrite.onFileWriteCompleted)
+        {
+            completedWrite.onFileWriteCompleted(completedWrite.succeeded);
+        }
+    }
 }
 
 void VFSNative::FileRead(const std::string& path, FileReadCallback onFileReadCompleted)
@@ -70,10 +102,10 @@ bool VFSNative::FileWrite(const std::string& path, const std::vector<uint8_t>& b
     auto it = m_VFS.find(path);
     if (it == m_VFS.end())
     {
-        const std::filesystem::path nativePath = "data/core/" + path;
+        const std::filesystem::path nativePath = GetNativePath(path);
         ofs.open(nativePath, std::ios::out | std::ios::binary);
         m_VFS[path] = nativePath;
-        Log::Info() << "Created new file '" << path << "' at '" << nativePath << "'.";
+        Log::Verbose(Log::Category::VFS) << "Created new file '" << path << "' at '" << nativePath << "'.";
     }
     else
     {
@@ -92,6 +124,87 @@ bool VFSNative::FileWrite(const std::string& path, const std::vector<uint8_t>& b
     }
 }
 
+void VFSNative::FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted)
+{
+    AsyncWrite write;
+    write.path = path;
+    write.nativePath = GetNativePath(path);
+    write.bytes = std::move(bytes);
+    write.onFileWriteCompleted = onFileWriteCompleted;
+
+    {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        m_PendingWrites.push_back(std::move(write));
+    }
+
+    if (!m_WriteThread.joinable())
+    {
+        m_WriteThread = std::thread(&VFSNative::WriteThreadMain, this);
+    }
+    m_WriteCondition.notify_one();
+}
+
+std::filesystem::path VFSNative::GetNativePath(const std::string& path) const
+{
+    auto it = m_VFS.find(path);
+    if (it == m_VFS.end())
+    {
+        return "data/core/" + path;
+    }
+    else
+    {
+        return it->second;
+    }
+}
+
+void VFSNative::WriteThreadMain()
+{
+    while (true)
+    {
+        AsyncWrite write;
+        {
+            std::unique_lock<std::mutex> lock(m_WriteMutex);
+            m_WriteCondition.wait(lock, [this]() { return m_StopWriteThread || !m_PendingWrites.empty(); });
+            if (m_PendingWrites.empty())
+            {
+                return;
+            }
+
+            write = std::move(m_PendingWrites.front());
+            m_PendingWrites.pop_front();
+        }
+
+        // Written to a temporary file first, so a crash mid-write never leaves a truncated file behind.
+        std::filesystem::path temporaryPath = write.nativePath;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream ofs(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (ofs.is_open())
+            {
+                ofs.write(reinterpret_cast<const char*>(write.bytes.data()), write.bytes.size());
+                write.succeeded = ofs.good();
+            }
+        }
+
+        std::error_code error;
+        if (write.succeeded)
+        {
+            fs::rename(temporaryPath, write.nativePath, error);
+            write.succeeded = !error;
+        }
+        else
+        {
+            fs::remove(temporaryPath, error);
+        }
+
+        write.bytes.clear();
+        write.bytes.shrink_to_fit();
+
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        m_CompletedWrites.push_back(std::move(write));
+    }
+}
+
 bool VFSNative::Exists(const std::string& path) const
 {
     return m_VFS.find(path) != m_VFS.end();
@@ -116,7 +229,7 @@ void VFSNative::BuildVFS()
     }
     else
     {
-        Log::Error() << "Failed to build VFS from '" << directory << "'. Incorrect working directory (" << std::filesystem::current_path() << ")?";
+        Log::Error(Log::Category::VFS) << "Failed to build VFS from '" << directory << "'. Incorrect working directory (" << std::filesystem::current_path() << ")?";
     }
 }
 
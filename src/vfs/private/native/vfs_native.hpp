@@ -2,8 +2,12 @@
 
 #if defined(TARGET_PLATFORM_NATIVE)
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "vfs/private/vfs_impl.hpp"
@@ -21,13 +25,33 @@ public:
     void Update() override;
     void FileRead(const std::string& path, FileReadCallback onFileReadCompleted) override;
     bool FileWrite(const std::string& path, const std::vector<uint8_t>& bytes) override;
+    void FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted) override;
     bool Exists(const std::string& path) const override;
     const std::vector<std::string> List(const std::string& path) const override;
 
 private:
     void BuildVFS();
+    std::filesystem::path GetNativePath(const std::string& path) const;
+    void WriteThreadMain();
 
     std::unordered_map<std::string, std::filesystem::path> m_VFS;
+
+    // Asynchronous writes are queued for a single writer thread, which is only started by the first write.
+    // The VFS map is only touched on the main thread, when the completed writes are processed in Update().
+    struct AsyncWrite
+    {
+        std::string path;
+        std::filesystem::path nativePath;
+        std::vector<uint8_t> bytes;
+        FileWriteCallback onFileWriteCompleted;
+        bool succeeded{ false };
+    };
+    std::thread m_WriteThread;
+    std::mutex m_WriteMutex;
+    std::condition_variable m_WriteCondition;
+    std::deque<AsyncWrite> m_PendingWrites;
+    std::vector<AsyncWrite> m_CompletedWrites;
+    bool m_StopWriteThread{ false };
 };
 
 } // namespace WingsOfSteel::Private
@@ -15,6 +15,7 @@ public:
     virtual void Update() = 0;
     virtual void FileRead(const std::string& path, FileReadCallback onFileReadCompleted) = 0;
     virtual bool FileWrite(const std::string& path, const std::vector<uint8_t>& bytes) = 0;
+    virtual void FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted) = 0;
     virtual bool Exists(const std::string& path) const = 0;
     virtual const std::vector<std::string> List(const std::string& path) const = 0;
 };
@@ -28,11 +28,11 @@ bool Manifest::Initialize()
     std::ifstream manifestFile("manifest.json");
     if (!manifestFile.is_open())
     {
-        Log::Error() << "Failed to open embedded manifest file.";
+        Log::Error(Log::Category::VFS) << "Failed to open embedded manifest file.";
         return false;
     }
 
-    Log::Info() << "Manifest file is present.";
+    Log::Info(Log::Category::VFS) << "Manifest file is present.";
 
     const json jsonContents = json::parse(manifestFile);
     for (const auto& element : jsonContents)
@@ -50,7 +50,7 @@ bool Manifest::Initialize()
             }
             else
             {
-                Log::Error() << "Manifest serialization: failed to load an element's path.";
+                Log::Error(Log::Category::VFS) << "Manifest serialization: failed to load an element's path.";
                 return false;
             }
 
@@ -61,7 +61,7 @@ bool Manifest::Initialize()
             }
             else
             {
-                Log::Error() << "Manifest serialization: failed to load hash for file '" << path.value_or("UNKNOWN") << "'.";
+                Log::Error(Log::Category::VFS) << "Manifest serialization: failed to load hash for file '" << path.value_or("UNKNOWN") << "'.";
                 return false;
             }
 
@@ -70,7 +70,7 @@ bool Manifest::Initialize()
             {
                 if (sizeIt->get<int64_t>() < 0)
                 {
-                    Log::Error() << "Manifest serialization: negative size for file '" << path.value_or("UNKNOWN") << "'.";
+                    Log::Error(Log::Category::VFS) << "Manifest serialization: negative size for file '" << path.value_or("UNKNOWN") << "'.";
                     return false;
                 }
                 else
@@ -80,7 +80,7 @@ bool Manifest::Initialize()
             }
             else
             {
-                Log::Error() << "Manifest serialization: failed to load size for file '" << path.value_or("UNKNOWN") << "'.";
+                Log::Error(Log::Category::VFS) << "Manifest serialization: failed to load size for file '" << path.value_or("UNKNOWN") << "'.";
                 return false;
             }
 
@@ -90,13 +90,13 @@ bool Manifest::Initialize()
             }
             else
             {
-                Log::Error() << "Manifest serialization failed for file '" << path.value_or("UNKNOWN") << "'.";
+                Log::Error(Log::Category::VFS) << "Manifest serialization failed for file '" << path.value_or("UNKNOWN") << "'.";
                 return false;
             }
         }
     }
 
-    Log::Info() << "Manifest file loaded with " << m_ManifestData.size() << " entries.";
+    Log::Info(Log::Category::VFS) << "Manifest file loaded with " << m_ManifestData.size() << " entries.";
     return true;
 }
 
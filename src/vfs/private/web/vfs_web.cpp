@@ -20,7 +20,7 @@ namespace WingsOfSteel::Private
 
 VFSWeb::VFSWeb()
 {
-    Log::Info() << "Creating VFS web backend...";
+    Log::Info(Log::Category::VFS) << "Creating VFS web backend...";
 }
 
 VFSWeb::~VFSWeb()
@@ -29,7 +29,7 @@ VFSWeb::~VFSWeb()
 
 void VFSWeb::Initialize()
 {
-    Log::Info() << "Initializing VFS web backend.";
+    Log::Info(Log::Category::VFS) << "Initializing VFS web backend.";
     m_pManifest = std::make_unique<Manifest>();
     m_pManifest->Initialize();
 }
@@ -44,7 +44,7 @@ void VFSWeb::Update()
 
         std::stringstream url;
         url << VFS_WEB_HOST << m_InProgress->pManifestEntry->GetHash();
-        Log::Info() << "Downloading '" << m_InProgress->path << "' from '" << url.str() << "'...";
+        Log::Verbose(Log::Category::VFS) << "Downloading '" << m_InProgress->path << "' from '" << url.str() << "'...";
 
         emscripten_fetch_attr_t attr;
         emscripten_fetch_attr_init(&attr);
@@ -64,12 +64,12 @@ void VFSWeb::Update()
                 fileData.resize(pFetch->numBytes);
                 std::memcpy(fileData.data(), pFetch->data, pFetch->numBytes * sizeof(char));
 
-                Log::Info() << "Downloaded '" << path << "'.";
+                Log::Verbose(Log::Category::VFS) << "Downloaded '" << path << "'.";
                 pVFS->m_InProgress->onFileReadCompleted(FileReadResult::Ok, std::make_shared<File>(path, std::move(fileData)));
             }
             else
             {
-                Log::Error() << "Download '" << path << "' failed due to mismatched hashes. Expected " << manifestHash << ", got " << downloadHash.str() << ".";
+                Log::Error(Log::Category::VFS) << "Download '" << path << "' failed due to mismatched hashes. Expected " << manifestHash << ", got " << downloadHash.str() << ".";
                 pVFS->m_InProgress->onFileReadCompleted(FileReadResult::ErrorHashMismatch, nullptr);
             }
 
@@ -79,7 +79,7 @@ void VFSWeb::Update()
         attr.onerror = [](emscripten_fetch_t* pFetch) {
             VFSWeb* pVFS = reinterpret_cast<VFSWeb*>(pFetch->userData);
             assert(pVFS->m_InProgress.has_value());
-            Log::Error() << "Failed to download " << pVFS->m_InProgress->path;
+            Log::Error(Log::Category::VFS) << "Failed to download " << pVFS->m_InProgress->path;
             pVFS->m_InProgress->onFileReadCompleted(FileReadResult::ErrorGeneric, nullptr);
             pVFS->m_InProgress.reset();
             emscripten_fetch_close(pFetch);
@@ -106,10 +106,19 @@ void VFSWeb::FileRead(const std::string& path, FileReadCallback onFileReadComple
 
 bool VFSWeb::FileWrite(const std::string& path, const std::vector<uint8_t>& bytes)
 {
-    Log::Error() << "VFSWeb::FileWrite: Unsupported operation.";
+    Log::Error(Log::Category::VFS) << "VFSWeb::FileWrite: Unsupported operation.";
     return false;
 }
 
+void VFSWeb::FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted)
+{
+    Log::Warning(Log::Category::VFS) << "VFSWeb::FileWriteAsync: Unsupported operation.";
+    if (onFileWriteCompleted)
+    {
+        onFileWriteCompleted(false);
+    }
+}
+
 bool VFSWeb::Exists(const std::string& path) const
 {
     return m_pManifest->ContainsEntry(path);
@@ -24,6 +24,7 @@ public:
     void Update() override;
     void FileRead(const std::string& path, FileReadCallback onFileReadCompleted) override;
     bool FileWrite(const std::string& path, const std::vector<uint8_t>& bytes) override;
+    void FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted) override;
     bool Exists(const std::string& path) const override;
     const std::vector<std::string> List(const std::string& path) const override;
 
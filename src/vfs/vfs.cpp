@@ -43,6 +43,11 @@ bool VFS::FileWrite(const std::string& path, const std::vector<uint8_t>& bytes)
     return m_pImpl->FileWrite(path, bytes);
 }
 
+void VFS::FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted)
+{
+    m_pImpl->FileWriteAsync(path, std::move(bytes), onFileWriteCompleted);
+}
+
 bool VFS::Exists(const std::string& path) const
 {
     return m_pImpl->Exists(path);
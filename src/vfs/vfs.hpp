@@ -24,6 +24,7 @@ enum class FileReadResult
 };
 
 using FileReadCallback = std::function<void(FileReadResult, FileSharedPtr)>;
+using FileWriteCallback = std::function<void(bool)>;
 
 // The VFS provides a layer of abstraction over the underlying file system, as well as
 // providing the foundation for mod support.
@@ -46,6 +47,10 @@ public:
     void Update();
     void FileRead(const std::string& path, FileReadCallback onFileReadCompleted);
     bool FileWrite(const std::string& path, const std::vector<uint8_t>& bytes);
+    // Writes the file on a background thread, so large writes such as saves don't stall the frame. The file is
+    // replaced atomically once fully written. The callback is called from Update(), on the main thread.
+    // Not supported on web, where the callback is called with false.
+    void FileWriteAsync(const std::string& path, std::vector<uint8_t>&& bytes, FileWriteCallback onFileWriteCompleted = nullptr);
     bool Exists(const std::string& path) const;
     const std::vector<std::string> List(const std::string& path = "/") const;
 
@@ -0,0 +1,60 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/log.hpp"
+#include "test.hpp"
+
+namespace WingsOfSteel::Tests
+{
+
+static std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void BinaryLogRoundTripTest(Test& test)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "pandora_tests_binary_log.bin";
+    TEST_CHECK(test, Log::StartBinaryLog(path));
+
+    // The same literal is logged twice, so both its definition and a reference to it are decoded.
+    for (int i = 0; i < 2; i++)
+    {
+        Log::Info() << "Round trip " << i << ", " << 1.5 << ", " << std::string("string") << ", " << 'c';
+    }
+    Log::Info() << "Last message";
+    Log::StopBinaryLog();
+
+    const std::vector<uint8_t> data = ReadFile(path);
+    std::filesystem::remove(path);
+
+    std::ostringstream output;
+    TEST_CHECK(test, Log::DecodeBinaryLog(data, output));
+    const std::string text = output.str();
+    TEST_CHECK(test, text.find("[INFO] Round trip 0, 1.5, string, c\n") != std::string::npos);
+    TEST_CHECK(test, text.find("[INFO] Round trip 1, 1.5, string, c\n") != std::string::npos);
+    TEST_CHECK(test, text.find("[INFO] Last message\n") != std::string::npos);
+
+    // A log cut short is decoded up to its last complete record.
+    std::ostringstream truncatedOutput;
+    TEST_CHECK(test, data.size() > 4);
+    TEST_CHECK(test, Log::DecodeBinaryLog(std::span<const uint8_t>(data.data(), data.size() - 4), truncatedOutput));
+    const std::string truncatedText = truncatedOutput.str();
+    TEST_CHECK(test, truncatedText.find("Round trip 1, 1.5, string, c\n") != std::string::npos);
+    TEST_CHECK(test, truncatedText.find("Last message") == std::string::npos);
+
+    // Anything else isn't a binary log.
+    std::ostringstream invalidOutput;
+    const std::string notALog("Not a binary log");
+    TEST_CHECK(test, !Log::DecodeBinaryLog(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(notALog.data()), notALog.size()), invalidOutput));
+    TEST_CHECK(test, invalidOutput.str().empty());
+}
+
+REGISTER_TEST("binary_log_round_trip", BinaryLogRoundTripTest)
+
+} // namespace WingsOfSteel::Tests
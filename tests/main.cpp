@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <clipp.h>
+
+#include "core/log.hpp"
+#include "pandora.hpp"
+#include "synthetic_data.hpp"
+#include "test.hpp"
+
+using namespace WingsOfSteel;
+using namespace WingsOfSteel::Tests;
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> names;
+    bool list = false;
+    bool help = false;
+
+    auto cli = (
+        clipp::repeatable(clipp::option("-t", "--test") & clipp::value("name", names)) % "Test to run; every test runs if none is given.",
+        clipp::option("-l", "--list").set(list) % "Lists the tests.",
+        clipp::option("-h", "--help").set(help) % "Shows this help.");
+
+    if (!clipp::parse(argc, argv, cli) || help)
+    {
+        std::cout << clipp::make_man_page(cli, "pandora_tests");
+        return help ? 0 : 1;
+    }
+
+    std::vector<TestRegistry::Entry> tests = TestRegistry::GetTests();
+    std::sort(tests.begin(), tests.end(), [](const TestRegistry::Entry& a, const TestRegistry::Entry& b) {
+        return a.name < b.name;
+    });
+
+    if (list)
+    {
+        for (const TestRegistry::Entry& test : tests)
+        {
+            std::cout << test.name << "\n";
+        }
+        return 0;
+    }
+
+    for (const std::string& name : names)
+    {
+        if (std::none_of(tests.begin(), tests.end(), [&name](const TestRegistry::Entry& test) { return test.name == name; }))
+        {
+            std::cerr << "Unknown test '" << name << "', see --list.\n";
+            return 1;
+        }
+    }
+
+    // Tests generate their data the same way the benchmarks do, and run on a headless engine without a GPU.
+    std::vector<std::string> failedTests;
+    Bench::SyntheticVFS::Prepare();
+
+    HeadlessSettings headlessSettings;
+    headlessSettings.SetAdapter(RenderAdapter::Null);
+    InitializeHeadless(
+        headlessSettings,
+        [&tests, &names, &failedTests]() {
+            for (const TestRegistry::Entry& entry : tests)
+            {
+                if (names.empty() || std::find(names.begin(), names.end(), entry.name) != names.end())
+                {
+                    Log::Info() << "Running " << entry.name << "...";
+                    Test test(entry.name);
+                    entry.function(test);
+                    if (test.HasFailed())
+                    {
+                        failedTests.push_back(entry.name);
+                    }
+                }
+            }
+        },
+        [](float delta) {},
+        []() {});
+
+    Bench::SyntheticVFS::Cleanup();
+
+    for (const std::string& name : failedTests)
+    {
+        std::cerr << "FAILED: " << name << "\n";
+    }
+    return failedTests.empty() ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "physics/physics_snapshot.hpp"
+#include "resources/resource_data_store.hpp"
+#include "scene/components/rigid_body_component.hpp"
+#include "scene/prefab.hpp"
+#include "scene/scene.hpp"
+#include "scene/systems/physics_simulation_system.hpp"
+#include "synthetic_data.hpp"
+#include "test.hpp"
+
+namespace WingsOfSteel::Tests
+{
+
+static constexpr uint32_t sTickRate = 60;
+static constexpr size_t sBodyCount = 200;
+static constexpr int sTicksBeforeCapture = 30;
+static constexpr int sTicksAfterCapture = 60;
+
+// Spheres are stacked in columns over a static ground, so the ticks after the capture are full of new and existing contacts.
+static SceneSharedPtr CreatePhysicsScene(std::vector<EntityHandle>& bodies)
+{
+    ResourceDataStoreSharedPtr pDataStore = Bench::SyntheticVFS::LoadDataStore(Bench::SyntheticVFS::Path("physics_tests.json"), {
+        { "body", {
+            { "transform", Bench::SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", Bench::SyntheticData::DynamicSphere(1.0f) } } },
+        { "ground", {
+            { "transform", Bench::SyntheticData::Transform(glm::mat4(1.0f)) },
+            { "rigid_body", Bench::SyntheticData::StaticBox(glm::vec3(100.0f, 1.0f, 100.0f)) } } } });
+
+    SceneSharedPtr pScene = std::make_shared<Scene>();
+    pScene->Initialize();
+
+    PhysicsSimulationSystem* pPhysicsSimulationSystem = pScene->AddSystem<PhysicsSimulationSystem>(PhysicsSimulationSystem::Mode::SingleThreaded);
+    pPhysicsSimulationSystem->SetTickRate(sTickRate);
+    pPhysicsSimulationSystem->SetMaxTicksPerUpdate(1);
+
+    Prefab(pDataStore, pDataStore->Data()["ground"]).Spawn(pScene.get());
+
+    bodies = Prefab(pDataStore, pDataStore->Data()["body"]).SpawnN(pScene.get(), sBodyCount);
+    entt::registry& registry = pScene->GetRegistry();
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        // Every other column is offset by half a sphere, so the stacks topple into each other.
+        const glm::vec3 position(
+            static_cast<float>(i % 5) * 2.5f + static_cast<float>((i / 25) % 2),
+            2.0f + static_cast<float>(i / 25) * 2.5f,
+            static_cast<float>((i / 5) % 5) * 2.5f);
+        RigidBodyComponent& rigidBodyComponent = registry.get<RigidBodyComponent>(bodies[i]);
+        rigidBodyComponent.SetWorldTransform(glm::translate(glm::mat4(1.0f), position));
+        rigidBodyComponent.SetLinearVelocity(glm::vec3(0.0f, -10.0f, 0.0f));
+    }
+
+    return pScene;
+}
+
+// Runs the ticks following the capture, and returns the world transform of every body after each of them.
+static std::vector<glm::mat4> Simulate(Scene* pScene, const std::vector<EntityHandle>& bodies)
+{
+    std::vector<glm::mat4> transforms;
+    transforms.reserve(bodies.size() * sTicksAfterCapture);
+    entt::registry& registry = pScene->GetRegistry();
+    for (int i = 0; i < sTicksAfterCapture; i++)
+    {
+        // Every update is a bit longer than a tick, and the ticks are capped to one per update.
+        pScene->Update(1.5f / sTickRate);
+        for (EntityHandle body : bodies)
+        {
+            transforms.push_back(registry.get<RigidBodyComponent>(body).GetWorldTransform());
+        }
+    }
+    return transforms;
+}
+
+static void PhysicsSnapshotRestoreTest(Test& test)
+{
+    std::vector<EntityHandle> bodies;
+    SceneSharedPtr pScene = CreatePhysicsScene(bodies);
+    PhysicsSimulationSystem* pPhysicsSimulationSystem = pScene->GetSystem<PhysicsSimulationSystem>();
+    for (int i = 0; i < sTicksBeforeCapture; i++)
+    {
+        pScene->Update(1.5f / sTickRate);
+    }
+
+    // The snapshot is restored from its binary data, so the serialization is covered as well.
+    PhysicsSnapshot snapshot;
+    pPhysicsSimulationSystem->CaptureSnapshot(snapshot);
+    std::vector<uint8_t> data(snapshot.GetDataSize());
+    snapshot.WriteData(data);
+
+    const std::vector<glm::mat4> originalTransforms = Simulate(pScene.get(), bodies);
+
+    PhysicsSnapshot restoredSnapshot;
+    TEST_CHECK(test, restoredSnapshot.ReadData(data));
+    TEST_CHECK(test, restoredSnapshot.GetBodies().size() == sBodyCount);
+    TEST_CHECK(test, restoredSnapshot.GetSolverSeed() == snapshot.GetSolverSeed());
+    pPhysicsSimulationSystem->RestoreSnapshot(restoredSnapshot);
+
+    const std::vector<glm::mat4> resimulatedTransforms = Simulate(pScene.get(), bodies);
+
+    // Re-simulating must be bit-identical, not merely close.
+    TEST_CHECK(test, originalTransforms.size() == resimulatedTransforms.size());
+    TEST_CHECK(test, memcmp(originalTransforms.data(), resimulatedTransforms.data(), originalTransforms.size() * sizeof(glm::mat4)) == 0);
+
+    // Guards against a scene which came to rest before the capture, which would make the comparison meaningless.
+    const size_t bytesPerTick = bodies.size() * sizeof(glm::mat4);
+    TEST_CHECK(test, memcmp(originalTransforms.data(), originalTransforms.data() + originalTransforms.size() - bodies.size(), bytesPerTick) != 0);
+}
+
+REGISTER_TEST("physics_snapshot_restore", PhysicsSnapshotRestoreTest)
+
+} // namespace WingsOfSteel::Tests
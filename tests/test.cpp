@@ -0,0 +1,39 @@
+#include "test.hpp"
+
+#include "core/log.hpp"
+
+namespace WingsOfSteel::Tests
+{
+
+Test::Test(const std::string& name)
+    : m_Name(name)
+{
+}
+
+void Test::Check(bool condition, const char* pExpression, const char* pFile, int line)
+{
+    if (!condition)
+    {
+        m_Failures++;
+        Log::Warning() << m_Name << ": check failed at " << pFile << ":" << line << ": " << pExpression;
+    }
+}
+
+bool TestRegistry::Register(const std::string& name, TestFunction function)
+{
+    if (sTests == nullptr)
+    {
+        sTests = new std::vector<Entry>();
+    }
+
+    sTests->push_back(Entry{ .name = name, .function = function });
+    return true;
+}
+
+const std::vector<TestRegistry::Entry>& TestRegistry::GetTests()
+{
+    static const std::vector<Entry> sEmpty;
+    return sTests ? *sTests : sEmpty;
+}
+
+} // namespace WingsOfSteel::Tests
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace WingsOfSteel::Tests
+{
+
+//////////////////////////////////////////////////////////////////////////
+// Test
+// Handed to each test, which checks its expectations through it. A
+// failed check is reported with its location and the test keeps going,
+// so a single run shows every check which failed.
+//////////////////////////////////////////////////////////////////////////
+
+class Test
+{
+public:
+    Test(const std::string& name);
+
+    void Check(bool condition, const char* pExpression, const char* pFile, int line);
+    bool HasFailed() const { return m_Failures > 0; }
+
+private:
+    std::string m_Name;
+    uint32_t m_Failures{ 0 };
+};
+
+using TestFunction = void (*)(Test& test);
+
+class TestRegistry
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        TestFunction function;
+    };
+
+    static bool Register(const std::string& name, TestFunction function);
+    static const std::vector<Entry>& GetTests();
+
+private:
+    inline static std::vector<Entry>* sTests = nullptr;
+};
+
+#define REGISTER_TEST(NAME, FUNCTION) static const bool s##FUNCTION##Registered = WingsOfSteel::Tests::TestRegistry::Register(NAME, FUNCTION);
+#define TEST_CHECK(TEST, CONDITION) (TEST).Check((CONDITION), #CONDITION, __FILE__, __LINE__)
+
+} // namespace WingsOfSteel::Tests
@@ -0,0 +1,64 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <clipp.h>
+
+#include "core/log.hpp"
+
+using namespace WingsOfSteel;
+
+// Turns a binary log written by Log::StartBinaryLog() back into text.
+int main(int argc, char** argv)
+{
+    std::string inputPath;
+    std::string outputPath("-");
+    bool help = false;
+
+    auto cli = (
+        clipp::value("binary log", inputPath) % "Binary log to decode.",
+        (clipp::option("-o", "--output") & clipp::value("file", outputPath)) % "File to write the text to, or - for stdout.",
+        clipp::option("-h", "--help").set(help) % "Shows this help.");
+
+    if (!clipp::parse(argc, argv, cli) || help)
+    {
+        std::cout << clipp::make_man_page(cli, "pandora_logdecode");
+        return help ? 0 : 1;
+    }
+
+    std::ifstream input(inputPath, std::ios::in | std::ios::binary);
+    if (!input.is_open())
+    {
+        std::cerr << "Failed to open '" << inputPath << "'.\n";
+        return 1;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::ofstream outputFile;
+    if (outputPath != "-")
+    {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open())
+        {
+            std::cerr << "Failed to open '" << outputPath << "'.\n";
+            return 1;
+        }
+    }
+    std::ostream& output = outputFile.is_open() ? outputFile : std::cout;
+
+    if (!Log::DecodeBinaryLog(data, output))
+    {
+        std::cerr << "'" << inputPath << "' isn't a binary log.\n";
+        return 1;
+    }
+
+    output.flush();
+    if (!output.good())
+    {
+        std::cerr << "Failed to write the decoded log.\n";
+        return 1;
+    }
+    return 0;
+}